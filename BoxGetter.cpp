@@ -6,16 +6,38 @@ BoxGetter::BoxGetter(gridMove& mover, Lift& lift)
 : mover_(mover), lift_(lift) {}
 
 void BoxGetter::startGetBox() {
+    startGetBox(mover_.getDirection());
+}
+
+void BoxGetter::startGetBox(gridMove::Direction facing) {
+    facing_ = facing;
     state_ = State::Orient;
     plannedTurnQueued_ = false;
     forwardIssued_ = false;
     backwardIssued_ = false;
+    liftIssued_ = false;
+    drivePhase_ = P_NONE;
+    liftPhase_ = P_NONE;
+    startMs_ = millis();
+    for (uint8_t i = 0; i < P_COUNT; ++i) {
+        phaseStart_[i] = startMs_;
+        phaseMs_[i] = 0;
+    }
 }
 
+// mover_/lift_ 의 update() 는 스케줄러가 각자의 작업으로 이 작업보다 먼저 실행한다.
 void BoxGetter::update() {
-    // 모든 상태에서 mover_와 lift_는 계속 업데이트 되어야 합니다.
-    mover_.update();
-    lift_.update();
+    // 구동부/리프트가 멈췄으면 그쪽에서 실행하던 단계를 끝낸다 (겹친 단계는 서로 다른 때 끝난다)
+    const uint32_t now = millis();
+    if (drivePhase_ != P_NONE && mover_.isIdle()) endPhase_(drivePhase_, now);
+    if (liftPhase_ != P_NONE && lift_.getState() == Lift::LiftState::IDLE) endPhase_(liftPhase_, now);
+    // 미리 올림(나머지 올림을 내리기 전의 올림)은 선반 밑 통과 높이에 닿으면 멈춘다
+    const bool preRaising = liftPhase_ == P_RAISE && !liftIssued_ &&
+                            (state_ == State::Orient || state_ == State::Forward || state_ == State::Raise);
+    if (preRaising && liftAtLeast_(config_.shelfClearMm)) {
+        lift_.stop();
+        endPhase_(P_RAISE, now);
+    }
 
     switch (state_) {
     case State::Idle:
@@ -28,53 +50,62 @@ void BoxGetter::update() {
     case State::Forward:
         if (!forwardIssued_) {
             mover_.startForward();
+            beginPhase_(P_FORWARD, now);
             forwardIssued_ = true;
         }
-        if (mover_.isIdle()) {
+        if (drivePhase_ == P_NONE) {
             state_ = State::Raise;
         }
         break;
 
     case State::Raise:
-        // ======================================================================
-        // ▼▼▼▼▼ [BUG FIX] 비블로킹 Lift 클래스 사용하도록 로직 변경 ▼▼▼▼▼
-        // ======================================================================
-        if (lift_.getState() == Lift::LiftState::IDLE) {
-            // 아직 올리기 시작 안했으면 시작
-            lift_.upFor(2000); // 2초간 올리기 시작
+        // 미리 올림이 끝나야 나머지를 이어서 올린다 (높이로 일찍 멈췄으면 실제로 올린 시간만 뺀다)
+        if (!liftIssued_ && liftPhase_ == P_NONE) {
+            const uint32_t pre = phaseMs_[P_RAISE] < config_.liftMs ? phaseMs_[P_RAISE] : config_.liftMs;
+            lift_.upFor(config_.liftMs - pre);
+            beginPhase_(P_RAISE, now);
+            liftIssued_ = true;
         }
-        
-        // 올리는 동작이 끝났으면 (IDLE 상태로 돌아왔으면) 다음으로
-        if (lift_.getState() == Lift::LiftState::IDLE && forwardIssued_) {
-             state_ = State::Backward;
+
+        // 올림이 끝났거나, 잰 높이로 상자가 바닥에서 떨어졌으면 후진
+        if (liftIssued_ && (liftPhase_ == P_NONE ||
+                            (config_.pipelined && liftAtLeast_(config_.carryMm)))) {
+            state_ = State::Backward;
+            liftIssued_ = false;
         }
-        // forwardIssued_를 플래그로 재활용하여 Raise 시작을 한 번만 하도록 함
-        if(lift_.getState() == Lift::LiftState::MOVING_UP) forwardIssued_ = true;
         break;
 
     case State::Backward:
         if (!backwardIssued_) {
             mover_.startBackward();
+            beginPhase_(P_BACKWARD, now);
             backwardIssued_ = true;
         }
-        if (mover_.isIdle()) {
+        // 선반을 벗어났고 올림이 끝났으면 후진 중이라도 내리기 시작
+        if (liftPhase_ == P_NONE &&
+            (drivePhase_ == P_NONE ||
+             (config_.pipelined &&
+              mover_.actionProgressPct() >= config_.clearPct))) {
             state_ = State::Lower;
         }
         break;
 
     case State::Lower:
-        // ======================================================================
-        // ▼▼▼▼▼ [BUG FIX] 비블로킹 Lift 클래스 사용하도록 로직 변경 ▼▼▼▼▼
-        // ======================================================================
-        if (lift_.getState() == Lift::LiftState::IDLE) {
-            lift_.downFor(2000); // 2초간 내리기 시작
+        if (!liftIssued_) {
+            lift_.downFor(config_.liftMs);
+            beginPhase_(P_LOWER, now);
+            liftIssued_ = true;
         }
 
-        // 내리는 동작이 끝났으면 (IDLE 상태로 돌아왔으면) 종료
-        if (lift_.getState() == Lift::LiftState::IDLE && backwardIssued_) {
+        // 내림과 후진이 모두 끝났으면 종료
+        if (liftPhase_ == P_NONE && drivePhase_ == P_NONE) {
             state_ = State::Done;
+            liftIssued_ = false;
+            timings_ = Timings{
+                phaseMs_[P_ORIENT], phaseMs_[P_FORWARD], phaseMs_[P_RAISE],
+                phaseMs_[P_BACKWARD], phaseMs_[P_LOWER], now - startMs_
+            };
         }
-        if(lift_.getState() == Lift::LiftState::MOVING_DOWN) backwardIssued_ = true;
         break;
 
     case State::Done:
@@ -85,30 +116,74 @@ void BoxGetter::update() {
 bool BoxGetter::isBusy() const { return state_ != State::Idle && state_ != State::Done; }
 bool BoxGetter::isFinished() const { return state_ == State::Done; }
 BoxGetter::State BoxGetter::state() const { return state_; }
+gridMove::Direction BoxGetter::facing() const { return facing_; }
+
+void BoxGetter::setConfig(const Config& config) { config_ = config; }
+const BoxGetter::Config& BoxGetter::config() const { return config_; }
+const BoxGetter::Timings& BoxGetter::lastTimings() const { return timings_; }
+
+uint32_t BoxGetter::preRaiseMs_() const {
+    if (!config_.pipelined) return 0;
+    return config_.preRaiseMs < config_.liftMs ? config_.preRaiseMs : config_.liftMs;
+}
+
+bool BoxGetter::liftAtLeast_(int16_t mm) const {
+    return lift_.heightValid() && lift_.heightMm() >= mm;
+}
+
+uint32_t BoxGetter::carryRaiseMs_() const {
+    if (!config_.pipelined) return config_.liftMs;
+    return config_.carryRaiseMs < config_.liftMs ? config_.carryRaiseMs : config_.liftMs;
+}
+
+// update() 와 같은 순서로 각 단계 시작/끝을 계산한다
+uint32_t BoxGetter::plannedCycleMs(uint8_t turns) const {
+    const uint32_t L = config_.liftMs;
+    const uint32_t pre = preRaiseMs_();
+    const uint32_t drive = turns * mover_.actionMs(gridMove::Action::RotateCW) +
+                           mover_.actionMs(gridMove::Action::Forward);
+    const uint32_t back = mover_.actionMs(gridMove::Action::Backward);
+
+    const uint32_t raiseStart = drive > pre ? drive : pre;
+    const uint32_t raiseEnd = raiseStart + L - pre;
+    const uint32_t carry = carryRaiseMs_() > pre ? carryRaiseMs_() : pre;
+    const uint32_t backStart = raiseStart + carry - pre;
+    const uint32_t backEnd = backStart + back;
+    uint32_t lowerStart = config_.pipelined ? backStart + back * config_.clearPct / 100 : backEnd;
+    if (lowerStart < raiseEnd) lowerStart = raiseEnd;
+    const uint32_t lowerEnd = lowerStart + L;
+    return backEnd > lowerEnd ? backEnd : lowerEnd;
+}
+
+void BoxGetter::beginPhase_(uint8_t phase, uint32_t now) {
+    phaseStart_[phase] = now;
+    if (phase == P_RAISE || phase == P_LOWER) liftPhase_ = phase;
+    else drivePhase_ = phase;
+}
+
+void BoxGetter::endPhase_(uint8_t phase, uint32_t now) {
+    phaseMs_[phase] += now - phaseStart_[phase]; // 올림은 미리 올림 + 나머지 두 번
+    if (phase == liftPhase_) liftPhase_ = P_NONE;
+    if (phase == drivePhase_) drivePhase_ = P_NONE;
+}
 
 void BoxGetter::stepOrient_() {
     if (!plannedTurnQueued_) {
-        using D = gridMove::Direction;
-        switch (mover_.getDirection()) {
-            case D::DOWN:
-                break;
-            case D::UP:
-                mover_.startRotateCW();
-                mover_.startRotateCW();
-                break;
-            case D::LEFT:
-                mover_.startRotateCW();
-                break;
-            case D::RIGHT:
-                mover_.startRotateCCW();
-                break;
+        const uint32_t now = millis();
+        // 도착 방향 → facing_ 최소 회전 (이미 맞으면 회전 없이 바로 전진)
+        // 큐에 자리가 없으면 아무것도 시작하지 않고 다음 tick 에 다시 넣는다 (앞 동작이 끝나면 자리가 난다).
+        // 회전은 스케줄러의 구동부 작업이 다음 tick 에 시작한다.
+        if (!mover_.queueRotateTo(facing_)) return;
+        beginPhase_(P_ORIENT, now);
+        // 선반 밑을 지날 수 있는 높이까지는 회전/전진하는 동안 미리 올린다 (높이를 잴 수 있을 때만)
+        if (preRaiseMs_() > 0 && lift_.heightValid() && !liftAtLeast_(config_.shelfClearMm)) {
+            lift_.upFor(preRaiseMs_());
+            beginPhase_(P_RAISE, now);
         }
         plannedTurnQueued_ = true;
     }
-    
-    // mover_.update()는 메인 update()에서 호출되므로 여기서 호출할 필요 없음
 
-    if (mover_.getDirection() == gridMove::Direction::DOWN && mover_.isIdle()) {
+    if (drivePhase_ == P_NONE && mover_.getDirection() == facing_) {
         state_ = State::Forward;
     }
 }
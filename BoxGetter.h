@@ -17,25 +17,82 @@ public:
         Done
     };
 
+    // 겹쳐 실행(파이프라인) 설정. pipelined=false 면 다섯 단계를 하나씩 순서대로 실행한다 (기본).
+    // 리프트가 겹치는 두 곳은 시간이 아니라 초음파로 잰 높이로 판단한다. 높이를 못 재면 겹치지 않는다.
+    // - preRaiseMs   : 회전/전진하는 동안 미리 올리는 시간의 상한. 잰 높이가 shelfClearMm 에 닿으면 멈춘다
+    //                  (이미 그 위면 미리 올리지 않는다).
+    // - carryRaiseMs : 예상 시간 계산용. 실제로는 잰 높이가 carryMm 이상(상자가 바닥에서 뜸)이어야
+    //                  올림이 끝나기 전에 후진을 시작한다.
+    // - clearPct     : 후진이 이만큼(%) 진행해 선반을 벗어나면 후진 중에 내리기 시작. 100 = 후진 뒤.
+    // 높이 값은 선반/리프트에서 재어 정한 뒤에 pipelined 를 켠다.
+    struct Config {
+        bool     pipelined;
+        uint32_t liftMs;       // 올림/내림 구동 시간
+        uint32_t preRaiseMs;
+        uint32_t carryRaiseMs;
+        uint8_t  clearPct;
+        int16_t  shelfClearMm; // 선반 밑을 지나갈 수 있는 최대 높이 [mm]
+        int16_t  carryMm;      // 상자가 바닥에서 뜨는 높이 [mm]
+    };
+
+    // 단계별 구동 시간 [ms]. 단계가 겹치면 합이 cycleMs 보다 크다.
+    struct Timings {
+        uint32_t orientMs;
+        uint32_t forwardMs;
+        uint32_t raiseMs;     // 미리 올림 + 나머지 올림
+        uint32_t backwardMs;
+        uint32_t lowerMs;
+        uint32_t cycleMs;     // 시작 ~ 끝
+    };
+
     BoxGetter(gridMove& mover, Lift& lift);
 
+    // 지금 바라보는 방향 앞 칸의 상자를 집는다 (회전 없음)
     void startGetBox();
+    // facing 쪽 앞 칸의 상자를 집는다. 도착 방향에서 최소 회전으로 맞춘다.
+    void startGetBox(gridMove::Direction facing);
+    gridMove::Direction facing() const;
     void update();
 
     bool isBusy() const;
     bool isFinished() const;
     State state() const;
 
+    void setConfig(const Config& config);
+    const Config& config() const;
+    // 마지막으로 끝난 집기의 단계별 시간
+    const Timings& lastTimings() const;
+    // 회전 turns 번에서 시작하는 집기의 예상 시간 (현재 설정과 gridMove 시간 기준)
+    uint32_t plannedCycleMs(uint8_t turns) const;
+
 private:
+    enum Phase : uint8_t { P_ORIENT, P_FORWARD, P_RAISE, P_BACKWARD, P_LOWER, P_COUNT, P_NONE = P_COUNT };
+
     void stepOrient_();
+    void beginPhase_(uint8_t phase, uint32_t now);
+    void endPhase_(uint8_t phase, uint32_t now);
+    uint32_t preRaiseMs_() const;
+    uint32_t carryRaiseMs_() const;
+    bool liftAtLeast_(int16_t mm) const;
 
     gridMove& mover_;
     Lift& lift_;
     State state_{State::Idle};
+    gridMove::Direction facing_{gridMove::Direction::DOWN};
+    Config config_{false, 2000, 600, 1200, 60, 22, 30};
 
     bool plannedTurnQueued_{false};
     bool forwardIssued_{false};
     bool backwardIssued_{false};
+    bool liftIssued_{false};   // Raise/Lower 단계에서 리프트 명령을 한 번만 내리기 위한 플래그
+
+    // 구동부/리프트가 지금 실행 중인 단계 (끝나면 P_NONE) 와 단계별 시작 시각/누적 시간
+    uint8_t  drivePhase_{P_NONE};
+    uint8_t  liftPhase_{P_NONE};
+    uint32_t startMs_{0};
+    uint32_t phaseStart_[P_COUNT]{};
+    uint32_t phaseMs_[P_COUNT]{};
+    Timings  timings_{0, 0, 0, 0, 0, 0};
 };
 
 #endif // BOXGETTER_H
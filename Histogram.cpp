@@ -0,0 +1,46 @@
+// Histogram.cpp
+#include "Histogram.h"
+
+static uint8_t bucketOf(uint32_t v) {
+  if (v == 0) return 0;
+  const uint8_t b = (uint8_t)(32 - __builtin_clz(v));
+  return b < Histogram::BUCKETS ? b : Histogram::BUCKETS - 1;
+}
+
+void Histogram::record(uint32_t v) {
+  counts_[bucketOf(v)]++;
+  if (n_ == 0 || v < min_) min_ = v;
+  if (v > max_) max_ = v;
+  sum_ += v;
+  n_++;
+}
+
+void Histogram::reset() {
+  for (uint8_t i = 0; i < BUCKETS; ++i) counts_[i] = 0;
+  n_ = min_ = max_ = 0;
+  sum_ = 0;
+}
+
+uint32_t Histogram::count() const { return n_; }
+uint32_t Histogram::min() const { return min_; }
+uint32_t Histogram::max() const { return max_; }
+uint32_t Histogram::mean() const { return n_ ? (uint32_t)(sum_ / n_) : 0; }
+uint32_t Histogram::bucket(uint8_t i) const { return i < BUCKETS ? counts_[i] : 0; }
+
+uint32_t Histogram::percentile(uint8_t pct) const {
+  if (n_ == 0) return 0;
+  // 순위 = ceil(n * pct / 100), 최소 1
+  uint32_t rank = (uint32_t)(((uint64_t)n_ * pct + 99) / 100);
+  if (rank == 0) rank = 1;
+  uint32_t seen = 0;
+  for (uint8_t i = 0; i < BUCKETS; ++i) {
+    seen += counts_[i];
+    if (seen < rank) continue;
+    if (i == 0) return 0;
+    // 칸 상한을 [min, max] 로 자른다 (마지막 칸은 상한이 없다)
+    const uint32_t upper = i < BUCKETS - 1 ? (1UL << i) - 1 : max_;
+    if (upper > max_) return max_;
+    return upper > min_ ? upper : min_;
+  }
+  return max_;
+}
@@ -0,0 +1,33 @@
+// Histogram.h
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <cstdint>
+
+// 고정 크기 2진 로그 히스토그램 (동적 할당 없음)
+// - 칸 0 은 값 0, 칸 i (i >= 1) 는 [2^(i-1), 2^i). 마지막 칸은 그 이상을 모두 담는다.
+// - record() 는 비트 연산 몇 번이므로 운용 중에도 켜 둔다.
+// - 백분위는 그 칸의 상한(최대값을 넘지 않게)으로 돌려준다. 오차는 값의 2배 이내.
+class Histogram {
+public:
+  static constexpr uint8_t BUCKETS = 24;  // 2^23 (약 8초 [us]) 까지 구분
+
+  void record(uint32_t v);
+  void reset();
+
+  uint32_t count() const;
+  uint32_t min() const;   // 기록 없으면 0
+  uint32_t max() const;
+  uint32_t mean() const;
+  uint32_t percentile(uint8_t pct) const;  // pct: 0~100
+  uint32_t bucket(uint8_t i) const;
+
+private:
+  uint32_t counts_[BUCKETS]{};
+  uint32_t n_{0};
+  uint32_t min_{0};
+  uint32_t max_{0};
+  uint64_t sum_{0};
+};
+
+#endif // HISTOGRAM_H
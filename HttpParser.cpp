@@ -0,0 +1,147 @@
+// HttpParser.cpp
+#include "HttpParser.h"
+#include <ctype.h>
+#include <string.h>
+
+static const char WS_KEY_HEADER[] = "sec-websocket-key:"; // 소문자로 비교
+static constexpr uint8_t WS_KEY_HEADER_LEN = sizeof(WS_KEY_HEADER) - 1;
+
+HttpParser::HttpParser() { reset(); }
+
+void HttpParser::reset() {
+  state_ = State::Method;
+  targetLen_ = 0;
+  target_[0] = '\0';
+  cmd_ = nullptr;
+  headerBytes_ = 0;
+  lineLen_ = 0;
+  keyLine_ = false;
+  wsKeyLen_ = 0;
+  wsKey_[0] = '\0';
+}
+
+HttpParser::Result HttpParser::result() const {
+  if (state_ == State::Done)  return Result::Done;
+  if (state_ == State::Error) return Result::Error;
+  return Result::NeedMore;
+}
+
+HttpParser::Result HttpParser::fail() {
+  state_ = State::Error;
+  return Result::Error;
+}
+
+HttpParser::Result HttpParser::feed(char c) {
+  switch (state_) {
+    case State::Method:
+      if (c == ' ') { state_ = State::Target; break; }
+      if (c < 'A' || c > 'Z' || ++lineLen_ > 7) return fail(); // GET, POST, ...
+      break;
+
+    case State::Target:
+      if (c == ' ') { finishTarget(); state_ = State::Version; break; }
+      if (c == '\r' || c == '\n' || targetLen_ >= TARGET_MAX) return fail();
+      target_[targetLen_++] = c;
+      break;
+
+    case State::Version:
+      if (c == '\n') { state_ = State::Headers; lineLen_ = 0; keyLine_ = true; }
+      else if (++headerBytes_ > HEADER_MAX) return fail();
+      break;
+
+    case State::Headers:
+      if (++headerBytes_ > HEADER_MAX) return fail();
+      if (c == '\r') break;
+      if (c == '\n') {
+        if (lineLen_ == 0) { // 빈 줄 = 헤더 끝
+          wsKey_[wsKeyLen_] = '\0';
+          state_ = State::Done;
+          return Result::Done;
+        }
+        lineLen_ = 0;
+        keyLine_ = true;
+        break;
+      }
+      // 헤더 이름은 흘려보내며 비교만 하고, Sec-WebSocket-Key 값만 담는다
+      if (keyLine_) {
+        if (lineLen_ < WS_KEY_HEADER_LEN) {
+          if (tolower((unsigned char)c) != WS_KEY_HEADER[lineLen_]) keyLine_ = false;
+        } else if (c != ' ' && wsKeyLen_ < WS_KEY_MAX) {
+          wsKey_[wsKeyLen_++] = c;
+        }
+      }
+      lineLen_++;
+      break;
+
+    case State::Done:
+      return Result::Done; // 본문/남은 바이트는 무시
+    case State::Error:
+      return Result::Error;
+  }
+  return Result::NeedMore;
+}
+
+// 요청 대상에서 cmd= 값을 찾아 그 자리에서 NUL 로 끊는다
+void HttpParser::finishTarget() {
+  target_[targetLen_] = '\0';
+  cmd_ = nullptr;
+  char* q = strchr(target_, '?');
+  while (q) {
+    q++;
+    if (strncmp(q, "cmd=", 4) == 0) {
+      cmd_ = q + 4;
+      char* amp = strchr(q, '&');
+      if (amp) *amp = '\0';
+      return;
+    }
+    q = strchr(q, '&');
+  }
+}
+
+const char* HttpParser::command() const { return cmd_ ? cmd_ : ""; }
+
+bool HttpParser::pathIs(const char* path) const {
+  const size_t n = strlen(path);
+  return strncmp(target_, path, n) == 0 && (target_[n] == '\0' || target_[n] == '?');
+}
+
+const char* HttpParser::webSocketKey() const { return wsKey_; }
+
+// ---- 응답 버퍼 ----
+void HttpReply::append(const char* s) {
+  while (*s && len_ < MAX) buf_[len_++] = *s++;
+  buf_[len_] = '\0';
+}
+
+void HttpReply::appendUint(uint32_t v) {
+  char tmp[10];
+  uint8_t n = 0;
+  do { tmp[n++] = (char)('0' + v % 10); v /= 10; } while (v && n < sizeof(tmp));
+  while (n && len_ < MAX) buf_[len_++] = tmp[--n];
+  buf_[len_] = '\0';
+}
+
+// ---- 명령 표 ----
+bool dispatchHttpCommand(const HttpCommand* table, uint8_t count, const char* cmd, HttpReply& reply) {
+  for (uint8_t i = 0; i < count; ++i) {
+    const char* name = table[i].name;
+    const size_t n = strlen(name);
+    const bool prefix = n > 0 && name[n - 1] == '_';
+    if (prefix ? strncmp(cmd, name, n) == 0 : strcmp(cmd, name) == 0) {
+      table[i].handler(prefix ? cmd + n : "", reply);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool parseUintPrefix(const char*& p, uint32_t& out) {
+  if (*p < '0' || *p > '9') return false;
+  uint32_t v = 0;
+  while (*p >= '0' && *p <= '9') {
+    if (v < 100000000u) v = v * 10 + (uint32_t)(*p - '0');
+    p++;
+  }
+  out = v;
+  return true;
+}
@@ -0,0 +1,78 @@
+// HttpParser.h
+#ifndef HTTP_PARSER_H
+#define HTTP_PARSER_H
+
+#include <cstddef>
+#include <cstdint>
+
+// 고정 버퍼 증분 HTTP 요청 파서 (동적 할당 없음)
+// - 받은 바이트를 그때그때 feed() 에 넣는다. 요청 줄과 헤더 끝(빈 줄)까지 오면 Done.
+// - 요청 대상(/?cmd=...)만 TARGET_MAX 바이트 버퍼에 담고, 헤더는 세기만 하고 버린다.
+// - 연결마다 파서 하나를 두고, 느린 클라이언트는 여러 loop() 에 걸쳐 나눠 읽는다.
+class HttpParser {
+public:
+  enum class Result : uint8_t { NeedMore, Done, Error };
+
+  static constexpr uint8_t  TARGET_MAX = 112;  // 요청 대상 최대 길이 (mission_ 정류장 10개)
+  static constexpr uint16_t HEADER_MAX = 1024; // 헤더 전체 최대 바이트
+  static constexpr uint8_t  WS_KEY_MAX = 24;   // base64(16바이트)
+
+  HttpParser();
+
+  void reset();
+  Result feed(char c);
+  Result result() const;
+
+  // 요청 대상의 cmd 쿼리 값 (NUL 종료, 없으면 ""). Done 이후에만 유효.
+  const char* command() const;
+  // 요청 경로가 path 와 같은지 (쿼리 제외)
+  bool pathIs(const char* path) const;
+  // WebSocket 업그레이드 요청의 Sec-WebSocket-Key 값 (없으면 "")
+  const char* webSocketKey() const;
+
+private:
+  enum class State : uint8_t { Method, Target, Version, Headers, Done, Error };
+
+  Result fail();
+  void   finishTarget();
+
+  State    state_{State::Method};
+  char     target_[TARGET_MAX + 1];
+  uint8_t  targetLen_{0};
+  const char* cmd_{nullptr};
+  uint16_t headerBytes_{0};
+  uint16_t lineLen_{0};    // 현재 줄 길이 (\r 제외)
+  bool     keyLine_{false}; // 현재 줄이 아직 Sec-WebSocket-Key 헤더와 일치 중
+  char     wsKey_[WS_KEY_MAX + 1];
+  uint8_t  wsKeyLen_{0};
+};
+
+// 응답 본문용 고정 버퍼
+class HttpReply {
+public:
+  static constexpr uint8_t MAX = 32;
+
+  void clear() { len_ = 0; buf_[0] = '\0'; }
+  void append(const char* s);
+  void appendUint(uint32_t v);
+  const char* c_str() const { return buf_; }
+  uint8_t length() const { return len_; }
+
+private:
+  char    buf_[MAX + 1]{};
+  uint8_t len_{0};
+};
+
+// 명령 처리기 표. name 이 '_' 로 끝나면 접두사 일치(나머지가 arg), 아니면 정확히 일치(arg="").
+struct HttpCommand {
+  const char* name;
+  void (*handler)(const char* arg, HttpReply& reply);
+};
+
+// 표에서 처리기를 찾아 호출. 없으면 false.
+bool dispatchHttpCommand(const HttpCommand* table, uint8_t count, const char* cmd, HttpReply& reply);
+
+// "123" 같은 10진수 앞부분을 읽고 p 를 그 뒤로 옮긴다. 숫자가 없으면 false.
+bool parseUintPrefix(const char*& p, uint32_t& out);
+
+#endif // HTTP_PARSER_H
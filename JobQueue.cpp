@@ -0,0 +1,80 @@
+// JobQueue.cpp
+#include "JobQueue.h"
+
+JobQueue::JobQueue() {
+  for (auto& j : jobs_) {
+    j = Job{0, Type::Move, 0, 0, Status::Unknown, false};
+  }
+}
+
+uint16_t JobQueue::push(Type type, int8_t x, int8_t y, bool afterPrev) {
+  if (full()) return 0;
+  const uint16_t id = nextId_;
+  nextId_ = (nextId_ == 0xFFFF) ? 1 : nextId_ + 1; // 0 은 "실패" 로 예약
+  at(count_) = Job{id, type, x, y, Status::Queued, afterPrev};
+  count_++;
+  return id;
+}
+
+JobQueue::Job* JobQueue::running() {
+  if (count_ == 0 || at(0).status != Status::Running) return nullptr;
+  return &at(0);
+}
+
+JobQueue::Job* JobQueue::next() {
+  const uint8_t k = running() ? 1 : 0;
+  return k < count_ ? &at(k) : nullptr;
+}
+
+JobQueue::Job* JobQueue::startNext() {
+  if (running() || count_ == 0) return nullptr;
+  at(0).status = Status::Running;
+  return &at(0);
+}
+
+void JobQueue::finishRunning(bool ok) {
+  Job* j = running();
+  if (!j) return;
+  j->status = ok ? Status::Done : Status::Failed;
+  if (!ok) failed_++;
+  head_ = (head_ + 1) & (SLOTS - 1);
+  count_--;
+  // 앞 작업에 기대는 작업은 시작하지 않고 함께 실패 (줄줄이)
+  while (!ok && count_ > 0 && at(0).afterPrev) {
+    at(0).status = Status::Failed;
+    failed_++;
+    head_ = (head_ + 1) & (SLOTS - 1);
+    count_--;
+  }
+}
+
+void JobQueue::cancelAll() {
+  while (count_ > 0) {
+    at(0).status = Status::Failed;
+    failed_++;
+    head_ = (head_ + 1) & (SLOTS - 1);
+    count_--;
+  }
+}
+
+JobQueue::Status JobQueue::status(uint16_t id) const {
+  if (id == 0) return Status::Unknown;
+  for (const auto& j : jobs_) {
+    if (j.id == id) return j.status;
+  }
+  return Status::Unknown;
+}
+
+uint8_t JobQueue::pending() const { return count_; }
+bool JobQueue::full() const { return count_ >= CAPACITY; }
+uint16_t JobQueue::failedCount() const { return failed_; }
+
+const char* JobQueue::statusName(Status s) {
+  switch (s) {
+    case Status::Queued:  return "queued";
+    case Status::Running: return "running";
+    case Status::Done:    return "done";
+    case Status::Failed:  return "failed";
+    default:              return "unknown";
+  }
+}
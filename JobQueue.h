@@ -0,0 +1,58 @@
+// JobQueue.h
+#ifndef JOB_QUEUE_H
+#define JOB_QUEUE_H
+
+#include <cstdint>
+
+// 고정 크기 작업 큐 (동적 할당 없음)
+// - push 한 순서대로 하나씩 실행한다. 실행 중인 작업은 항상 맨 앞에 있다.
+// - 작업마다 id 를 주고, 끝난 작업의 상태도 슬롯이 재사용될 때까지 조회할 수 있다.
+// - afterPrev 로 넣은 작업은 바로 앞 작업이 실패하면 시작하지 않고 함께 실패한다 (미션 구간처럼
+//   앞 작업의 결과에 기대는 작업: 목표 칸에 못 갔으면 그 자리에서 내려놓지 않는다).
+class JobQueue {
+public:
+  // Box: 아래 칸 상자, Pick: (x, y) 칸 상자, Calibrate: 제자리 구동 보정 (MotionCalib)
+  enum class Type : uint8_t { Move, LiftUp, LiftDown, Box, Pick, Calibrate };
+  enum class Status : uint8_t { Queued, Running, Done, Failed, Unknown };
+
+  struct Job {
+    uint16_t id;
+    Type     type;
+    int8_t   x;       // Move 의 목표 칸, Pick 의 상자 칸
+    int8_t   y;
+    Status   status;
+    bool     afterPrev; // 앞 작업이 성공해야 시작
+  };
+
+  static constexpr uint8_t CAPACITY = 8;  // 대기 + 실행 중 최대 작업 수
+  static constexpr uint8_t SLOTS    = 16; // 끝난 작업 기록 포함 (2의 거듭제곱)
+
+  JobQueue();
+
+  // 새 작업 id (1 이상), 가득 찼으면 0
+  uint16_t push(Type type, int8_t x = 0, int8_t y = 0, bool afterPrev = false);
+
+  Job* running();                 // 실행 중 작업 (없으면 nullptr)
+  Job* next();                    // 다음에 실행할 대기 작업 (없으면 nullptr)
+  Job* startNext();               // 다음 대기 작업을 Running 으로 바꿔 반환
+  void finishRunning(bool ok);    // 실행 중 작업을 Done/Failed 로 마치고 큐에서 뺀다 (실패면 afterPrev 작업도)
+  void cancelAll();               // 대기/실행 중 작업을 모두 Failed 로
+
+  Status status(uint16_t id) const;
+  uint8_t pending() const;        // 대기 + 실행 중 작업 수
+  bool full() const;
+  uint16_t failedCount() const;
+
+  static const char* statusName(Status s);
+
+private:
+  Job& at(uint8_t k) { return jobs_[(head_ + k) & (SLOTS - 1)]; }
+
+  Job      jobs_[SLOTS];
+  uint8_t  head_{0};      // 가장 오래된 미완료 작업의 슬롯
+  uint8_t  count_{0};     // 미완료(대기 + 실행 중) 작업 수
+  uint16_t nextId_{1};
+  uint16_t failed_{0};
+};
+
+#endif // JOB_QUEUE_H
@@ -0,0 +1,228 @@
+// MotionCalib.cpp
+#include "MotionCalib.h"
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <stddef.h>
+
+static constexpr uint16_t RECORD_MAGIC = 0x4353; // 'S' 'C'
+
+struct Record {
+  uint16_t magic;
+  uint8_t  version;
+  uint8_t  size;     // sizeof(Params): 같은 버전이라도 크기가 다르면 무시
+  MotionCalib::Params params;
+  uint16_t crc;      // magic ~ params
+};
+
+// 시험 순서: 앞뒤로 한 칸씩, 오른쪽/왼쪽으로 90도씩 (제자리로 돌아온다). 각각 두 번.
+static const gridMove::Action TESTS[MotionCalib::TEST_COUNT] = {
+  gridMove::Action::Forward, gridMove::Action::Backward,
+  gridMove::Action::Forward, gridMove::Action::Backward,
+  gridMove::Action::RotateCW, gridMove::Action::RotateCCW,
+  gridMove::Action::RotateCW, gridMove::Action::RotateCCW,
+};
+
+// CRC-16/CCITT-FALSE
+static uint16_t crc16(const uint8_t* p, size_t n) {
+  uint16_t crc = 0xFFFF;
+  while (n--) {
+    crc ^= (uint16_t)(*p++) << 8;
+    for (uint8_t b = 0; b < 8; ++b) crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+  }
+  return crc;
+}
+
+static uint16_t recordCrc(const Record& r) {
+  return crc16((const uint8_t*)&r, offsetof(Record, crc));
+}
+
+// 오른쪽 PWM 을 왼쪽 바퀴 속도에 맞춘다 (속도 ∝ 듀티 가정, 부호 유지)
+static int balanced(int pwm, uint32_t left, uint32_t right) {
+  const int32_t mag = constrain((int32_t)((abs(pwm) * left + right / 2) / right), 1, 255);
+  return pwm < 0 ? -mag : mag;
+}
+
+// 목표 틱 수 ÷ 시험 동작에서 왼쪽 바퀴가 간 틱 수 × 시험 시간. 두 배 넘게 바뀌면 엔코더 이상으로 본다.
+static bool refit(uint32_t testMs, uint32_t targetTicks, uint32_t ticks, uint32_t& out) {
+  const uint32_t ms = (uint32_t)((uint64_t)testMs * targetTicks / ticks);
+  if (ms < testMs / 2 || ms > testMs * 2) return false;
+  out = ms;
+  return true;
+}
+
+MotionCalib::MotionCalib(gridMove& mover) : mover_(mover) {}
+
+bool MotionCalib::readStored(Params& out) {
+  Record r;
+  EEPROM.get(EEPROM_ADDR, r);
+  if (r.magic != RECORD_MAGIC || r.version != LAYOUT_VERSION || r.size != sizeof(Params)) return false;
+  if (r.crc != recordCrc(r)) return false;
+  out = r.params;
+  return true;
+}
+
+bool MotionCalib::load() {
+  Params p;
+  if (!readStored(p)) return false;
+  apply(mover_, p);
+  return true;
+}
+
+void MotionCalib::save() const {
+  Record r;
+  memset(&r, 0, sizeof(r));
+  r.magic = RECORD_MAGIC;
+  r.version = LAYOUT_VERSION;
+  r.size = sizeof(Params);
+  r.params = capture(mover_);
+  r.crc = recordCrc(r);
+  EEPROM.put(EEPROM_ADDR, r);
+}
+
+void MotionCalib::erase() {
+  EEPROM.write(EEPROM_ADDR, 0xFF); // magic 이 깨지면 기록 없음
+}
+
+MotionCalib::Params MotionCalib::capture(const gridMove& mover) {
+  int fl, fr, bl, br, rl, rr;
+  mover.getForwardPWMs(fl, fr);
+  mover.getBackwardPWMs(bl, br);
+  mover.getRotatePWMs(rl, rr);
+  const gridMove::Odometry& odo = mover.odometry();
+  return Params{
+    mover.getForwardDurationMs(), mover.getBackwardDurationMs(), mover.getRotateDurationMs(),
+    (int16_t)fl, (int16_t)fr, (int16_t)bl, (int16_t)br, (int16_t)rl, (int16_t)rr,
+    odo.ticksPerCell, odo.ticksPer90
+  };
+}
+
+void MotionCalib::apply(gridMove& mover, const Params& p) {
+  mover.setForwardDurationMs(p.forwardMs);
+  mover.setBackwardDurationMs(p.backwardMs);
+  mover.setRotateDurationMs(p.rotateMs);
+  mover.setForwardPWMs(p.forwardLeft, p.forwardRight);
+  mover.setBackwardPWMs(p.backwardLeft, p.backwardRight);
+  mover.setRotatePWMs(p.rotateLeft, p.rotateRight);
+  gridMove::Odometry odo = mover.odometry();
+  if (p.ticksPerCell && p.ticksPer90) {
+    odo.ticksPerCell = p.ticksPerCell;
+    odo.ticksPer90 = p.ticksPer90;
+    mover.setOdometry(odo);
+  }
+}
+
+bool MotionCalib::start() {
+  if (state_ == State::Running || !mover_.isIdle() || mover_.odometry().ticksPerCell == 0) return false;
+  savedProfile_ = mover_.profile();
+  savedOdometry_ = mover_.odometry();
+  // 시험 동작은 시간으로 끝나는 계단 구동. 틱은 계속 센다.
+  mover_.setProfile(gridMove::Profile{0, 0, 100});
+  mover_.setOdometry(gridMove::Odometry{0, 0, 0, savedOdometry_.timeoutPct});
+  state_ = State::Running;
+  test_ = 0;
+  testStarted_ = false;
+  return true;
+}
+
+void MotionCalib::update() {
+  if (state_ != State::Running) return;
+  const gridMove::Action a = TESTS[test_];
+
+  if (!testStarted_) {
+    mover_.encoderTicks(tick0Left_, tick0Right_);
+    testMs_ = mover_.actionMs(a);
+    switch (a) {
+      case gridMove::Action::Forward:   mover_.startForward();   break;
+      case gridMove::Action::Backward:  mover_.startBackward();  break;
+      case gridMove::Action::RotateCW:  mover_.startRotateCW();  break;
+      case gridMove::Action::RotateCCW: mover_.startRotateCCW(); break;
+      default: break;
+    }
+    testStarted_ = true;
+    return;
+  }
+  if (!mover_.isIdle()) return;
+
+  int32_t l, r;
+  mover_.encoderTicks(l, r);
+  if (!fit(a, (uint32_t)abs(l - tick0Left_), (uint32_t)abs(r - tick0Right_))) {
+    finish(false);
+    return;
+  }
+  testStarted_ = false;
+  if (++test_ == TEST_COUNT) finish(true);
+}
+
+// 시험 동작 하나의 바퀴별 틱 수로 PWM 균형과 시간을 고친다
+bool MotionCalib::fit(gridMove::Action a, uint32_t left, uint32_t right) {
+  if (left == 0 || right == 0) return false;
+  int l, r;
+  uint32_t ms;
+  switch (a) {
+    case gridMove::Action::Forward:
+      if (!refit(testMs_, savedOdometry_.ticksPerCell, left, ms)) return false;
+      mover_.getForwardPWMs(l, r);
+      mover_.setForwardPWMs(l, balanced(r, left, right));
+      mover_.setForwardDurationMs(ms);
+      return true;
+    case gridMove::Action::Backward:
+      if (!refit(testMs_, savedOdometry_.ticksPerCell, left, ms)) return false;
+      mover_.getBackwardPWMs(l, r);
+      mover_.setBackwardPWMs(l, balanced(r, left, right));
+      mover_.setBackwardDurationMs(ms);
+      return true;
+    case gridMove::Action::RotateCW:
+    case gridMove::Action::RotateCCW: // CCW 는 같은 PWM 의 부호만 바꿔 쓴다
+      if (!refit(testMs_, savedOdometry_.ticksPer90, left, ms)) return false;
+      mover_.getRotatePWMs(l, r);
+      mover_.setRotatePWMs(l, balanced(r, left, right));
+      mover_.setRotateDurationMs(ms);
+      return true;
+    default:
+      return false;
+  }
+}
+
+void MotionCalib::finish(bool ok) {
+  mover_.setProfile(savedProfile_);
+  mover_.setOdometry(savedOdometry_);
+  if (ok) save();
+  state_ = ok ? State::Done : State::Failed;
+}
+
+void MotionCalib::abort() {
+  if (state_ == State::Running) finish(false);
+}
+
+MotionCalib::State MotionCalib::state() const { return state_; }
+bool MotionCalib::isBusy() const { return state_ == State::Running; }
+
+bool MotionCalib::scale(char kind, uint16_t actualPct) {
+  if (state_ == State::Running || actualPct < 50 || actualPct > 200) return false;
+  gridMove::Odometry odo = mover_.odometry();
+  // 덜 갔으면(pct < 100) 시간과 틱 수를 늘린다
+  auto scaled = [actualPct](uint32_t v) { return (uint32_t)((v * 100u + actualPct / 2u) / actualPct); };
+  if (kind == 'f') {
+    mover_.setForwardDurationMs(scaled(mover_.getForwardDurationMs()));
+    mover_.setBackwardDurationMs(scaled(mover_.getBackwardDurationMs()));
+    odo.ticksPerCell = (uint16_t)scaled(odo.ticksPerCell);
+  } else if (kind == 'r') {
+    mover_.setRotateDurationMs(scaled(mover_.getRotateDurationMs()));
+    odo.ticksPer90 = (uint16_t)scaled(odo.ticksPer90);
+  } else {
+    return false;
+  }
+  mover_.setOdometry(odo);
+  save();
+  return true;
+}
+
+bool MotionCalib::setTicks(uint16_t ticksPerCell, uint16_t ticksPer90) {
+  if (state_ == State::Running || ticksPerCell == 0 || ticksPer90 == 0) return false;
+  gridMove::Odometry odo = mover_.odometry();
+  odo.ticksPerCell = ticksPerCell;
+  odo.ticksPer90 = ticksPer90;
+  mover_.setOdometry(odo);
+  save();
+  return true;
+}
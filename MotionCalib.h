@@ -0,0 +1,77 @@
+// MotionCalib.h
+#ifndef MOTION_CALIB_H
+#define MOTION_CALIB_H
+
+#include <cstdint>
+#include "gridMove.h"
+
+// 구동 보정: 시험 동작으로 gridMove 의 시간/PWM 설정을 맞추고 EEPROM 에 저장한다.
+// - 자동 (엔코더 필요): 제자리에서 전진/후진 한 칸, CW/CCW 90도를 두 번씩 시간으로 돌리고
+//   바퀴별 틱 수로 (1) 오른쪽 PWM 을 왼쪽 바퀴 속도에 맞추고 (2) 한 칸/90도 시간을 다시 잰다.
+//   첫 번째 결과로 고친 뒤 두 번째로 다시 재므로 속도가 듀티에 정확히 비례하지 않아도 수렴한다.
+//   시험 동작은 계단 구동(가감속 없음)으로 한다: set*DurationMs 가 100% 계단 기준이기 때문.
+//   앞에 한 칸, 제자리 회전 공간이 있어야 한다.
+// - 작업자 입력: 한 칸/90도 동작이 실제로 간 비율(%)을 넣으면 시간과 엔코더 틱 수를 그만큼 고친다.
+// 저장 형식은 [magic 'SC'][version][크기][Params][CRC16] 이고, 부팅 때 load() 가 gridMove
+// setter 로 적용한다. 레이아웃을 바꾸면 LAYOUT_VERSION 을 올린다 (버전이 다른 기록은 무시하고 기본값).
+class MotionCalib {
+public:
+  // EEPROM 에 저장하는 값
+  struct Params {
+    uint32_t forwardMs;
+    uint32_t backwardMs;
+    uint32_t rotateMs;
+    int16_t  forwardLeft, forwardRight;
+    int16_t  backwardLeft, backwardRight;
+    int16_t  rotateLeft, rotateRight;
+    uint16_t ticksPerCell;   // 0 = 엔코더 없이 보정한 값
+    uint16_t ticksPer90;
+  };
+
+  enum class State : uint8_t { Idle, Running, Done, Failed };
+
+  static constexpr uint16_t EEPROM_ADDR    = 0;
+  static constexpr uint8_t  LAYOUT_VERSION = 1;
+  static constexpr uint8_t  TEST_COUNT     = 8;
+
+  explicit MotionCalib(gridMove& mover);
+
+  // 저장된 값을 mover 에 적용. 기록이 없거나 버전/크기/CRC 가 다르면 false (기본값 유지).
+  // 저장된 엔코더 틱 수가 있으면 적용해 엔코더 종료를 켠다 (틱 수는 보정 기록에서만 온다).
+  bool load();
+  void save() const;
+  void erase();  // 다음 부팅부터 기본값
+  static bool readStored(Params& out);
+
+  static Params capture(const gridMove& mover);
+  static void apply(gridMove& mover, const Params& p);
+
+  // 자동 보정 시작. 엔코더가 켜져 있고 mover 가 정지 상태일 때만 true.
+  bool start();
+  void update();
+  void abort();   // 진행 중이면 설정을 되돌리고 Failed
+  State state() const;
+  bool isBusy() const;
+
+  // 작업자 입력: kind 'f' = 한 칸 (전진/후진 시간, ticksPerCell), 'r' = 90도 (회전 시간, ticksPer90).
+  // actualPct = 실제로 간 거리/각도 ÷ 목표 × 100 (50~200). 고친 뒤 저장한다.
+  bool scale(char kind, uint16_t actualPct);
+  // 작업자 입력: 잰 엔코더 틱 수 (한 칸, 90도). 엔코더 종료를 켜고 저장한다. 자동 보정은 이 값이 있어야 한다.
+  bool setTicks(uint16_t ticksPerCell, uint16_t ticksPer90);
+
+private:
+  bool fit(gridMove::Action a, uint32_t left, uint32_t right);
+  void finish(bool ok);
+
+  gridMove& mover_;
+  State     state_{State::Idle};
+  uint8_t   test_{0};
+  bool      testStarted_{false};
+  uint32_t  testMs_{0};
+  int32_t   tick0Left_{0};
+  int32_t   tick0Right_{0};
+  gridMove::Profile  savedProfile_{0, 0, 100};
+  gridMove::Odometry savedOdometry_{0, 0, 0, 150};
+};
+
+#endif // MOTION_CALIB_H
@@ -16,81 +16,131 @@ void PathRunner::loadPath(const Node* points, uint16_t count) {
   }
   // 상태 초기화
   i_ = 0;
+  queuedTo_ = 0;
   started_ = false;
-  inDwell_ = false;
-  wasBusy_ = false;
+  pauseNext_ = false;
 }
 
 void PathRunner::start() {
   if (n_ > 0) {
     started_ = true;
     i_ = 0;
-    inDwell_ = false;
-    wasBusy_ = false;
+    queuedTo_ = 0;
+    pauseNext_ = false;
+    mover_.setReachedTag(0);
+    fillQueue(); // 첫 동작은 스케줄러의 구동부 작업이 다음 tick 에 시작한다
   }
 }
 
+// gridMove::update() 는 부르지 않는다: 스케줄러가 mover 작업을 이 작업보다 먼저 실행한다.
 void PathRunner::update() {
-  mover_.update(); // 하위 모듈 먼저 업데이트
-
-  if (!started_ || isFinished()) {
+  if (!started_) {
     return;
   }
+  i_ = mover_.reachedTag();
+  fillQueue();
+}
 
-  const bool busyNow = !mover_.isIdle();
+// 남은 경로를 구간 단위로 gridMove 큐에 쌓는다. 한 구간은 최대 정지 1 + 회전 2 + 직진 1.
+// 정지는 칸 사이 dwell 과 그 구간 첫 칸의 waitMs 를 합친 것 (출발 칸에서 회전 전에 기다린다).
+void PathRunner::fillQueue() {
+  while (queuedTo_ < n_ - 1 && mover_.queueFree() >= 4) {
+    const uint16_t from = queuedTo_;
+    const uint16_t end = mergeStraight_ ? segmentEnd(from) : (uint16_t)(from + 1);
+    const Node& last = path_[end];
+    const int cells = (int)(end - from);
+    const int dx = (last.x - path_[from].x) / cells;
+    const int dy = (last.y - path_[from].y) / cells;
 
-  // 이동 세그먼트가 방금 끝났는지 확인
-  if (wasBusy_ && !busyNow) {
-    // 마지막 세그먼트가 아니라면, 칸 사이 정지(dwell) 시작
-    if (i_ < n_ - 1) {
-      inDwell_ = true;
-      dwellEndMs_ = millis() + dwellMs_;
-    }
+    const uint32_t pauseMs = (pauseNext_ ? dwellMs_ : 0) + path_[from + 1].waitMs;
+    if (pauseMs > 0) mover_.queuePause(pauseMs, from); // 칸 사이 정지(dwell) + 기다림
+    if (!mover_.queueDrive(dx, dy, (uint8_t)cells, last.reverse, from)) return;
+    pauseNext_ = true;
+    queuedTo_ = end;
   }
-  wasBusy_ = busyNow;
+}
 
-  // Dwell 상태 처리
-  if (inDwell_) {
-    if ((int32_t)(millis() - dwellEndMs_) >= 0) {
-      inDwell_ = false; // Dwell 시간 종료
-    } else {
-      return; // 아직 Dwell 중
-    }
+// from 에서 시작해 이동 방향과 전진/후진이 같은 마지막 칸의 인덱스 (기다림이 있는 칸 앞에서 끊는다)
+uint16_t PathRunner::segmentEnd(uint16_t from) const {
+  const int dx = path_[from + 1].x - path_[from].x;
+  const int dy = path_[from + 1].y - path_[from].y;
+  const bool rev = path_[from + 1].reverse;
+  uint16_t end = from + 1;
+  while (end + 1 < n_ && end - from < 255 &&
+         path_[end + 1].x - path_[end].x == dx &&
+         path_[end + 1].y - path_[end].y == dy &&
+         path_[end + 1].reverse == rev &&
+         path_[end + 1].waitMs == 0) {
+    end++;
   }
+  return end;
+}
 
-  // 다음 이동 세그먼트 시작
-  if (!mover_.isIdle() || inDwell_) {
-    return; // 아직 이전 동작이 진행 중이거나 Dwell 중이면 대기
+uint16_t PathRunner::nextBoundary() const {
+  if (!started_) return i_;
+  const gridMove::Action a = mover_.currentAction();
+  if (a != gridMove::Action::Forward && a != gridMove::Action::Backward) {
+    return i_; // 칸 위 (회전/dwell 중이거나 다음 구간 시작 전)
   }
+  return (uint16_t)(mover_.currentTag() + mover_.driveCellsDone() + 1);
+}
 
-  if (i_ < n_ - 1) {
-    const Node& curr = path_[i_];
-    const Node& next = path_[i_ + 1];
-    mover_.stepTo(curr.x, curr.y, next.x, next.y);
-    i_++; // 다음 세그먼트로 인덱스 이동
+int16_t PathRunner::findCell(int x, int y) const {
+  if (!started_) return -1;
+  for (uint16_t k = i_; k < n_; ++k) {
+    if (path_[k].x == x && path_[k].y == y) return (int16_t)k;
   }
+  return -1;
 }
 
-void PathRunner::forceStop() {
-    // 하위 모듈 즉시 정지
-    mover_.stopMotors();
-    while(mover_.hasQueued()) {
-      mover_.popQueued();
+const PathRunner::Node& PathRunner::node(uint16_t i) const { return path_[i]; }
+
+bool PathRunner::spliceAt(uint16_t idx, const Node* points, uint16_t count) {
+  if (!started_ || !points || count == 0) return false;
+  if (idx >= n_ || idx < nextBoundary()) return false;
+  if (points[0].x != path_[idx].x || points[0].y != path_[idx].y) return false;
+  if (idx + count > MAX_POINTS) return false;
+
+  // idx 를 지나 쌓아 둔 동작은 버리고, 진행 중인 직진은 idx 칸에서 끝나도록 줄인다
+  if (idx < queuedTo_) {
+    mover_.clearQueued();
+    const gridMove::Action a = mover_.currentAction();
+    if (a == gridMove::Action::Forward || a == gridMove::Action::Backward) {
+      const uint16_t from = mover_.currentTag();
+      queuedTo_ = (uint16_t)(from + mover_.limitDrive((uint8_t)(idx - from))); // 직진 끝 칸
+      pauseNext_ = true;
+    } else {
+      queuedTo_ = i_;
+      pauseNext_ = (a == gridMove::Action::Idle) && i_ > 0; // 회전/dwell 중이면 이미 멈춰 있음
     }
+  }
+  for (uint16_t k = 1; k < count; ++k) {
+    path_[idx + k] = points[k];
+  }
+  n_ = (uint16_t)(idx + count);
+  fillQueue();
+  return true;
+}
+
+void PathRunner::forceStop() {
+    // 하위 모듈 즉시 정지 (진행 중인 동작까지 버려야 update() 가 모터를 다시 켜지 않는다)
+    mover_.abort();
 
     // PathRunner 상태 초기화
     n_ = 0;
     i_ = 0;
+    queuedTo_ = 0;
     started_ = false;
-    inDwell_ = false;
-    wasBusy_ = false;
+    pauseNext_ = false;
 }
 
 bool PathRunner::isFinished() const {
-  return !started_ || (i_ >= n_ - 1 && mover_.isIdle() && !inDwell_);
+  return !started_ || (queuedTo_ >= n_ - 1 && mover_.isIdle());
 }
 
 uint16_t PathRunner::pathLength()  const { return n_; }
 uint16_t PathRunner::segmentIndex() const { return i_; }
 void PathRunner::setDwellMs(uint16_t ms) { dwellMs_ = ms; }
+uint16_t PathRunner::dwellMs() const { return dwellMs_; }
+void PathRunner::setMergeStraight(bool on) { mergeStraight_ = on; }
 
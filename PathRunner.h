@@ -7,7 +7,9 @@
 
 class PathRunner {
 public:
-  struct Node { int x; int y; };
+  // reverse: 이전 칸 → 이 칸 을 후진으로 이동 (planTimed 가 채움)
+  // waitMs : 이전 칸에서 (dwell 과 회전 뒤에) 더 기다렸다가 이 칸으로 출발 (planSpaceTime 이 채움)
+  struct Node { int x; int y; bool reverse{false}; uint16_t waitMs{0}; };
   static constexpr uint16_t MAX_POINTS = 64;
 
   explicit PathRunner(gridMove& mover, uint16_t dwell_ms = 150);
@@ -22,17 +24,41 @@ public:
 
   void forceStop(); // 비상 정지 함수
   void setDwellMs(uint16_t ms);
+  uint16_t dwellMs() const;
+
+  // 직선 구간 병합: 같은 방향(전진/후진 포함)으로 이어지는 칸들을 하나의 긴 이동으로
+  // 실행한다. 정지와 dwell 은 방향이 바뀌는 곳과 기다림(waitMs)이 있는 칸에서만 생긴다.
+  // 시공간 계획 경로는 칸마다 실행한다고 보고 시간을 잡으므로 병합을 끄고 돌린다.
+  void setMergeStraight(bool on);
+
+  // 경로는 start() 에서 (회전, 직진, dwell) 동작으로 번역해 gridMove 큐에 미리 쌓는다.
+  // 큐가 모자라면 자리가 나는 대로 이어서 쌓는다.
+
+  // ---- 주행 중 경로 수정 (지도 변경 시 재계획용) ----
+  // 현재 동작을 멈추지 않고 바꿀 수 있는 가장 가까운 칸 경계의 경로 인덱스.
+  // 직선 병합 구간 중간이면 지금 들어서고 있는 칸, 칸 위에 있으면 현재 인덱스.
+  uint16_t nextBoundary() const;
+  // 마지막으로 도착한 칸 이후(포함) 남은 경로에서 (x,y) 의 첫 인덱스, 없으면 -1
+  int16_t  findCell(int x, int y) const;
+  const Node& node(uint16_t i) const;
+  // path_[idx] 이후를 points[1..] 로 교체한다. points[0] 은 path_[idx] 와 같은 칸이어야 하고
+  // idx 는 nextBoundary() 이상이어야 한다. 진행 중인 직선 구간은 idx 칸에서 끝나도록 줄인다.
+  // count == 1 이면 idx 칸에서 경로를 끝낸다.
+  bool spliceAt(uint16_t idx, const Node* points, uint16_t count);
 
 private:
   gridMove&  mover_;
   Node       path_[MAX_POINTS]{};
   uint16_t   n_{0};
-  uint16_t   i_{0};
+  uint16_t   i_{0};          // 마지막으로 도착한 칸의 인덱스
+  uint16_t   queuedTo_{0};   // gridMove 큐에 쌓은 동작이 도착하는 인덱스
   bool       started_{false};
-  bool       inDwell_{false};
-  uint32_t   dwellEndMs_{0};
+  bool       pauseNext_{false}; // 다음 구간 앞에 dwell 을 넣어야 함
   uint16_t   dwellMs_{150};
-  bool       wasBusy_{false};
+  bool       mergeStraight_{false};
+
+  uint16_t   segmentEnd(uint16_t from) const;
+  void       fillQueue();
 };
 
 #endif // PATH_RUNNER_H
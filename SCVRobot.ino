@@ -6,9 +6,21 @@
 #include "WiFiS3.h"
 #include "lift.h"
 #include "astar5x5.h"
+#include "astarTimed.h"
+#include "astarSpaceTime.h"
+#include "routeTable.h"
+#include "dstarLite.h"
 #include "PathRunner.h"
 #include "arduino_secrets.h"
 #include "BoxGetter.h"
+#include "JobQueue.h"
+#include "HttpParser.h"
+#include "WsSession.h"
+#include "UdpTeleop.h"
+#include "tourPlanner.h"
+#include "MotionCalib.h"
+#include "Scheduler.h"
+#include "Telemetry.h"
 
 // =================================================================
 // 1. 와이파이 정보
@@ -25,6 +37,7 @@ Lift       robotLift;           // 리프트 제어기
 gridMove   mover;               // 저수준 모터 제어기
 PathRunner runner(mover, 150);  // 경로 실행기 (칸 이동 후 150ms 대기)
 BoxGetter  boxGetter(mover, robotLift);
+MotionCalib calib(mover);       // 구동 보정 (EEPROM 저장/부팅 시 적용)
 
 // --- 로봇의 현재 상태 ---
 int currentX = 0; // 로봇의 현재 X 좌표 (0-4)
@@ -35,8 +48,9 @@ bool isLiftUpState = false; // 리프트의 논리적 상태 (UI 토글용)
 int pathGoalX = 0;
 int pathGoalY = 0;
 
-// --- 5x5 지도 정의 ---
+// --- 5x5 지도 정의 (부팅 시 초기 배치) ---
 // true(1): 장애물, false(0): 이동 가능 경로
+// 실행 중에는 gridMap 이 실제 지도이며 block_/free_ 명령으로 바뀐다.
 const bool grid[5][5] = {
   {0, 0, 0, 0, 0}, // 웹 앱의 최하단 줄과 일치
   {0, 1, 1, 0, 0},
@@ -45,12 +59,180 @@ const bool grid[5][5] = {
   {0, 0, 0, 1, 0}  // 웹 앱의 최상단 줄과 일치
 };
 
+OccupancyGrid<5, 5> gridMap; // 플래너용 비트 지도 (setup 에서 grid 로부터 생성)
+DStarLite<5, 5> repair(gridMap); // 주행 중 지도가 바뀌면 남은 경로를 증분 수정
+
+// 후진 진입 허용: 180도 회전(약 3.9초) 대신 후진으로 들어갈 수 있으면 그쪽을 택한다
+const bool ALLOW_REVERSE = true;
+
+// 전 쌍 다음 칸 테이블: 부팅/지도 변경 시 한 번 만들고 도달 가능 여부를 즉시 답한다.
+// USE_ROUTE_TABLE 이면 move_ 도 탐색 없이 테이블로 경로를 만든다 (최단 칸 수, 회전 비용 무시).
+RouteTable<5, 5> routes;
+const bool USE_ROUTE_TABLE = false;
+
+// 회전 비용이 필요 없을 때의 칸 수 최단 경로 엔진 (planPath5x5).
+// USE_CELL_PLANNER 이면 move_ 를 이 엔진으로 계획한다 (USE_ROUTE_TABLE 이 먼저). 표를 들고 있지 않아
+// 지도가 자주 바뀌어도 routes 재구성 없이 바로 쓰고, Bitboard 는 planTimed 보다 훨씬 빠르다.
+// 바닥을 나눠 쓰는 중에는 시간창을 모르므로 쓰지 않는다.
+const PlannerEngine CELL_PLANNER = PlannerEngine::Bitboard;
+const bool USE_CELL_PLANNER = false;
+
 PathRunner::Node pathNodes[PathRunner::MAX_POINTS];
 
+// --- 다른 로봇과 바닥 나눠 쓰기 ---
+// 관제(또는 다른 로봇)가 hold_ 명령으로 알려 준 (칸, 시간창) 을 피해 move 경로를 시공간으로 계획한다.
+// 표에 시간창이 남아 있으면 move/pick/미션 계획과 지도 변경 우회가 모두 planSpaceTime 으로
+// 기다림이 들어간 경로를 만들고, 계획한 시각대로 가도록 직선 병합 없이 칸마다 달린다.
+// 도착 칸은 다음 명령까지 머무는 것으로 본다.
+// 표의 시각은 holdClockMs (millis) 기준 상대값이고 sharingFloor() 때마다 원점을 지금으로 옮긴다
+// (millis 가 한 바퀴 돌아도 비교가 맞다). 시간창은 HOLD_MARGIN_MS 만큼 앞뒤로 넓혀 잡는다.
+const uint8_t  HOLD_AGENT     = 1;   // hold_ 로 받은 시간창의 주인 (이 로봇은 0)
+const uint32_t HOLD_MARGIN_MS = 500;
+const uint32_t HOLD_MAX_MS    = 3600000UL; // 받는 시간창의 최대 끝 (1시간, ST_FOREVER 와 멀리)
+ReservationTable<32> holds;
+uint32_t holdClockMs = 0;            // holds 의 시각 0 에 해당하는 millis()
+bool replanAtStop = false;           // 바닥을 나눠 쓰는 중 막힌 경로를 경계 칸에서 멈춤 → 거기서 다시 계획
+SpaceTimeWorkspace<5, 5, 192> stWorkspace; // 상태 192개 (약 3.8KB)
+
+// --- 작업 큐 ---
+// 바쁠 때 들어온 명령도 버리지 않고 쌓아 두었다가, 앞 작업이 끝나는 즉시 다음을 시작한다.
+JobQueue jobs;
+uint8_t runningEndHeading = 0; // 실행 중 move 작업의 예상 도착 방향
+
+// 다음 move 작업의 경로를 현재 작업의 예상 종료 상태(칸, 방향)에서 미리 계획해 둔다.
+// 실제 시작 상태가 예상과 다르면(우회/정지 등) 시작할 때 다시 계획한다.
+struct Preplan {
+  bool     valid;
+  uint16_t jobId;
+  uint16_t n;
+  int8_t   fromX, fromY;
+  uint8_t  fromHeading;
+};
+Preplan preplan{false, 0, 0, 0, 0, 0};
+PathRunner::Node preplanNodes[PathRunner::MAX_POINTS];
+
+const unsigned long LIFT_JOB_MS = 2000; // lift_up / lift_down 작업의 리프트 구동 시간
+
+// 구동 가감속: PWM 을 500 듀티/s 로 올리고 내려 헛돌지 않게 출발/정지한다. {0, 0, 100} 이면 예전 계단 구동.
+// 순항 PWM 은 설정값(73/63) 그대로 (100%). 올리면 속도가 듀티에 비례한다고 보고 한 칸/90도 시간을
+// 줄이는데, 그 비례는 아직 재지 않았다. 실측(calib 작업) 뒤에 올린다.
+const gridMove::Profile DRIVE_PROFILE{500, 500, 100};
+
+// 바퀴 엔코더: 직진/회전을 틱 수로 끝내고 좌우 틱 차이로 방향을 잡는다.
+// 좌우 1틱 차이당 PWM 4 보정, 예상 시간의 150% 가 지나도 못 가면 안전장치로 멈춘다.
+// 한 칸/90도 틱 수는 차체마다 재어야 하므로 부팅 기본은 0 (시간으로 끝냄) 이고,
+// calticks_ 로 넣어 EEPROM 에 저장한 값이 있을 때만 calib.load() 가 켠다.
+const gridMove::Odometry ODOMETRY{0, 0, 64, 150};
+
+// 상자 집기 단계 겹치기: 회전/전진 중 미리 올림, 상자가 뜨면 후진 시작, 선반을 벗어나면 후진 중 내림.
+// 리프트 쪽 겹침은 초음파로 잰 높이로 판단한다. 아래 높이/위치 여유를 실제 선반과 리프트에서 재어
+// 맞추기 전에는 켜지 않는다 (false = 한 단계씩, 포크가 선반에 닿을 일이 없다).
+const bool BOX_PIPELINED = false;
+const BoxGetter::Config BOX_CONFIG{
+  BOX_PIPELINED,
+  LIFT_JOB_MS,
+  600,   // 미리 올림 상한 [ms]
+  1200,  // 상자가 뜨기까지의 예상 올림 시간 [ms] (예상 사이클 계산용)
+  60,    // 후진 60% 지점에서 선반을 벗어난다
+  22,    // 선반 밑 통과 높이 [mm] (미리 올림은 여기서 멈춘다)
+  30     // 상자가 바닥에서 뜨는 높이 [mm] (이 위에서 후진 시작)
+};
+
+// --- 상자 접근 방향 ---
+// boxSides[y][x] : 그 칸의 상자를 어느 쪽 이웃 칸에서 집을 수 있는지 (bit = 1 << gridMove::Direction).
+// 예) DOWN 비트 = 아래 칸에서 위(UP)를 보고 집는다. 기본은 네 방향 모두 (boxsides_ 명령으로 바꾼다).
+// pick 작업은 허용된 쪽 중 (이동 + 회전) 시간이 가장 짧은 접근 칸/방향을 골라 그 방향으로 도착한다.
+const uint8_t SIDE_ALL = 0x0F;
+uint8_t boxSides[5][5];
+
+struct PickPlan {
+  bool    driving;  // 접근 칸으로 가는 중 (false = BoxGetter 실행 중)
+  int8_t  x, y;     // 접근 칸
+  uint8_t facing;   // 접근 칸에서 상자를 보는 방향
+};
+PickPlan pickPlan{false, 0, 0, 0};
+
+// --- 여러 정류장 미션 ---
+// mission_X_Y[a].X_Y[a]... (웹 좌표, a = p: 그 칸의 상자 집기(pick) / d: 내려놓기(lift_down) / 없음: 들르기만)
+// 출발 전에 이동 시간 기준으로 방문 순서를 정하고(tourPlanner), 구간별 작업을 큐에 이어서 넣는다.
+// 내려놓기는 요청에서 앞서 적은 집기들 뒤로만 옮겨진다.
+enum class StopAction : uint8_t { Visit, Pick, Drop };
+
+struct MissionLeg {
+  int8_t     x, y;
+  StopAction action;
+  uint16_t   moveJob;   // 이 구간의 move 작업 id (0 = 이미 그 칸)
+  uint16_t   lastJob;   // 이 구간의 마지막 작업 id (0 = 작업 없음)
+  uint32_t   plannedMs; // 이동 + 동작 예상 시간
+  uint32_t   actualMs;
+  bool       ok;
+};
+
+struct Mission {
+  bool     active;
+  bool     failed;
+  uint8_t  n;
+  uint8_t  pushed;     // 작업 큐에 넣은 구간 수
+  uint8_t  finished;   // 끝난 구간 수
+  int8_t   atX, atY;   // 마지막으로 넣은 구간이 끝나는 칸 (-1 = pick 뒤라 모름)
+  uint32_t plannedMs;
+  uint32_t startMs;
+  uint32_t lastEndMs;  // 직전 구간이 끝난 시각
+};
+MissionLeg missionLegs[TOUR_MAX_STOPS];
+Mission mission{false, false, 0, 0, 0, 0, 0, 0, 0, 0};
+
+// --- UDP 원격 조종 (선택) ---
+// HTTP 보다 지연이 짧은 이진 패킷 채널. 쓰지 않으면 USE_UDP_TELEOP 을 false 로.
+const bool     USE_UDP_TELEOP = true;
+const uint16_t TELEOP_PORT    = 4210;
+UdpTeleop teleop;
+
+// 원격 조종으로 시작한 한 칸 이동/회전. 끝나면 도착 칸을 현재 위치로 삼는다.
+struct TeleopMove {
+  bool   active;
+  int8_t x, y;
+};
+TeleopMove teleopMove{false, 0, 0};
+
+// --- 작업 스케줄러 ---
+// 모듈마다 update 를 한 번씩만 돌린다 (setup 에서 등록, loop 는 tick 만).
+// tick 한 번에 4ms 를 넘게 쓰면 Critical 이 아닌 남은 작업은 다음 tick 으로 미룬다.
+const uint32_t TICK_BUDGET_US   = 4000;
+const uint32_t OVERRUN_REPORT_MS = 5000;  // 마감/예산 초과가 늘었으면 이 주기로 Serial 에 알림
+Scheduler sched(TICK_BUDGET_US);
+
+// --- 이벤트 기록 ---
+// 제어 경로의 로그는 Telemetry 링에 숫자로만 남기고 GET /log 로 받아 host/scvlog 로 본다.
+// true 면 기록마다 Serial 에도 한 줄씩 낸다 (연결해서 볼 때만; 출력하는 동안 loop 가 멈춘다).
+const bool TELEMETRY_TO_SERIAL = false;
+const uint8_t LOG_CHUNK_RECORDS = 8;  // /log 응답을 이만큼씩 모아 보낸다
+
+// 상태 스트림 프레임 내용 (setup 앞에 두어야 Arduino 자동 함수 원형에서 보인다)
+struct StatusSnapshot {
+  int8_t   x, y;
+  uint8_t  heading;
+  uint16_t segment;
+  uint8_t  lift;
+  uint8_t  box;
+  uint16_t job;
+  uint8_t  pending;
+};
+
 void setup() {
   Serial.begin(115200);
-  
+  if (TELEMETRY_TO_SERIAL) telemetry.setMirror(&Serial);
+
   robotLift.begin();
+  gridMap.load(grid);
+  memset(boxSides, SIDE_ALL, sizeof(boxSides));
+  boxGetter.setConfig(BOX_CONFIG);
+  mover.setProfile(DRIVE_PROFILE);
+  mover.setOdometry(ODOMETRY);
+  if (calib.load()) Serial.println("Motion calibration loaded from EEPROM.");
+  registerTasks();
+  runner.setMergeStraight(true); // 직선 구간은 멈추지 않고 한 번에 이동
+  routes.build(gridMap);
   Serial.println("Movement System Initialized.");
 
   while (status != WL_CONNECTED) {
@@ -61,19 +243,68 @@ void setup() {
   }
 
   server.begin();
+  if (USE_UDP_TELEOP) teleop.begin(TELEOP_PORT);
   IPAddress ip = WiFi.localIP();
   Serial.println("\n>>> 와이파이 연결 및 서버 시작 완료! <<<");
   Serial.print("서버 주소: http://");
   Serial.println(ip);
   Serial.println("---------------------------------");
-  Serial.println("Robot is at initial position (" + String(currentX) + ", " + String(currentY) + ")");
+  Serial.print("Robot is at initial position (");
+  Serial.print(currentX);
+  Serial.print(", ");
+  Serial.print(currentY);
+  Serial.println(")");
+  TLOG_INFO(Telemetry::Event::Boot, 0, currentX, currentY);
 }
 
 void loop() {
-  runner.update();
-  robotLift.update();
-  boxGetter.update();
+  sched.tick();
+}
+
+// =================================================================
+// 스케줄러 작업
+// =================================================================
+void taskMover()  { mover.update(); }
+void taskLift()   { robotLift.update(); }
+void taskRunner() { runner.update(); }
+void taskBox()    { boxGetter.update(); }
+void taskCalib()  { calib.update(); }
+
+// 작업마다 (주기, 마감, 예산) [us]. 주기 0 = 매 tick, 마감은 직전 실행부터 잰다.
+// 순서: 조종 명령 → 모터/리프트 → 그 결과를 읽는 상위 모듈 → 작업 큐 → 통신.
+void registerTasks() {
+  typedef Scheduler::Priority P;
+  // 조종 명령이 모터에 닿기까지 한 tick 을 기다리지 않도록 맨 앞에서
+  sched.add("teleop",  serviceTeleop,   0,     2000,  1000,  P::Critical);
+  sched.add("mover",   taskMover,       0,     2000,  500,   P::Critical); // 가감속 갱신, 동작 종료
+  sched.add("lift",    taskLift,        0,     1000,  500,   P::Critical); // 스텝 펄스 (최대 1000 스텝/s)
+  sched.add("runner",  taskRunner,      0,     5000,  1000,  P::High);
+  sched.add("box",     taskBox,         0,     5000,  500,   P::High);
+  sched.add("pose",    trackPosition,   0,     10000, 200,   P::High);
+  sched.add("calib",   taskCalib,       10000, 0,     500,   P::Normal);
+  sched.add("jobs",    serviceJobs,     0,     10000, 20000, P::Normal); // 경로 계획 포함
+  sched.add("mission", serviceMission,  0,     10000, 20000, P::Normal);
+  sched.add("stream",  serviceStatusStream, 0, 50000, 5000,  P::Low);
+  sched.add("http",    serviceHttp,     0,     50000, 20000, P::Low);
+  sched.add("overrun", reportOverruns,  OVERRUN_REPORT_MS * 1000UL, 0, 0, P::Low);
+}
 
+// 마감/예산 초과가 지난 알림 뒤로 늘었으면 작업별로 기록한다
+void reportOverruns() {
+  static uint32_t reported = 0;
+  const uint32_t total = sched.overruns();
+  if (total == reported) return;
+  reported = total;
+  for (uint8_t i = 0; i < sched.count(); ++i) {
+    const Scheduler::Task& t = sched.task(i);
+    if (t.overruns == 0) continue;
+    TLOG_FAULT(Telemetry::Event::TaskOverrun, i, Telemetry::sat16(t.overruns), 0,
+               (int32_t)t.maxLateUs);
+  }
+}
+
+// 경로/원격 조종 이동이 끝나면 도착 칸을 현재 위치로 삼는다
+void trackPosition() {
   // --- 경로 실행 완료 감지 ---
   static bool pathWasActive = false;
   bool pathIsActive = !runner.isFinished();
@@ -81,90 +312,1076 @@ void loop() {
     // +++ [수정] 경로 완료 시, 저장해둔 목표 좌표로 현재 위치 업데이트 +++
     currentX = pathGoalX;
     currentY = pathGoalY;
-    Serial.println(">>> Path finished. New position: (" + String(currentX) + ", " + String(currentY) + ")");
+    TLOG_INFO(Telemetry::Event::PathFinished, 0, currentX, currentY);
   }
   pathWasActive = pathIsActive;
 
-  // --- 웹 클라이언트 처리 ---
-  WiFiClient client = server.available();
-  if (client) {
-    String request = client.readStringUntil('\r');
-    client.flush();
-
-    int cmd_index = request.indexOf("?cmd=");
-    if (cmd_index != -1) {
-      int end_index = request.indexOf(' ', cmd_index);
-      String command = request.substring(cmd_index + 5, end_index);
-      
-      Serial.print("\nReceived Command: ");
-      Serial.println(command);
-
-      if (runner.isFinished() && !boxGetter.isBusy()) {
-        if (command.startsWith("move_")) {
-          String params = command.substring(5);
-          int separator_index = params.indexOf('_');
-          if (separator_index != -1) {
-            int webX = params.substring(0, separator_index).toInt();
-            int webY = params.substring(separator_index + 1).toInt();
-            int targetGridX = constrain((webX * 5) / 100, 0, 4);
-            int targetGridY = constrain((webY * 5) / 100, 0, 4);
-
-            targetGridY = 4 - targetGridY;
-            moveToGridPosition(targetGridX, targetGridY);
-          }
-        }
-        else if (command == "lift_up") {
-          Serial.println("Action: Lift Up command received.");
-          robotLift.upFor(2000);
-          isLiftUpState = true;
-        }
-        else if (command == "lift_down") {
-          Serial.println("Action: Lift Down command received.");
-          robotLift.downFor(2000);
-          isLiftUpState = false;
-        }
-        else if (command == "box") {
-          Serial.println("Action: 'box' command received. Starting BoxGetter sequence.");
-          boxGetter.startGetBox();
-        }
-        // ... (다른 명령어들도 여기에 추가) ...
-      }
-      
-      if (command == "disconnected") {
-        Serial.println("Action: System Disconnected. Forcing stop.");
-        runner.forceStop();
-        robotLift.stop();
-      }
+  if (teleopMove.active && mover.isIdle()) {
+    currentX = teleopMove.x;
+    currentY = teleopMove.y;
+    teleopMove.active = false;
+  }
+}
+
+// =================================================================
+// HTTP 명령 처리기 (String 없이 고정 버퍼만 사용)
+// =================================================================
+
+// 웹 앱 좌표 "X_Y" (0~100, 아래쪽이 Y=0) → 그리드 좌표. p 는 읽은 만큼 나아간다.
+bool parseWebCell(const char*& p, int& gridX, int& gridY) {
+  uint32_t webX, webY;
+  if (!parseUintPrefix(p, webX) || *p++ != '_' || !parseUintPrefix(p, webY)) return false;
+  gridX = constrain((int)(webX * 5) / 100, 0, 4);
+  gridY = 4 - constrain((int)(webY * 5) / 100, 0, 4);
+  return true;
+}
+
+bool parseWebTarget(const char* params, int& gridX, int& gridY) {
+  return parseWebCell(params, gridX, gridY);
+}
+
+// 작업 명령은 큐에 넣고 작업 id 를 돌려준다 (큐가 가득 차면 0)
+void replyJob(uint16_t jobId, HttpReply& reply) {
+  reply.appendUint(jobId);
+  if (jobId == 0) TLOG_FAULT(Telemetry::Event::JobRejected);
+  serviceJobs(); // 놀고 있었다면 바로 시작
+}
+
+void cmdMove(const char* arg, HttpReply& reply) {
+  int targetGridX, targetGridY;
+  if (parseWebTarget(arg, targetGridX, targetGridY)) {
+    replyJob(jobs.push(JobQueue::Type::Move, targetGridX, targetGridY), reply);
+  }
+}
+void cmdLiftUp(const char*, HttpReply& reply)   { replyJob(jobs.push(JobQueue::Type::LiftUp), reply); }
+void cmdLiftDown(const char*, HttpReply& reply) { replyJob(jobs.push(JobQueue::Type::LiftDown), reply); }
+void cmdBox(const char*, HttpReply& reply)      { replyJob(jobs.push(JobQueue::Type::Box), reply); }
+
+// pick_X_Y : (X, Y) 칸의 상자를 가장 빠른 허용 방향에서 집는다
+void cmdPick(const char* arg, HttpReply& reply) {
+  int boxX, boxY;
+  if (parseWebTarget(arg, boxX, boxY)) replyJob(jobs.push(JobQueue::Type::Pick, boxX, boxY), reply);
+}
+
+// boxsides_X_Y_udlr : 상자를 집을 수 있는 쪽 (u/d/l/r 중 허용할 글자, 비우면 모두)
+void cmdBoxSides(const char* arg, HttpReply& reply) {
+  const char* p = arg;
+  int boxX, boxY;
+  if (!parseWebCell(p, boxX, boxY)) return;
+  uint8_t sides = 0;
+  if (*p == '_') {
+    for (++p; *p != '\0'; ++p) {
+      if (*p == 'u')      sides |= 1u << (uint8_t)gridMove::Direction::UP;
+      else if (*p == 'd') sides |= 1u << (uint8_t)gridMove::Direction::DOWN;
+      else if (*p == 'l') sides |= 1u << (uint8_t)gridMove::Direction::LEFT;
+      else if (*p == 'r') sides |= 1u << (uint8_t)gridMove::Direction::RIGHT;
+      else return;
+    }
+  }
+  boxSides[boxY][boxX] = sides ? sides : SIDE_ALL;
+  reply.append("1");
+}
+
+// 구동 보정: calib 은 작업으로 자동 보정 (앞 한 칸, 제자리 회전 공간 필요).
+// calfix_f_P / calfix_r_P : 한 칸/90도 동작이 실제로 간 비율 P[%] 를 넣어 고친다.
+// calticks_C_R : 잰 엔코더 틱 수 (한 칸 C, 90도 R, 바퀴 하나 기준) 를 넣어 저장하고 엔코더 종료를 켠다.
+// calinfo : "전진ms_후진ms_회전ms_한칸틱_90도틱", calreset : 저장값 삭제 (다음 부팅부터 기본값)
+void cmdCalib(const char*, HttpReply& reply) { replyJob(jobs.push(JobQueue::Type::Calibrate), reply); }
+
+void cmdCalFix(const char* arg, HttpReply& reply) {
+  const char kind = arg[0];
+  const char* p = arg + 1;
+  uint32_t pct;
+  if (*p++ != '_' || !parseUintPrefix(p, pct) || pct > 0xFFFF) return;
+  const bool idle = jobs.pending() == 0 && runner.isFinished() && mover.isIdle();
+  reply.append(idle && calib.scale(kind, (uint16_t)pct) ? "1" : "0");
+}
+
+void cmdCalTicks(const char* arg, HttpReply& reply) {
+  const char* p = arg;
+  uint32_t cell, r90;
+  if (!parseUintPrefix(p, cell) || *p++ != '_' || !parseUintPrefix(p, r90)) return;
+  if (cell > 0xFFFF || r90 > 0xFFFF) return;
+  const bool idle = jobs.pending() == 0 && runner.isFinished() && mover.isIdle();
+  reply.append(idle && calib.setTicks((uint16_t)cell, (uint16_t)r90) ? "1" : "0");
+}
+
+void cmdCalInfo(const char*, HttpReply& reply) {
+  const MotionCalib::Params p = MotionCalib::capture(mover);
+  reply.appendUint(p.forwardMs);
+  reply.append("_");
+  reply.appendUint(p.backwardMs);
+  reply.append("_");
+  reply.appendUint(p.rotateMs);
+  reply.append("_");
+  reply.appendUint(p.ticksPerCell);
+  reply.append("_");
+  reply.appendUint(p.ticksPer90);
+}
+
+void cmdCalReset(const char*, HttpReply& reply) {
+  calib.erase();
+  reply.append("1");
+}
+
+// 작업 상태 조회: queued / running / done / failed / unknown
+void cmdJob(const char* arg, HttpReply& reply) {
+  uint32_t id;
+  if (parseUintPrefix(arg, id)) reply.append(JobQueue::statusName(jobs.status((uint16_t)id)));
+}
+
+void cmdDisconnected(const char*, HttpReply&) {
+  TLOG_FAULT(Telemetry::Event::EmergencyStop, 0);
+  stopAll();
+}
+
+// 지도 변경: 주행 중이어도 받는다
+void cmdCell(const char* arg, HttpReply& reply, bool blocked) {
+  int cellX, cellY;
+  if (parseWebTarget(arg, cellX, cellY)) reply.append(setCell(cellX, cellY, blocked) ? "1" : "0");
+}
+void cmdBlock(const char* arg, HttpReply& reply) { cmdCell(arg, reply, true); }
+void cmdFree(const char* arg, HttpReply& reply)  { cmdCell(arg, reply, false); }
+
+// hold_X_Y_FROM_TO : 다른 로봇이 (X, Y) 칸을 지금부터 FROM~TO ms 사이에 쓴다 (이후 계획하는 move 가 피한다)
+// TO 가 HOLD_MAX_MS 를 넘으면 받지 않는다.
+void cmdHold(const char* arg, HttpReply& reply) {
+  const char* p = arg;
+  int cellX, cellY;
+  uint32_t fromMs, toMs;
+  if (!parseWebCell(p, cellX, cellY) || *p++ != '_' || !parseUintPrefix(p, fromMs) ||
+      *p++ != '_' || !parseUintPrefix(p, toMs) || toMs <= fromMs || toMs > HOLD_MAX_MS) return;
+  sharingFloor(); // 표의 원점을 지금으로 (시간창은 지금 기준 상대 시각)
+  const bool ok = holds.reserve(HOLD_AGENT, (uint16_t)(cellY * gridMap.WIDTH + cellX),
+                                fromMs > HOLD_MARGIN_MS ? fromMs - HOLD_MARGIN_MS : 0, toMs + HOLD_MARGIN_MS);
+  reply.append(ok ? "1" : "0");
+}
+
+void cmdUnhold(const char*, HttpReply& reply) {
+  holds.clear();
+  reply.append("1");
+}
+
+// 이동 중에도 답할 수 있는 조회: 현재 위치에서 목표까지 도달 가능 여부
+void cmdReach(const char* arg, HttpReply& reply) {
+  int targetGridX, targetGridY;
+  if (parseWebTarget(arg, targetGridX, targetGridY)) {
+    reply.append(routes.reachable(currentX, currentY, targetGridX, targetGridY) ? "1" : "0");
+  }
+}
+
+// 여러 정류장 미션. 응답: "구간 수_예상 시간(ms)", 받을 수 없으면 "0".
+// 작업 큐가 비어 있을 때만 받는다 (출발 상태를 알아야 순서를 정할 수 있다).
+void cmdMission(const char* arg, HttpReply& reply) {
+  MissionLeg stops[TOUR_MAX_STOPS];
+  uint8_t n = 0;
+  const char* p = arg;
+  bool ok = !mission.active && jobs.pending() == 0 && runner.isFinished() && !teleopMove.active;
+  while (ok && *p != '\0') {
+    int gx, gy;
+    if (n >= TOUR_MAX_STOPS || !parseWebCell(p, gx, gy)) { ok = false; break; }
+    StopAction action = StopAction::Visit;
+    if (*p == 'p')      { action = StopAction::Pick; p++; }
+    else if (*p == 'd') { action = StopAction::Drop; p++; }
+    stops[n++] = MissionLeg{(int8_t)gx, (int8_t)gy, action, 0, 0, 0, 0, false};
+    if (*p == '.') p++;
+    else if (*p != '\0') ok = false;
+  }
+  if (!ok || n == 0 || !planMission(stops, n)) {
+    TLOG_FAULT(Telemetry::Event::MissionRejected, n);
+    reply.append("0");
+    return;
+  }
+  reply.appendUint(mission.n);
+  reply.append("_");
+  reply.appendUint(mission.plannedMs);
+  serviceMission();
+  serviceJobs();
+}
+
+// 미션 구간 조회 (1부터, 방문 순서): "x_y_예상ms_실제ms" (그리드 좌표, 안 끝났으면 실제 0)
+void cmdLeg(const char* arg, HttpReply& reply) {
+  uint32_t k;
+  if (!parseUintPrefix(arg, k) || k == 0 || k > mission.n) return;
+  const MissionLeg& leg = missionLegs[k - 1];
+  reply.appendUint((uint32_t)leg.x);
+  reply.append("_");
+  reply.appendUint((uint32_t)leg.y);
+  reply.append("_");
+  reply.appendUint(leg.plannedMs);
+  reply.append("_");
+  reply.appendUint(leg.actualMs);
+}
+
+// 이름이 '_' 로 끝나면 접두사 명령 (move_50_50 등)
+const HttpCommand HTTP_COMMANDS[] = {
+  {"move_",        cmdMove},
+  {"lift_up",      cmdLiftUp},
+  {"lift_down",    cmdLiftDown},
+  {"box",          cmdBox},
+  {"pick_",        cmdPick},
+  {"boxsides_",    cmdBoxSides},
+  {"job_",         cmdJob},
+  {"disconnected", cmdDisconnected},
+  {"block_",       cmdBlock},
+  {"free_",        cmdFree},
+  {"reach_",       cmdReach},
+  {"hold_",        cmdHold},
+  {"unhold",       cmdUnhold},
+  {"mission_",     cmdMission},
+  {"leg_",         cmdLeg},
+  {"calib",        cmdCalib},
+  {"calfix_",      cmdCalFix},
+  {"calticks_",    cmdCalTicks},
+  {"calinfo",      cmdCalInfo},
+  {"calreset",     cmdCalReset},
+  // ... (다른 명령어들도 여기에 추가) ...
+};
+
+// =================================================================
+// 상태 스트림 (WebSocket /ws)
+// - 상태가 바뀌면 최대 STATUS_MIN_MS 간격으로, 바뀌지 않아도 STATUS_KEEPALIVE_MS 마다
+//   {"x":0,"y":4,"h":3,"seg":0,"lift":0,"box":0,"job":0,"q":0} 프레임을 보낸다.
+//   h: gridMove::Direction (0=UP 1=DOWN 2=LEFT 3=RIGHT), lift: Lift::LiftState,
+//   box: BoxGetter::State, job: 실행 중 작업 id, q: 대기+실행 중 작업 수
+// - 같은 연결로 받은 텍스트 메시지는 ?cmd= 와 같은 명령으로 처리하고
+//   {"cmd":"...","r":"..."} 로 답한다.
+// =================================================================
+const uint32_t STATUS_MIN_MS       = 20;
+const uint32_t STATUS_KEEPALIVE_MS = 1000;
+
+WsSession statusStream;
+uint32_t  lastStatusMs = 0;
+
+StatusSnapshot lastStatus{-1, -1, 0, 0, 0, 0, 0, 0};
+
+StatusSnapshot takeStatus() {
+  StatusSnapshot st{(int8_t)currentX, (int8_t)currentY, (uint8_t)mover.getDirection(),
+                    runner.segmentIndex(), (uint8_t)robotLift.getState(),
+                    (uint8_t)boxGetter.state(), 0, jobs.pending()};
+  if (!runner.isFinished()) { // 주행 중에는 마지막으로 도착한 칸
+    const PathRunner::Node& at = runner.node(runner.segmentIndex());
+    st.x = (int8_t)at.x;
+    st.y = (int8_t)at.y;
+  }
+  if (JobQueue::Job* job = jobs.running()) st.job = job->id;
+  return st;
+}
+
+// s 를 JSON 문자열 값으로 buf[n..] 에 붙이고 새 길이를 돌려준다 (limit 바이트 전에서 멈춤, NUL 포함).
+// " 와 \ 는 앞에 \, 제어 문자는 \u00XX. 자리가 모자라면 이스케이프 중간에서 자르지 않는다.
+size_t appendJsonString(char* buf, size_t n, size_t limit, const char* s) {
+  for (; *s != '\0'; ++s) {
+    const uint8_t ch = (uint8_t)*s;
+    char esc[7];
+    size_t k = 1;
+    if (ch == '"' || ch == '\\') { esc[0] = '\\'; esc[1] = (char)ch; k = 2; }
+    else if (ch < 0x20)          k = (size_t)snprintf(esc, sizeof(esc), "\\u%04x", ch);
+    else                         esc[0] = (char)ch;
+    if (n + k >= limit) break;
+    for (size_t i = 0; i < k; ++i) buf[n++] = esc[i];
+  }
+  buf[n] = '\0';
+  return n;
+}
+
+bool sameStatus(const StatusSnapshot& a, const StatusSnapshot& b) {
+  return a.x == b.x && a.y == b.y && a.heading == b.heading && a.segment == b.segment &&
+         a.lift == b.lift && a.box == b.box && a.job == b.job && a.pending == b.pending;
+}
+
+void serviceStatusStream() {
+  if (!statusStream.active()) return;
+
+  const char* msg;
+  while (statusStream.poll(msg)) {
+    HttpReply reply;
+    reply.clear();
+    logCommand(1, msg);
+    dispatchHttpCommand(HTTP_COMMANDS, sizeof(HTTP_COMMANDS) / sizeof(HTTP_COMMANDS[0]), msg, reply);
+    // 명령/응답 글은 이스케이프해 넣는다 (" \ 제어 문자가 있어도 JSON 이 깨지지 않게).
+    // 응답과 닫는 글자 자리는 남겨 두므로 잘려도 항상 온전한 JSON 이다.
+    char frame[WsSession::MSG_MAX + HttpReply::MAX + 20];
+    memcpy(frame, "{\"cmd\":\"", 8);
+    size_t n = appendJsonString(frame, 8, sizeof(frame) - HttpReply::MAX - 10, msg);
+    memcpy(frame + n, "\",\"r\":\"", 7);
+    n = appendJsonString(frame, n + 7, sizeof(frame) - 3, reply.c_str());
+    memcpy(frame + n, "\"}", 3);
+    statusStream.sendText(frame, n + 2);
+  }
+
+  const StatusSnapshot st = takeStatus();
+  const uint32_t since = millis() - lastStatusMs;
+  const bool changed = !sameStatus(st, lastStatus);
+  if ((changed && since >= STATUS_MIN_MS) || since >= STATUS_KEEPALIVE_MS) {
+    char frame[96];
+    const int n = snprintf(frame, sizeof(frame),
+                           "{\"x\":%d,\"y\":%d,\"h\":%u,\"seg\":%u,\"lift\":%u,\"box\":%u,\"job\":%u,\"q\":%u}",
+                           st.x, st.y, st.heading, st.segment, st.lift, st.box, st.job, st.pending);
+    statusStream.sendText(frame, (size_t)n);
+    lastStatus = st;
+    lastStatusMs = millis();
+  }
+}
+
+// 연결 하나를 여러 loop() 에 걸쳐 처리한다. 한 번에 읽는 양은 HTTP_READ_BUDGET 바이트로 제한하고
+// HTTP_TIMEOUT_MS 안에 요청이 끝나지 않으면 끊는다. 모터/리프트 update 는 느린 클라이언트를 기다리지 않는다.
+const uint8_t  HTTP_READ_BUDGET = 64;
+const uint32_t HTTP_TIMEOUT_MS  = 2000;
+
+WiFiClient httpClient;
+HttpParser httpParser;
+uint32_t   httpStartMs = 0;
+
+void serviceHttp() {
+  if (!httpClient) {
+    httpClient = server.available();
+    if (!httpClient) return;
+    if (statusStream.owns(httpClient)) { // 스트림 연결은 serviceStatusStream 이 읽는다
+      httpClient = WiFiClient();
+      return;
+    }
+    httpParser.reset();
+    httpStartMs = millis();
+  }
+
+  HttpParser::Result res = httpParser.result();
+  for (uint8_t n = 0; n < HTTP_READ_BUDGET && res == HttpParser::Result::NeedMore && httpClient.available() > 0; ++n) {
+    res = httpParser.feed((char)httpClient.read());
+  }
+
+  if (res == HttpParser::Result::NeedMore) {
+    if (httpClient.connected() && millis() - httpStartMs < HTTP_TIMEOUT_MS) return; // 다음 loop 에 이어서
+    httpClient.stop();
+    return;
+  }
+
+  if (res == HttpParser::Result::Error) {
+    httpClient.print("HTTP/1.1 400 Bad Request\r\nConnection: close\r\n\r\n");
+    httpClient.stop();
+    return;
+  }
+
+  // GET /ws (Upgrade: websocket) → 상태 스트림으로 전환. 연결은 statusStream 이 넘겨받는다.
+  if (httpParser.pathIs("/ws") && httpParser.webSocketKey()[0] != '\0') {
+    if (statusStream.accept(httpClient, httpParser.webSocketKey())) {
+      TLOG_INFO(Telemetry::Event::StreamOpened);
+      lastStatusMs = millis() - STATUS_KEEPALIVE_MS; // 바로 첫 상태 전송
+    } else {
+      httpClient.stop();
+    }
+    httpClient = WiFiClient();
+    return;
+  }
+
+  // GET /stats → 타이밍 통계 JSON. /stats?cmd=reset 이면 보낸 뒤 0 으로 되돌린다.
+  if (httpParser.pathIs("/stats")) {
+    httpClient.print("HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nConnection: close\r\n\r\n");
+    printStats(httpClient);
+    if (strcmp(httpParser.command(), "reset") == 0) resetStats();
+    httpClient.stop();
+    return;
+  }
+
+  // GET /log → 이벤트 기록 (이진, host/scvlog 로 푼다). /log?cmd=clear 이면 보낸 뒤 비운다.
+  if (httpParser.pathIs("/log")) {
+    httpClient.print("HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nConnection: close\r\n\r\n");
+    sendLog(httpClient);
+    if (strcmp(httpParser.command(), "clear") == 0) telemetry.clear();
+    httpClient.stop();
+    return;
+  }
+
+  HttpReply reply; // 응답 본문 (필요한 명령만 채움)
+  reply.clear();
+  const char* command = httpParser.command();
+  if (command[0] != '\0') {
+    logCommand(0, command);
+    dispatchHttpCommand(HTTP_COMMANDS, sizeof(HTTP_COMMANDS) / sizeof(HTTP_COMMANDS[0]), command, reply);
+  }
+
+  httpClient.print("HTTP/1.1 200 OK\r\nConnection: close\r\n\r\n");
+  if (reply.length() > 0) httpClient.print(reply.c_str());
+  httpClient.stop();
+}
+
+// =================================================================
+// 타이밍 통계 (/stats)
+// {"ticks":N,"loopUs":{h},"tasks":[{"name":"mover","runs":N,"over":N,"skip":N,"defer":N,"late":us,"runUs":{h}},...],
+//  "drive":{"late":N,"odoTimeouts":N,"endLateMs":{h}},"lift":{"echoTimeouts":N,"stepLateUs":{h}}}
+// {h} = {"n":N,"min":v,"p50":v,"p90":v,"p99":v,"max":v}. 백분위는 2진 로그 칸의 상한이다.
+// 무선 모듈로 작게 여러 번 쓰지 않도록 작업 하나씩 모아서 보낸다.
+// =================================================================
+int formatHist(char* buf, size_t size, const char* key, const Histogram& h) {
+  return snprintf(buf, size, "\"%s\":{\"n\":%lu,\"min\":%lu,\"p50\":%lu,\"p90\":%lu,\"p99\":%lu,\"max\":%lu}",
+                  key, (unsigned long)h.count(), (unsigned long)h.min(), (unsigned long)h.percentile(50),
+                  (unsigned long)h.percentile(90), (unsigned long)h.percentile(99), (unsigned long)h.max());
+}
+
+void printStats(Print& out) {
+  char line[192];
+  int n = snprintf(line, sizeof(line), "{\"ticks\":%lu,", (unsigned long)sched.ticks());
+  formatHist(line + n, sizeof(line) - n, "loopUs", sched.loopUs());
+  out.print(line);
+  out.print(",\"tasks\":[");
+  for (uint8_t i = 0; i < sched.count(); ++i) {
+    const Scheduler::Task& t = sched.task(i);
+    n = snprintf(line, sizeof(line), "%s{\"name\":\"%s\",\"runs\":%lu,\"over\":%lu,\"skip\":%lu,\"defer\":%lu,\"late\":%lu,",
+                 i ? "," : "", t.name, (unsigned long)t.runs, (unsigned long)t.overruns, (unsigned long)t.skipped,
+                 (unsigned long)t.deferred, (unsigned long)t.maxLateUs);
+    n += formatHist(line + n, sizeof(line) - n, "runUs", t.runUs);
+    if (n < (int)sizeof(line) - 1) { line[n] = '}'; line[n + 1] = '\0'; }
+    out.print(line);
+  }
+  n = snprintf(line, sizeof(line), "],\"drive\":{\"late\":%u,\"odoTimeouts\":%u,",
+               mover.lateActions(), mover.odometryTimeouts());
+  formatHist(line + n, sizeof(line) - n, "endLateMs", mover.endLateMs());
+  out.print(line);
+  n = snprintf(line, sizeof(line), "},\"lift\":{\"echoTimeouts\":%u,", robotLift.echoTimeouts());
+  formatHist(line + n, sizeof(line) - n, "stepLateUs", robotLift.stepLateUs());
+  out.print(line);
+  out.print("}}");
+}
+
+void resetStats() {
+  sched.resetStats();
+  mover.resetTiming();
+  robotLift.resetTiming();
+}
+
+// =================================================================
+// 이벤트 기록 (/log)
+// =================================================================
+
+// 받은 명령: 길이와 앞 4글자만 남긴다 (source 0 = HTTP, 1 = WebSocket)
+void logCommand(uint8_t source, const char* cmd) {
+  const size_t len = strlen(cmd);
+  uint32_t head = 0;
+  for (uint8_t i = 0; i < 4 && i < len; ++i) head |= (uint32_t)(uint8_t)cmd[i] << (8 * i);
+  TLOG_INFO(Telemetry::Event::Command, source, Telemetry::sat16(len), 0, (int32_t)head);
+}
+
+// [헤더][기록 × count], 오래된 기록부터
+void sendLog(Print& out) {
+  uint8_t buf[Telemetry::RECORD_BYTES * LOG_CHUNK_RECORDS];
+  telemetry.packHeader(buf);
+  out.write(buf, Telemetry::HEADER_BYTES);
+  uint8_t k = 0;
+  for (uint16_t i = 0; i < telemetry.size(); ++i) {
+    Telemetry::pack(telemetry.at(i), buf + Telemetry::RECORD_BYTES * k);
+    if (++k == LOG_CHUNK_RECORDS) {
+      out.write(buf, sizeof(buf));
+      k = 0;
     }
+  }
+  if (k) out.write(buf, Telemetry::RECORD_BYTES * k);
+}
 
-    client.println("HTTP/1.1 200 OK");
-    client.println("Connection: close");
-    client.println();
-    delay(1);
-    client.stop();
+// =================================================================
+// UDP 원격 조종
+// - 한 칸 이동/회전은 작업 큐와 경로 실행이 모두 비어 있을 때만 받는다 (아니면 Busy).
+// - Stop 과 heartbeat 끊김은 cmdDisconnected 와 같이 모두 멈춘다.
+// =================================================================
+UdpTeleop::Ack runTeleop(const UdpTeleop::Command& cmd) {
+  const bool busy = jobs.pending() > 0 || !runner.isFinished() || !mover.isIdle() || boxGetter.isBusy();
+  switch (cmd.op) {
+    case UdpTeleop::Op::Stop:
+      TLOG_INFO(Telemetry::Event::EmergencyStop, 1);
+      stopAll();
+      return UdpTeleop::Ack::Ok;
+
+    case UdpTeleop::Op::Step: {
+      if (busy) return UdpTeleop::Ack::Busy;
+      static const int8_t HX[4] = {0, 0, -1, 1}; // UP, DOWN, LEFT, RIGHT
+      static const int8_t HY[4] = {1, -1, 0, 0};
+      const uint8_t h = (uint8_t)mover.getDirection();
+      const int sign = cmd.arg ? -1 : 1;
+      const int nx = currentX + sign * HX[h], ny = currentY + sign * HY[h];
+      if (!gridMap.inBounds(nx, ny) || gridMap.blocked(nx, ny)) return UdpTeleop::Ack::Refused;
+      if (cmd.arg) mover.startBackward();
+      else         mover.startForward();
+      teleopMove = TeleopMove{true, (int8_t)nx, (int8_t)ny};
+      return UdpTeleop::Ack::Ok;
+    }
+
+    case UdpTeleop::Op::Rotate:
+      if (busy) return UdpTeleop::Ack::Busy;
+      if (cmd.arg) mover.startRotateCCW();
+      else         mover.startRotateCW();
+      teleopMove = TeleopMove{true, (int8_t)currentX, (int8_t)currentY};
+      return UdpTeleop::Ack::Ok;
+
+    case UdpTeleop::Op::LiftUp:
+    case UdpTeleop::Op::LiftDown: {
+      if (jobs.pending() > 0) return UdpTeleop::Ack::Busy;
+      const unsigned long ms = cmd.arg ? cmd.arg : LIFT_JOB_MS;
+      isLiftUpState = (cmd.op == UdpTeleop::Op::LiftUp);
+      if (isLiftUpState) robotLift.upFor(ms);
+      else               robotLift.downFor(ms);
+      return UdpTeleop::Ack::Ok;
+    }
+
+    default:
+      return UdpTeleop::Ack::Refused;
   }
 }
 
+void serviceTeleop() {
+  if (!USE_UDP_TELEOP) return;
+
+  UdpTeleop::Command cmd;
+  while (teleop.poll(cmd)) teleop.reply(cmd, runTeleop(cmd));
+
+  if (teleop.timedOut()) {
+    TLOG_FAULT(Telemetry::Event::EmergencyStop, 2);
+    stopAll();
+  }
+}
+
+// 비상 정지: 경로/리프트를 멈추고 대기 작업을 모두 취소한다.
+// 주행 중이었다면 마지막으로 도착한 칸을 현재 위치로 남긴다.
+void stopAll() {
+  if (!runner.isFinished()) {
+    const PathRunner::Node& at = runner.node(runner.segmentIndex());
+    pathGoalX = at.x;
+    pathGoalY = at.y;
+  }
+  runner.forceStop();
+  mover.abort(); // 경로 밖 동작 (상자 집기, 원격 조종 한 칸, 보정 주행) 도
+  replanAtStop = false;
+  calib.abort();
+  robotLift.stop();
+  jobs.cancelAll();
+  preplan.valid = false;
+  teleopMove.active = false; // 멈춘 한 칸 이동은 도착으로 치지 않는다
+}
+
+// 지도 칸 변경. 주행 중 남은 경로가 막히면 D* Lite 로 고친 경로를
+// 다음 칸 경계에서 이어 붙여 미션을 멈추지 않고 우회한다.
+// 바닥을 나눠 쓰는 중이면 D* Lite 경로는 남의 시간창을 모르므로 경계 칸에서 멈추고,
+// 멈춘 뒤 그 칸에서 시공간 경로로 다시 계획한다 (replanAtStop, jobFinished).
+// 로봇이 서 있거나 이미 들어서고 있는 칸은 막을 수 없다 (false).
+bool setCell(int x, int y, bool blocked) {
+  if (gridMap.blocked(x, y) == blocked) return true;
+  if (blocked) {
+    if (runner.isFinished()) {
+      if (x == currentX && y == currentY) return false;
+    } else {
+      const int16_t hit = runner.findCell(x, y);
+      if (hit >= 0 && hit <= (int16_t)runner.nextBoundary()) return false;
+    }
+  }
+
+  gridMap.set(x, y, blocked);
+  routes.build(gridMap);
+  preplan.valid = false; // 미리 계획한 경로는 옛 지도 기준
+  TLOG_INFO(Telemetry::Event::MapChanged, blocked, x, y);
+  if (runner.isFinished() || !repair.active()) return true;
+
+  // D* Lite 시작점을 갈아탈 칸 경계로 옮기고 바뀐 칸을 알린다
+  const uint16_t b = runner.nextBoundary();
+  const PathRunner::Node at = runner.node(b);
+  repair.moveStart(at.x, at.y);
+  repair.cellChanged(x, y);
+  if (!blocked || runner.findCell(x, y) < 0) return true; // 남은 경로와 무관
+
+  if (sharingFloor()) {
+    runner.spliceAt(b, &at, 1);
+    pathGoalX = at.x;
+    pathGoalY = at.y;
+    replanAtStop = true;
+    return true;
+  }
+
+  AStarResult result{false, 0};
+  if (repair.compute()) result = repair.path(pathNodes, PathRunner::MAX_POINTS);
+  if (result.ok && runner.spliceAt(b, pathNodes, result.n)) {
+    TLOG_INFO(Telemetry::Event::PathRepaired, (uint8_t)result.n, at.x, at.y, (int32_t)repair.expanded());
+    return true;
+  }
+
+  // 우회로 없음: 경계 칸에서 멈추고 그 칸을 도착점으로 삼는다
+  TLOG_FAULT(Telemetry::Event::NoDetour, 0, at.x, at.y);
+  runner.spliceAt(b, &at, 1);
+  pathGoalX = at.x;
+  pathGoalY = at.y;
+  return true;
+}
+
+// 경로를 따라간 뒤의 방향 (gridMove::Direction 값). 후진 칸은 이동 방향의 반대를 본다.
+uint8_t headingAfter(const PathRunner::Node* nodes, uint16_t n, uint8_t startHeading) {
+  if (n < 2) return startHeading;
+  const int dx = nodes[n - 1].x - nodes[n - 2].x;
+  const int dy = nodes[n - 1].y - nodes[n - 2].y;
+  uint8_t h = (dx > 0) ? 3 : (dx < 0) ? 2 : (dy > 0) ? 0 : 1; // RIGHT, LEFT, UP, DOWN
+  return nodes[n - 1].reverse ? (uint8_t)(h ^ 1) : h;        // UP↔DOWN, LEFT↔RIGHT
+}
+
+// 플래너용 동작 시간 (gridMove 에 설정된 값, 가감속 포함).
+// 혼자 달릴 때 runner 는 직선 구간을 한 번의 가감속으로 합치므로 (run 필드), 구간 안의 한 칸은
+// 순항 시간만 더한다. planSpaceTime 은 run 필드를 쓰지 않는다 (칸마다 멈추는 실행).
+MoveCosts moveCosts() {
+  MoveCosts c{
+    mover.actionMs(gridMove::Action::Forward), mover.actionMs(gridMove::Action::Backward),
+    mover.actionMs(gridMove::Action::RotateCW), runner.dwellMs(), ALLOW_REVERSE
+  };
+  c.forwardRunMs = mover.actionMs(gridMove::Action::Forward, 2) - c.forwardMs;
+  c.backwardRunMs = mover.actionMs(gridMove::Action::Backward, 2) - c.backwardMs;
+  return c;
+}
+
+// 다른 로봇의 시간창이 남아 있는지. holds 의 원점을 지금으로 옮기므로 (지난 것은 지운다)
+// 이 호출 뒤에는 표의 시각 0 이 지금이다.
+bool sharingFloor() {
+  const uint32_t now = millis();
+  holds.advance(now - holdClockMs);
+  holdClockMs = now;
+  return holds.size() > 0;
+}
+
+// (x, y, heading) 에서 (tx, ty) 까지 최소 시간 경로 (goalHeading 을 주면 그 방향으로 도착).
+// 바닥을 나눠 쓰면 지금 출발한다고 보고 남의 시간창을 피하는 시공간 경로 (기다림 포함, 도착 칸은
+// 계속 머문다). 이때 costMs 는 기다림을 포함한 도착까지의 시간이다. 미션 비용처럼 나중에
+// 출발하는 구간도 지금 출발로 본 추정이며, 실제 경로는 작업을 시작할 때 다시 계획한다.
+TimedResult planLeg(int x, int y, uint8_t heading, int tx, int ty, PathRunner::Node* out,
+                    uint8_t goalHeading = TIMED_ANY_HEADING) {
+  if (sharingFloor()) {
+    const SpaceTimeResult st = planSpaceTime(gridMap, holds, 0, x, y, heading, 0, tx, ty, ST_FOREVER,
+                                             moveCosts(), out, PathRunner::MAX_POINTS, stWorkspace, goalHeading);
+    return TimedResult{st.ok, st.n, st.arriveMs, st.endHeading};
+  }
+  return planTimed(gridMap, x, y, heading, tx, ty, moveCosts(), out, PathRunner::MAX_POINTS, goalHeading);
+}
+
+// (fromX, fromY, heading) 에서 목표까지 계획. 성공 시 경로 칸 수, 실패 시 0.
+uint16_t planMove(int fromX, int fromY, uint8_t heading, int targetX, int targetY,
+                  PathRunner::Node* out) {
+  if (USE_ROUTE_TABLE && !sharingFloor()) {
+    AStarResult r = routes.path(fromX, fromY, targetX, targetY, out, PathRunner::MAX_POINTS);
+    if (r.ok) TLOG_INFO(Telemetry::Event::PathPlanned, (uint8_t)r.n, targetX, targetY, 0);
+    return r.ok ? r.n : 0;
+  }
+  if (USE_CELL_PLANNER && !sharingFloor()) {
+    AStarResult r = planPath5x5(CELL_PLANNER, gridMap, fromX, fromY, targetX, targetY, out, PathRunner::MAX_POINTS);
+    if (r.ok) TLOG_INFO(Telemetry::Event::PathPlanned, (uint8_t)r.n, targetX, targetY, 0);
+    return r.ok ? r.n : 0;
+  }
+  // 회전/전진/후진 실제 소요 시간 기준으로 (x, y, heading) 공간에서 최소 시간 경로
+  const TimedResult timed = planLeg(fromX, fromY, heading, targetX, targetY, out);
+  if (timed.ok) TLOG_INFO(Telemetry::Event::PathPlanned, (uint8_t)timed.n, targetX, targetY, (int32_t)timed.costMs);
+  return timed.ok ? timed.n : 0;
+}
+
+// 계획된 경로로 주행 시작
+void startPath(const PathRunner::Node* nodes, uint16_t n, int targetX, int targetY) {
+  // +++ [수정] 경로 실행 전, 목표 좌표를 임시 변수에 저장 +++
+  pathGoalX = targetX;
+  pathGoalY = targetY;
+  runningEndHeading = headingAfter(nodes, n, (uint8_t)mover.getDirection());
+
+  runner.setMergeStraight(!sharingFloor()); // 시공간 경로는 칸마다 계획한 시각대로
+  runner.loadPath(nodes, n);
+  runner.start();
+
+  // 증분 수정용 상태 준비 (지도가 바뀌면 이 결과를 고쳐 쓴다)
+  repair.begin(currentX, currentY, targetX, targetY);
+  repair.compute();
+}
+
 // 그리드 좌표로 이동 계획 및 실행
-void moveToGridPosition(int targetX, int targetY) {
+bool moveToGridPosition(int targetX, int targetY) {
   if (!runner.isFinished()) {
-    Serial.println("Cannot start new move: PathRunner is busy.");
-    return;
+    TLOG_FAULT(Telemetry::Event::RunnerBusy, 0, targetX, targetY);
+    return false;
+  }
+
+  const uint16_t n = planMove(currentX, currentY, (uint8_t)mover.getDirection(), targetX, targetY, pathNodes);
+  if (n == 0) {
+    TLOG_FAULT(Telemetry::Event::PathNotFound, 0, targetX, targetY);
+    return false;
+  }
+  startPath(pathNodes, n, targetX, targetY);
+  return true;
+}
+
+// (x, y, heading) 에서 상자 (bx, by) 를 집을 접근 칸까지의 최소 시간 (회전 포함, 상자를 보고 도착,
+// 바닥을 나눠 쓰면 기다림 포함).
+// side 에 고른 쪽 (gridMove::Direction, 접근 칸 = 상자 + 그 방향), pathNodes 에 그 경로.
+// 허용된 쪽이 모두 막혔거나 갈 수 없으면 TOUR_INF.
+uint32_t approachMs(int x, int y, uint8_t heading, int bx, int by, uint8_t& side) {
+  using namespace astar_timed_detail;
+  uint32_t best = TOUR_INF;
+  for (uint8_t s = 0; s < 4; ++s) {
+    if (!(boxSides[by][bx] & (1u << s))) continue;
+    const int ax = bx + HDX[s], ay = by + HDY[s];
+    if (!gridMap.inBounds(ax, ay) || gridMap.blocked(ax, ay)) continue;
+    const uint8_t facing = (uint8_t)(s ^ 1);
+    uint32_t c;
+    if (ax == x && ay == y) {
+      const uint8_t turns = (heading == TIMED_ANY_HEADING || heading == facing) ? 0
+                          : heading == (uint8_t)(facing ^ 1) ? 2 : 1;
+      c = turns * mover.actionMs(gridMove::Action::RotateCW);
+    } else {
+      const TimedResult r = planLeg(x, y, heading, ax, ay, pathNodes, facing);
+      if (!r.ok) continue;
+      c = r.costMs;
+    }
+    if (c < best) { best = c; side = s; }
+  }
+  return best;
+}
+
+// 바닥을 나눠 쓰는 중이면 상자 칸 (x, y) 이 arriveMs 부터 집기 한 번 동안 비어 있는지.
+// 집기는 그 칸으로 들어갔다 나오므로 남이 쓰는 중에는 시작하지 않는다.
+bool boxCellFree(int x, int y, uint32_t arriveMs) {
+  if (!sharingFloor()) return true;
+  return !holds.busy((uint16_t)(y * gridMap.WIDTH + x), arriveMs,
+                     arriveMs + boxGetter.plannedCycleMs(0), 0);
+}
+
+// pick 작업: 고른 쪽의 접근 칸으로 상자를 보고 도착하도록 계획해 출발 (이미 그 칸이면 바로 집기)
+bool startPick(const JobQueue::Job& job) {
+  uint8_t side = 0;
+  const uint8_t heading = (uint8_t)mover.getDirection();
+  const uint32_t arrive = approachMs(currentX, currentY, heading, job.x, job.y, side);
+  if (arrive == TOUR_INF || !boxCellFree(job.x, job.y, arrive)) {
+    TLOG_FAULT(Telemetry::Event::NoApproach, 0, job.x, job.y);
+    return false;
+  }
+  const int ax = job.x + astar_timed_detail::HDX[side];
+  const int ay = job.y + astar_timed_detail::HDY[side];
+  pickPlan = PickPlan{false, (int8_t)ax, (int8_t)ay, (uint8_t)(side ^ 1)};
+  TLOG_INFO(Telemetry::Event::PickStart, pickPlan.facing, job.x, job.y);
+  if (ax == currentX && ay == currentY) {
+    boxGetter.startGetBox((gridMove::Direction)pickPlan.facing);
+    return true;
+  }
+  const TimedResult r = planLeg(currentX, currentY, heading, ax, ay, pathNodes, pickPlan.facing);
+  if (!r.ok) return false;
+  pickPlan.driving = true;
+  startPath(pathNodes, r.n, ax, ay);
+  return true;
+}
+
+// ---- 작업 큐 처리 ----
+
+// 작업 시작. 바로 실패하면 false.
+bool startJob(const JobQueue::Job& job) {
+  TLOG_INFO(Telemetry::Event::JobStart, (uint8_t)job.type, (int16_t)job.id, job.x, job.y);
+  switch (job.type) {
+    case JobQueue::Type::Move: {
+      const uint8_t heading = (uint8_t)mover.getDirection();
+      if (preplan.valid && preplan.jobId == job.id && preplan.fromX == currentX &&
+          preplan.fromY == currentY && preplan.fromHeading == heading && !sharingFloor()) {
+        preplan.valid = false;
+        startPath(preplanNodes, preplan.n, job.x, job.y); // 미리 계획한 경로: 계획 시간 없이 출발
+        return true;
+      }
+      preplan.valid = false;
+      return moveToGridPosition(job.x, job.y);
+    }
+    case JobQueue::Type::LiftUp:
+      robotLift.upFor(LIFT_JOB_MS);
+      isLiftUpState = true;
+      return true;
+    case JobQueue::Type::LiftDown:
+      robotLift.downFor(LIFT_JOB_MS);
+      isLiftUpState = false;
+      return true;
+    case JobQueue::Type::Box:
+      if (currentY > 0 && !boxCellFree(currentX, currentY - 1, 0)) return false; // 아래 칸 (DOWN 은 -y) 을 남이 쓰는 중
+      boxGetter.startGetBox(gridMove::Direction::DOWN); // 예전 동작: 아래 칸의 상자
+      return true;
+    case JobQueue::Type::Pick:
+      return startPick(job);
+    case JobQueue::Type::Calibrate:
+      return calib.start();
+  }
+  return false;
+}
+
+// 바닥을 나눠 쓰는 중 막혀 경계 칸에 멈췄으면 (tx, ty) 까지 시공간 경로로 다시 출발.
+// 다시 출발했으면 true, 멈춘 이유가 아니거나 경로가 없으면 false (호출자가 도착 여부로 판정).
+bool resumeAfterStop(int tx, int ty, uint8_t goalHeading) {
+  if (!replanAtStop) return false;
+  replanAtStop = false;
+  if (currentX == tx && currentY == ty) return false;
+  const TimedResult r = planLeg(currentX, currentY, (uint8_t)mover.getDirection(), tx, ty, pathNodes, goalHeading);
+  if (!r.ok) {
+    TLOG_FAULT(Telemetry::Event::NoDetour, 0, currentX, currentY);
+    return false;
+  }
+  TLOG_INFO(Telemetry::Event::PathRepaired, (uint8_t)r.n, currentX, currentY, 0);
+  startPath(pathNodes, r.n, tx, ty);
+  return true;
+}
+
+// 실행 중 작업이 끝났는지. 끝났으면 ok 에 성공 여부.
+bool jobFinished(const JobQueue::Job& job, bool& ok) {
+  ok = true;
+  switch (job.type) {
+    case JobQueue::Type::Move:
+      if (!runner.isFinished()) return false;
+      if (resumeAfterStop(job.x, job.y, TIMED_ANY_HEADING)) return false;
+      ok = (currentX == job.x && currentY == job.y); // 우회로 없어 멈췄으면 실패
+      return true;
+    case JobQueue::Type::LiftUp:
+    case JobQueue::Type::LiftDown:
+      return robotLift.getState() == Lift::LiftState::IDLE;
+    case JobQueue::Type::Box:
+      return !boxGetter.isBusy();
+    case JobQueue::Type::Pick:
+      if (pickPlan.driving) {
+        if (!runner.isFinished()) return false;
+        if (resumeAfterStop(pickPlan.x, pickPlan.y, pickPlan.facing)) return false;
+        pickPlan.driving = false;
+        if (currentX != pickPlan.x || currentY != pickPlan.y) { ok = false; return true; } // 우회로 없어 멈춤
+        boxGetter.startGetBox((gridMove::Direction)pickPlan.facing);
+        return false;
+      }
+      return !boxGetter.isBusy();
+    case JobQueue::Type::Calibrate:
+      if (calib.isBusy()) return false;
+      ok = calib.state() == MotionCalib::State::Done;
+      if (ok) reportCalibration();
+      return true;
+  }
+  return true;
+}
+
+// 실행 중 작업이 끝난 뒤의 예상 상태 (칸, 방향)
+void predictedEnd(const JobQueue::Job& job, int& x, int& y, uint8_t& heading) {
+  x = currentX;
+  y = currentY;
+  heading = (uint8_t)mover.getDirection();
+  switch (job.type) {
+    case JobQueue::Type::Move:
+      x = job.x;
+      y = job.y;
+      heading = runningEndHeading;
+      break;
+    case JobQueue::Type::Box:
+      heading = (uint8_t)gridMove::Direction::DOWN; // BoxGetter 는 아래를 보고 끝난다
+      break;
+    case JobQueue::Type::Pick:
+      x = pickPlan.x;
+      y = pickPlan.y;
+      heading = pickPlan.facing; // 접근 칸에서 상자를 본 채로 끝난다
+      break;
+    default:
+      break;
+  }
+}
+
+// 보정 결과 (EEPROM 에 저장된 값, 전체는 calinfo)
+void reportCalibration() {
+  const MotionCalib::Params p = MotionCalib::capture(mover);
+  TLOG_INFO(Telemetry::Event::Calibrated, 0, p.forwardRight, (int16_t)p.rotateMs, (int32_t)p.forwardMs);
+}
+
+// 상자 집기 사이클 시간 (단계별 시간은 boxGetter.lastTimings())
+void reportBoxTimings() {
+  TLOG_INFO(Telemetry::Event::BoxCycle, boxGetter.config().pipelined, 0, 0,
+            (int32_t)boxGetter.lastTimings().cycleMs);
+}
+
+// 다음 move 작업을 예상 종료 상태에서 미리 계획 (작업당 한 번)
+void preplanNext(const JobQueue::Job& current) {
+  JobQueue::Job* next = jobs.next();
+  if (!next || next->type != JobQueue::Type::Move) return;
+  if (preplan.valid && preplan.jobId == next->id) return;
+  if (sharingFloor()) return; // 시공간 경로는 출발 시각을 알아야 한다 (시작할 때 계획)
+
+  int x, y;
+  uint8_t heading;
+  predictedEnd(current, x, y, heading);
+  const uint16_t n = planMove(x, y, heading, next->x, next->y, preplanNodes);
+  if (n == 0) return; // 시작할 때 다시 계획하고, 그래도 없으면 실패 처리
+  preplan = Preplan{true, next->id, n, (int8_t)x, (int8_t)y, heading};
+}
+
+void serviceJobs() {
+  JobQueue::Job* job = jobs.running();
+  if (job) {
+    bool ok;
+    if (!jobFinished(*job, ok)) {
+      preplanNext(*job);
+      return;
+    }
+    TLOG_INFO(Telemetry::Event::JobEnd, ok, (int16_t)job->id);
+    if (ok && (job->type == JobQueue::Type::Box || job->type == JobQueue::Type::Pick)) reportBoxTimings();
+    jobs.finishRunning(ok);
+  }
+
+  if (teleopMove.active) return; // 원격 조종 이동이 끝난 뒤 시작
+
+  // 앞 작업이 끝난 같은 loop 안에서 바로 다음 작업 시작
+  while ((job = jobs.startNext()) != nullptr) {
+    if (startJob(*job)) return;
+    TLOG_FAULT(Telemetry::Event::JobEnd, 0, (int16_t)job->id);
+    jobs.finishRunning(false);
   }
-  
-  Serial.println("Planning path from (" + String(currentX) + ", " + String(currentY) + ") to (" + String(targetX) + ", " + String(targetY) + ")");
-  AStarResult result = planAstar5x5(grid, currentX, currentY, targetX, targetY, pathNodes, PathRunner::MAX_POINTS);
-
-  if (result.ok) {
-    Serial.println("Path found with " + String(result.n) + " nodes. Starting movement.");
-    
-    // +++ [수정] 경로 실행 전, 목표 좌표를 임시 변수에 저장 +++
-    pathGoalX = targetX;
-    pathGoalY = targetY;
-
-    runner.loadPath(pathNodes, result.n);
-    runner.start();
-  } else {
-    Serial.println("!!! Path not found !!!");
+}
+
+// ---- 여러 정류장 미션 ----
+
+// (x, y, heading) → (tx, ty) 예상 이동 시간. endHeading 에 도착 방향. 갈 수 없으면 TOUR_INF.
+uint32_t travelMs(int x, int y, uint8_t heading, int tx, int ty, uint8_t& endHeading) {
+  endHeading = heading;
+  if (x == tx && y == ty) return 0;
+  const TimedResult r = planLeg(x, y, heading, tx, ty, pathNodes);
+  if (!r.ok) return TOUR_INF;
+  endHeading = r.endHeading;
+  return r.costMs;
+}
+
+// 정류장 동작의 예상 시간 (집기는 접근 칸에서 상자를 본 채 도착하므로 회전 없음)
+uint32_t stopActionMs(StopAction action) {
+  switch (action) {
+    case StopAction::Pick:
+      return boxGetter.plannedCycleMs(0); // 전진 → 올림 → 후진 → 내림 (겹치기 설정 반영)
+    case StopAction::Drop:
+      return LIFT_JOB_MS;
+    default:
+      return 0;
+  }
+}
+
+// (x, y, heading) 에서 정류장까지 이동 시간. 성공하면 (x, y, heading) 을 도착 자세로 바꾼다.
+// 집기 정류장은 상자 칸이 아니라 가장 빠른 접근 칸에 상자를 보고 도착한다.
+uint32_t legTravelMs(const MissionLeg& stop, int& x, int& y, uint8_t& heading) {
+  if (stop.action == StopAction::Pick) {
+    uint8_t side = 0;
+    const uint32_t c = approachMs(x, y, heading, stop.x, stop.y, side);
+    if (c == TOUR_INF) return TOUR_INF;
+    x = stop.x + astar_timed_detail::HDX[side];
+    y = stop.y + astar_timed_detail::HDY[side];
+    heading = (uint8_t)(side ^ 1);
+    return c;
+  }
+  const uint32_t c = travelMs(x, y, heading, stop.x, stop.y, heading);
+  if (c == TOUR_INF) return TOUR_INF;
+  x = stop.x;
+  y = stop.y;
+  return c;
+}
+
+// 방문 순서를 정하고 missionLegs 를 채운다.
+// 이동 시간표의 출발 자세: 출발점은 현재 방향, 들르기/내려놓기 정류장은 도착 방향이 순서에 따라
+// 달라지므로 어느 방향이든 되는 것으로 (TIMED_ANY_HEADING), 집기 정류장은 허용된 접근 칸/방향 중 최소.
+bool planMission(const MissionLeg* stops, uint8_t n) {
+  static uint32_t cost[(TOUR_MAX_STOPS + 1) * (TOUR_MAX_STOPS + 1)];
+  uint16_t before[TOUR_MAX_STOPS];
+  const uint8_t w = (uint8_t)(n + 1);
+  const uint32_t t0 = micros();
+
+  uint16_t picks = 0;
+  for (uint8_t k = 0; k < n; ++k) {
+    before[k] = stops[k].action == StopAction::Drop ? picks : 0;
+    if (stops[k].action == StopAction::Pick) picks |= (uint16_t)(1u << k);
+  }
+
+  for (uint8_t i = 0; i <= n; ++i) {
+    for (uint8_t j = 1; j <= n; ++j) cost[i * w + j] = (i == j) ? 0 : TOUR_INF;
+    const bool fromPick = i > 0 && stops[i - 1].action == StopAction::Pick;
+    for (uint8_t s = 0; s < (fromPick ? 4 : 1); ++s) {
+      int fx = i ? stops[i - 1].x : currentX;
+      int fy = i ? stops[i - 1].y : currentY;
+      uint8_t fh = i ? TIMED_ANY_HEADING : (uint8_t)mover.getDirection();
+      if (fromPick) {
+        if (!(boxSides[fy][fx] & (1u << s))) continue;
+        fx += astar_timed_detail::HDX[s];
+        fy += astar_timed_detail::HDY[s];
+        if (!gridMap.inBounds(fx, fy) || gridMap.blocked(fx, fy)) continue;
+        fh = (uint8_t)(s ^ 1);
+      }
+      for (uint8_t j = 1; j <= n; ++j) {
+        if (i == j) continue;
+        int x = fx, y = fy;
+        uint8_t h = fh;
+        const uint32_t c = legTravelMs(stops[j - 1], x, y, h);
+        if (c < cost[i * w + j]) cost[i * w + j] = c;
+      }
+    }
+  }
+
+  uint8_t order[TOUR_MAX_STOPS];
+  const TourResult tour = planTour(cost, n, before, order);
+  if (!tour.ok) return false;
+
+  // 정한 순서대로 실제 도착 방향을 이어 가며 구간별 예상 시간
+  int x = currentX, y = currentY;
+  uint8_t heading = (uint8_t)mover.getDirection();
+  uint32_t total = 0;
+  for (uint8_t k = 0; k < n; ++k) {
+    MissionLeg leg = stops[order[k] - 1];
+    const uint32_t move = legTravelMs(leg, x, y, heading);
+    if (move == TOUR_INF) return false;
+    leg.plannedMs = move + stopActionMs(leg.action);
+    total += leg.plannedMs;
+    missionLegs[k] = leg;
+  }
+
+  const uint32_t now = millis();
+  mission = Mission{true, false, n, 0, 0, (int8_t)currentX, (int8_t)currentY, total, now, now};
+  TLOG_INFO(Telemetry::Event::MissionPlanned, n, tour.exact, Telemetry::sat16(micros() - t0),
+            (int32_t)total);
+  return true;
+}
+
+// 구간마다 예상(planMission 이 정한 plannedMs)과 실제 시간. leg_ 명령으로도 본다.
+void reportMission() {
+  for (uint8_t k = 0; k < mission.finished; ++k) {
+    const MissionLeg& leg = missionLegs[k];
+    const int16_t planned = (int16_t)(uint16_t)(leg.plannedMs > 0xFFFF ? 0xFFFF : leg.plannedMs);
+    TLOG_INFO(Telemetry::Event::MissionLeg, (uint8_t)(k | (leg.ok ? 0 : 0x80)), planned,
+              (int16_t)((leg.x << 8) | leg.y), (int32_t)leg.actualMs);
+  }
+  TLOG_INFO(Telemetry::Event::MissionEnd, mission.failed, 0, 0, (int32_t)(millis() - mission.startMs));
+}
+
+// 끝난 구간의 실제 시간을 기록하고, 큐에 자리가 나는 대로 다음 구간 작업을 넣는다.
+// 미션 작업은 모두 afterPrev 로 넣으므로 하나가 실패하면 작업 큐가 뒤따르는 미션 작업을
+// 시작하지 않고 함께 실패시킨다 (목표 칸에 못 간 채로 집기/내려놓기를 하지 않도록; 같은 loop 에서
+// serviceJobs 가 다음 작업을 바로 시작하므로 여기서 취소하면 늦다). 남은 구간은 넣지 않는다.
+void serviceMission() {
+  if (!mission.active) return;
+
+  while (mission.finished < mission.pushed) {
+    MissionLeg& leg = missionLegs[mission.finished];
+    const JobQueue::Status st = leg.lastJob ? jobs.status(leg.lastJob) : JobQueue::Status::Done;
+    if (st == JobQueue::Status::Queued || st == JobQueue::Status::Running) break;
+    leg.ok = (st == JobQueue::Status::Done);
+    leg.actualMs = millis() - mission.lastEndMs;
+    mission.lastEndMs = millis();
+    mission.finished++;
+    if (!leg.ok && !mission.failed) {
+      mission.failed = true;
+      jobs.cancelAll();
+    }
+  }
+
+  while (!mission.failed && mission.pushed < mission.n && jobs.pending() + 2 <= JobQueue::CAPACITY) {
+    MissionLeg& leg = missionLegs[mission.pushed];
+    leg.moveJob = 0;
+    if (leg.action == StopAction::Pick) {
+      // pick 작업이 접근 칸까지 직접 간다. 끝나는 칸은 그때 고르므로 다음 구간은 항상 move 로 시작.
+      leg.lastJob = jobs.push(JobQueue::Type::Pick, leg.x, leg.y, true);
+      mission.atX = -1;
+      mission.atY = -1;
+      mission.pushed++;
+      continue;
+    }
+    if (leg.x != mission.atX || leg.y != mission.atY) leg.moveJob = jobs.push(JobQueue::Type::Move, leg.x, leg.y, true);
+    leg.lastJob = leg.moveJob;
+    if (leg.action == StopAction::Drop) leg.lastJob = jobs.push(JobQueue::Type::LiftDown, 0, 0, true);
+    mission.atX = leg.x;
+    mission.atY = leg.y;
+    mission.pushed++;
+  }
+
+  if (mission.finished == mission.pushed && (mission.failed || mission.pushed == mission.n)) {
+    mission.active = false;
+    reportMission();
   }
 }
@@ -0,0 +1,89 @@
+// Scheduler.cpp
+#include "Scheduler.h"
+#include <Arduino.h>
+
+Scheduler::Scheduler(uint32_t tickBudgetUs) : tickBudgetUs_(tickBudgetUs) {}
+
+bool Scheduler::add(const char* name, TaskFn fn, uint32_t periodUs, uint32_t deadlineUs, uint32_t budgetUs,
+                    Priority priority) {
+  if (n_ >= MAX_TASKS || fn == nullptr) return false;
+  const uint32_t now = micros();
+  // 우선순위가 같으면 먼저 등록한 작업이 앞
+  uint8_t at = n_;
+  while (at > 0 && (uint8_t)tasks_[at - 1].priority > (uint8_t)priority) {
+    tasks_[at] = tasks_[at - 1];
+    at--;
+  }
+  tasks_[at] = Task{name, fn, periodUs, deadlineUs, budgetUs, priority, now, now, 0, 0, 0, 0, 0, Histogram()};
+  n_++;
+  return true;
+}
+
+bool Scheduler::due(const Task& t, uint32_t now) const {
+  return t.periodUs == 0 || (int32_t)(now - t.releaseUs) >= 0;
+}
+
+void Scheduler::tick() {
+  const uint32_t tickStart = micros();
+  if (ticks_ > 0) loopUs_.record(tickStart - lastTickUs_);
+  lastTickUs_ = tickStart;
+  ticks_++;
+  if (!armed_) {
+    for (uint8_t i = 0; i < n_; ++i) tasks_[i].releaseUs = tasks_[i].lastStartUs = tickStart;
+    armed_ = true;
+  }
+  for (uint8_t i = 0; i < n_; ++i) {
+    Task& t = tasks_[i];
+    const uint32_t now = micros();
+    if (!due(t, now)) continue;
+    if (tickBudgetUs_ && t.priority != Priority::Critical && now - tickStart > tickBudgetUs_) {
+      t.deferred++;
+      continue;
+    }
+
+    // 매 tick 작업은 직전 시작이 출시 시각
+    const uint32_t release = t.periodUs ? t.releaseUs : t.lastStartUs;
+    const uint32_t late = now - release;
+    bool overrun = t.runs > 0 && t.deadlineUs && late > t.deadlineUs;
+    if (t.runs > 0 && late > t.maxLateUs) t.maxLateUs = late;
+
+    t.lastStartUs = now;
+    t.fn();
+    const uint32_t ran = micros() - now;
+    t.runUs.record(ran);
+    if (t.budgetUs && ran > t.budgetUs) overrun = true;
+    if (overrun) t.overruns++;
+    t.runs++;
+
+    if (t.periodUs) {
+      t.releaseUs += t.periodUs;
+      // 한 주기 이상 밀렸으면 밀린 만큼 건너뛰고 지금 기준으로 다시 잡는다
+      const uint32_t after = micros();
+      if ((int32_t)(after - t.releaseUs) >= 0) {
+        t.skipped += (after - t.releaseUs) / t.periodUs + 1;
+        t.releaseUs = after + t.periodUs;
+      }
+    }
+  }
+}
+
+uint8_t Scheduler::count() const { return n_; }
+const Scheduler::Task& Scheduler::task(uint8_t i) const { return tasks_[i]; }
+uint32_t Scheduler::ticks() const { return ticks_; }
+const Histogram& Scheduler::loopUs() const { return loopUs_; }
+
+uint32_t Scheduler::overruns() const {
+  uint32_t sum = 0;
+  for (uint8_t i = 0; i < n_; ++i) sum += tasks_[i].overruns;
+  return sum;
+}
+
+void Scheduler::resetStats() {
+  for (uint8_t i = 0; i < n_; ++i) {
+    Task& t = tasks_[i];
+    t.runs = t.overruns = t.skipped = t.deferred = t.maxLateUs = 0;
+    t.runUs.reset();
+  }
+  ticks_ = 0;
+  loopUs_.reset();
+}
@@ -0,0 +1,70 @@
+// Scheduler.h
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <cstdint>
+#include "Histogram.h"
+
+// 협조형 고정 주기 작업 스케줄러 (동적 할당 없음)
+// - 모듈마다 작업 하나를 주기/마감/예산/우선순위와 함께 등록하고, loop() 는 tick() 만 부른다.
+//   tick() 한 번에 때가 된 작업을 우선순위 순서(같으면 등록 순서)로 한 번씩만 실행한다.
+// - periodUs = 0 이면 매 tick. 아니면 고정 주기로 출시(release)하고, 밀리면 밀린 주기를 몰아서
+//   실행하지 않고 건너뛴다 (skipped).
+// - 마감: 출시 뒤 deadlineUs 안에 시작하지 못하면 초과(overrun). 매 tick 작업은 직전 실행 시작부터
+//   잰다 (loop 한 바퀴가 길어지면 걸린다). 예산: 한 번 실행이 budgetUs 를 넘으면 초과.
+// - 선점은 없으므로 tick 안에서 tickBudgetUs 를 다 쓰면 Critical 이 아닌 남은 작업은 다음 tick 으로
+//   미룬다 (deferred). 미룬 작업은 계속 때가 된 상태라 다음 tick 에 먼저 돈다.
+// - 작업별 실행 시간과 loop 주기(tick 시작 간격)는 Histogram 에 쌓는다 (/stats).
+// - 출시 시각은 첫 tick() 에서 잡는다: 등록 뒤 setup() 의 긴 대기(WiFi 연결 등)를 건너뜀으로 세지 않는다.
+class Scheduler {
+public:
+  typedef void (*TaskFn)();
+  enum class Priority : uint8_t { Critical, High, Normal, Low };
+
+  struct Task {
+    const char* name;
+    TaskFn   fn;
+    uint32_t periodUs;    // 0 = 매 tick
+    uint32_t deadlineUs;  // 0 = 검사 안 함
+    uint32_t budgetUs;    // 0 = 검사 안 함
+    Priority priority;
+
+    uint32_t releaseUs;   // 다음(또는 이번) 출시 시각
+    uint32_t lastStartUs;
+    uint32_t runs;
+    uint32_t overruns;    // 마감 또는 예산 초과
+    uint32_t skipped;     // 건너뛴 주기 수
+    uint32_t deferred;    // tick 예산이 모자라 미룬 횟수
+    uint32_t maxLateUs;   // 출시 → 시작 최대
+    Histogram runUs;      // 한 번 실행 시간
+  };
+
+  static constexpr uint8_t MAX_TASKS = 16;
+
+  explicit Scheduler(uint32_t tickBudgetUs = 0);
+
+  // 등록 순서는 상관없고 우선순위로 정렬된다. 자리가 없으면 false.
+  bool add(const char* name, TaskFn fn, uint32_t periodUs, uint32_t deadlineUs, uint32_t budgetUs,
+           Priority priority);
+  void tick();
+
+  uint8_t count() const;
+  const Task& task(uint8_t i) const;
+  uint32_t ticks() const;
+  uint32_t overruns() const;   // 모든 작업의 초과 합
+  const Histogram& loopUs() const; // tick 시작 간격
+  void resetStats();
+
+private:
+  bool due(const Task& t, uint32_t now) const;
+
+  Task     tasks_[MAX_TASKS];
+  uint8_t  n_{0};
+  uint32_t tickBudgetUs_;
+  uint32_t ticks_{0};
+  uint32_t lastTickUs_{0};
+  bool     armed_{false}; // 첫 tick 에 출시 시각을 다시 잡았는지
+  Histogram loopUs_;
+};
+
+#endif // SCHEDULER_H
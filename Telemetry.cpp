@@ -0,0 +1,183 @@
+// Telemetry.cpp
+#include "Telemetry.h"
+#include <Arduino.h>
+#include <stdio.h>
+
+Telemetry telemetry;
+
+static const char* const EVENT_NAMES[(uint8_t)Telemetry::Event::Count] = {
+  "boot", "cmd", "job_start", "job_end", "job_rejected", "path", "no_path", "path_done",
+  "path_repair", "no_detour", "map", "pick", "no_approach", "box_cycle", "mission", "leg",
+  "mission_end", "calibrated", "act_start", "act_end", "odo_timeout", "overrun", "estop",
+  "mission_rej", "ws_open", "runner_busy",
+};
+
+static const char* const ACTION_NAMES[] = {"idle", "cw", "ccw", "fwd", "bwd", "pause"};
+
+static const char* actionName(uint8_t a) {
+  return a < sizeof(ACTION_NAMES) / sizeof(ACTION_NAMES[0]) ? ACTION_NAMES[a] : "?";
+}
+
+void Telemetry::log(Event e, uint8_t arg, int16_t a, int16_t b, int32_t c) {
+  Record& r = ring_[head_];
+  r = Record{(uint32_t)millis(), e, arg, a, b, c};
+  head_ = (uint16_t)((head_ + 1) % CAPACITY);
+  if (count_ < CAPACITY) count_++;
+  written_++;
+  if (mirror_) {
+    char line[80];
+    const int n = format(r, line, sizeof(line));
+    if (n > 0) mirror_->println(line);
+  }
+}
+
+void Telemetry::clear() { count_ = 0; }
+void Telemetry::setMirror(Print* out) { mirror_ = out; }
+
+uint16_t Telemetry::size() const { return count_; }
+uint32_t Telemetry::written() const { return written_; }
+
+const Telemetry::Record& Telemetry::at(uint16_t i) const {
+  return ring_[(head_ + CAPACITY - count_ + i) % CAPACITY];
+}
+
+// ---- 전송 형식 (리틀 엔디언) ----
+static void put16(uint8_t*& p, uint16_t v) { *p++ = (uint8_t)v; *p++ = (uint8_t)(v >> 8); }
+static void put32(uint8_t*& p, uint32_t v) { put16(p, (uint16_t)v); put16(p, (uint16_t)(v >> 16)); }
+static uint16_t get16(const uint8_t*& p) { const uint16_t v = (uint16_t)(p[0] | (p[1] << 8)); p += 2; return v; }
+static uint32_t get32(const uint8_t*& p) { const uint32_t lo = get16(p); return lo | ((uint32_t)get16(p) << 16); }
+
+void Telemetry::packHeader(uint8_t* out) const {
+  put16(out, MAGIC);
+  *out++ = FORMAT_VERSION;
+  *out++ = RECORD_BYTES;
+  put16(out, count_);
+  put16(out, CAPACITY);
+  put32(out, written_ - count_);
+  put32(out, millis());
+}
+
+void Telemetry::pack(const Record& r, uint8_t* out) {
+  put32(out, r.ms);
+  *out++ = (uint8_t)r.event;
+  *out++ = r.arg;
+  put16(out, (uint16_t)r.a);
+  put16(out, (uint16_t)r.b);
+  put32(out, (uint32_t)r.c);
+}
+
+bool Telemetry::unpackHeader(const uint8_t* p, size_t n, Header& out) {
+  if (n < HEADER_BYTES || get16(p) != MAGIC) return false;
+  out.version = *p++;
+  const uint8_t recordBytes = *p++;
+  if (out.version != FORMAT_VERSION || recordBytes != RECORD_BYTES) return false;
+  out.count = get16(p);
+  out.capacity = get16(p);
+  out.firstSeq = get32(p);
+  out.nowMs = get32(p);
+  return true;
+}
+
+void Telemetry::unpack(const uint8_t* p, Record& out) {
+  out.ms = get32(p);
+  out.event = (Event)*p++;
+  out.arg = *p++;
+  out.a = (int16_t)get16(p);
+  out.b = (int16_t)get16(p);
+  out.c = (int32_t)get32(p);
+}
+
+const char* Telemetry::eventName(Event e) {
+  return (uint8_t)e < (uint8_t)Event::Count ? EVENT_NAMES[(uint8_t)e] : "?";
+}
+
+int Telemetry::format(const Record& r, char* buf, size_t size) {
+  const int n = snprintf(buf, size, "%9lu %-12s ", (unsigned long)r.ms, eventName(r.event));
+  if (n < 0 || (size_t)n >= size) return n;
+  char* p = buf + n;
+  const size_t left = size - n;
+  const long c = (long)r.c;
+  int m;
+  switch (r.event) {
+    case Event::Boot:
+    case Event::PathNotFound:
+    case Event::PathFinished:
+    case Event::NoDetour:
+    case Event::NoApproach:
+    case Event::RunnerBusy:
+      m = snprintf(p, left, "(%d, %d)", r.a, r.b);
+      break;
+    case Event::Command: {
+      char head[5];
+      for (uint8_t i = 0; i < 4; ++i) {
+        const char ch = (char)(r.c >> (8 * i));
+        head[i] = (ch >= 0x20 && ch < 0x7F) ? ch : '.';
+      }
+      head[4] = '\0';
+      m = snprintf(p, left, "%s \"%s%s\" (%d bytes)", r.arg ? "ws" : "http", head, r.a > 4 ? "..." : "", r.a);
+      break;
+    }
+    case Event::JobStart:
+      m = snprintf(p, left, "#%d type %u (%d, %ld)", r.a, r.arg, r.b, c);
+      break;
+    case Event::JobEnd:
+      m = snprintf(p, left, "#%d %s", r.a, r.arg ? "done" : "failed");
+      break;
+    case Event::PathPlanned:
+      m = snprintf(p, left, "to (%d, %d) %u nodes, %ld ms", r.a, r.b, r.arg, c);
+      break;
+    case Event::PathRepaired:
+      m = snprintf(p, left, "at (%d, %d) %u nodes, %ld expansions", r.a, r.b, r.arg, c);
+      break;
+    case Event::MapChanged:
+      m = snprintf(p, left, "(%d, %d) %s", r.a, r.b, r.arg ? "blocked" : "freed");
+      break;
+    case Event::PickStart:
+      m = snprintf(p, left, "box (%d, %d) facing %u", r.a, r.b, r.arg);
+      break;
+    case Event::BoxCycle:
+      m = snprintf(p, left, "%ld ms %s", c, r.arg ? "pipelined" : "sequential");
+      break;
+    case Event::MissionPlanned:
+      m = snprintf(p, left, "%u stops, %ld ms (%s order, planned in %d us)", r.arg, c,
+                   r.a ? "exact" : "heuristic", r.b);
+      break;
+    case Event::MissionLeg: {
+      const long planned = (uint16_t)r.a;
+      m = snprintf(p, left, "%u (%d, %d) planned %ld ms, actual %ld ms (%+ld ms)%s", (r.arg & 0x7F) + 1,
+                   (uint16_t)r.b >> 8, r.b & 0xFF, planned, c, c - planned, (r.arg & 0x80) ? " FAILED" : "");
+      break;
+    }
+    case Event::MissionEnd:
+      m = snprintf(p, left, "%s, %ld ms", r.arg ? "failed" : "done", c);
+      break;
+    case Event::Calibrated:
+      m = snprintf(p, left, "cell %ld ms, 90deg %d ms, fwd right pwm %d", c, r.b, r.a);
+      break;
+    case Event::ActionStart:
+      m = snprintf(p, left, "%s x%d tag %d, %ld ms", actionName(r.arg), r.a, r.b, c);
+      break;
+    case Event::ActionEnd:
+      m = snprintf(p, left, "%s tag %d, %+ld ms vs plan", actionName(r.arg), r.b, c);
+      break;
+    case Event::OdometryTimeout:
+      m = snprintf(p, left, "%s after %ld ticks", actionName(r.arg), c);
+      break;
+    case Event::TaskOverrun:
+      m = snprintf(p, left, "task %u: %d overruns, max late %ld us", r.arg, r.a, c);
+      break;
+    case Event::MissionRejected:
+      m = snprintf(p, left, "%u stops", r.arg);
+      break;
+    case Event::StreamOpened:
+      m = snprintf(p, left, "status stream");
+      break;
+    case Event::EmergencyStop:
+      m = snprintf(p, left, "%s", r.arg == 0 ? "disconnected" : r.arg == 1 ? "teleop stop" : "heartbeat lost");
+      break;
+    default:
+      m = snprintf(p, left, "arg %u a %d b %d c %ld", r.arg, r.a, r.b, c);
+      break;
+  }
+  return m < 0 ? m : n + m;
+}
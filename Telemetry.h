@@ -0,0 +1,126 @@
+// Telemetry.h
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <cstddef>
+#include <cstdint>
+
+class Print;
+
+// 이진 이벤트 기록 (고정 크기 링, 동적 할당 없음)
+// - 제어 경로에서는 String 조립이나 Serial 출력 대신 TLOG_* 로 숫자 몇 개만 남긴다.
+//   기록 하나는 시각[ms] + 이벤트 + 인자 (arg, a, b, c). 링이 차면 가장 오래된 것부터 덮어쓴다.
+// - 수준별로 컴파일에서 뺀다: TELEMETRY_LEVEL 0 끔, 1 Fault, 2 + Info, 3 + Debug (동작 하나하나).
+//   빠진 수준의 TLOG_* 는 인자까지 통째로 사라진다.
+// - GET /log 로 [헤더][기록...] 을 받아 호스트의 scvlog 로 풀어 본다 (전송 형식은 리틀 엔디언,
+//   구조체 패딩과 무관). 형식을 바꾸면 FORMAT_VERSION 을 올린다.
+// - setMirror() 로 Serial 을 주면 기록할 때마다 한 줄씩 글로도 낸다 (디버깅용, 기본 꺼짐).
+#ifndef TELEMETRY_LEVEL
+#define TELEMETRY_LEVEL 3
+#endif
+
+class Telemetry {
+public:
+  // 인자 뜻은 format() 참고. 새 이벤트는 끝에만 붙인다 (기록된 번호가 바뀌지 않도록).
+  enum class Event : uint8_t {
+    Boot,            // a,b = 시작 칸
+    Command,         // arg = 0 HTTP / 1 WS, a = 길이, c = 앞 4글자
+    JobStart,        // arg = JobQueue::Type, a = id, b,c = 목표 칸
+    JobEnd,          // arg = 성공, a = id
+    JobRejected,     // 큐 가득 참
+    PathPlanned,     // arg = 칸 수, a,b = 목표 칸, c = 예상 시간 [ms]
+    PathNotFound,    // a,b = 목표 칸
+    PathFinished,    // a,b = 도착 칸
+    PathRepaired,    // arg = 칸 수, a,b = 갈아탄 칸, c = D* Lite 전개 수
+    NoDetour,        // a,b = 멈춘 칸
+    MapChanged,      // arg = 막힘, a,b = 칸
+    PickStart,       // arg = 상자를 보는 방향, a,b = 상자 칸
+    NoApproach,      // a,b = 상자 칸
+    BoxCycle,        // arg = 겹치기, c = 사이클 [ms]
+    MissionPlanned,  // arg = 정류장 수, a = 최적 순서 여부, b = 계획 시간 [us], c = 예상 시간 [ms]
+    MissionLeg,      // arg = 구간 번호 (실패면 0x80), a = 예상 시간 [ms] (uint16, 넘치면 65535),
+                     // b = 칸 (x << 8 | y), c = 실제 시간 [ms]
+    MissionEnd,      // arg = 실패, c = 실제 시간 [ms]
+    Calibrated,      // a = 오른쪽 전진 PWM, b = 90도 [ms], c = 한 칸 [ms]
+    ActionStart,     // arg = gridMove::Action, a = 칸 수, b = tag, c = 예상 시간 [ms]
+    ActionEnd,       // arg = gridMove::Action, b = tag, c = 예정 종료 대비 [ms] (+ 늦음)
+    OdometryTimeout, // arg = gridMove::Action, c = 간 틱 수
+    TaskOverrun,     // arg = 작업 번호 (실행 순서), a = 초과 횟수, c = 최대 지연 [us]
+    EmergencyStop,   // arg = 0 disconnected 명령 / 1 조종 Stop / 2 heartbeat 끊김
+    MissionRejected, // arg = 읽은 정류장 수
+    StreamOpened,    // /ws 상태 스트림 연결
+    RunnerBusy,      // a,b = 목표 칸 (경로 실행 중이라 이동을 받지 않음)
+    Count
+  };
+
+  struct Record {
+    uint32_t ms;
+    Event    event;
+    uint8_t  arg;
+    int16_t  a;
+    int16_t  b;
+    int32_t  c;
+  };
+
+  // [magic 2][version 1][기록 크기 1][count 2][capacity 2][firstSeq 4][nowMs 4]
+  struct Header {
+    uint8_t  version;
+    uint16_t count;     // 이어지는 기록 수
+    uint16_t capacity;
+    uint32_t firstSeq;  // 첫 기록의 일련번호 (부팅 후 0 부터). 앞 다운로드와 번호가 끊기면 덮어쓴 것.
+    uint32_t nowMs;     // 보낼 때의 millis()
+  };
+
+  static constexpr uint16_t CAPACITY       = 128;
+  static constexpr uint16_t MAGIC          = 0x5453; // 'S' 'T'
+  static constexpr uint8_t  FORMAT_VERSION = 1;
+  static constexpr uint8_t  HEADER_BYTES   = 16;
+  static constexpr uint8_t  RECORD_BYTES   = 14;
+
+  void log(Event e, uint8_t arg = 0, int16_t a = 0, int16_t b = 0, int32_t c = 0);
+  // 횟수/시간을 16비트 인자에 넣을 때 (넘치면 INT16_MAX)
+  static int16_t sat16(uint32_t v) { return v > 0x7FFF ? (int16_t)0x7FFF : (int16_t)v; }
+  void clear();
+  void setMirror(Print* out);
+
+  uint16_t size() const;
+  uint32_t written() const;
+  const Record& at(uint16_t i) const;   // 0 = 가장 오래된 기록
+
+  // 전송 형식
+  void packHeader(uint8_t* out) const;
+  static void pack(const Record& r, uint8_t* out);
+  static bool unpackHeader(const uint8_t* p, size_t n, Header& out);
+  static void unpack(const uint8_t* p, Record& out);
+
+  static const char* eventName(Event e);
+  // 기록 한 줄 (줄바꿈 없음). snprintf 와 같이 쓴 (쓰려던) 길이를 돌려준다.
+  static int format(const Record& r, char* buf, size_t size);
+
+private:
+  Record   ring_[CAPACITY];
+  uint16_t head_{0};     // 다음에 쓸 자리
+  uint16_t count_{0};
+  uint32_t written_{0};
+  Print*   mirror_{nullptr};
+};
+
+extern Telemetry telemetry;
+
+#if TELEMETRY_LEVEL >= 1
+#define TLOG_FAULT(...) telemetry.log(__VA_ARGS__)
+#else
+#define TLOG_FAULT(...) ((void)0)
+#endif
+#if TELEMETRY_LEVEL >= 2
+#define TLOG_INFO(...) telemetry.log(__VA_ARGS__)
+#else
+#define TLOG_INFO(...) ((void)0)
+#endif
+#if TELEMETRY_LEVEL >= 3
+#define TLOG_DEBUG(...) telemetry.log(__VA_ARGS__)
+#else
+#define TLOG_DEBUG(...) ((void)0)
+#endif
+
+#endif // TELEMETRY_H
@@ -0,0 +1,83 @@
+// UdpTeleop.cpp
+#include "UdpTeleop.h"
+
+bool UdpTeleop::begin(uint16_t port) {
+  open_ = udp_.begin(port) != 0;
+  session_ = false;
+  return open_;
+}
+
+void UdpTeleop::encode(uint8_t op, uint16_t seq, uint16_t arg, uint8_t out[PACKET_SIZE]) {
+  out[0] = MAGIC;
+  out[1] = op;
+  out[2] = (uint8_t)seq;
+  out[3] = (uint8_t)(seq >> 8);
+  out[4] = (uint8_t)arg;
+  out[5] = (uint8_t)(arg >> 8);
+  out[6] = 0;
+  out[7] = 0;
+  for (uint8_t i = 0; i < PACKET_SIZE - 1; ++i) out[7] ^= out[i];
+}
+
+bool UdpTeleop::decode(const uint8_t in[PACKET_SIZE], Command& cmd) {
+  uint8_t sum = 0;
+  for (uint8_t i = 0; i < PACKET_SIZE - 1; ++i) sum ^= in[i];
+  if (in[0] != MAGIC || sum != in[7] || (in[1] & ~ACK_FLAG) > (uint8_t)Op::Stop) return false;
+  cmd.op  = (Op)in[1];
+  cmd.seq = (uint16_t)(in[2] | (in[3] << 8));
+  cmd.arg = (uint16_t)(in[4] | (in[5] << 8));
+  return true;
+}
+
+bool UdpTeleop::poll(Command& cmd) {
+  if (!open_) return false;
+
+  for (uint8_t n = 0; n < READ_BUDGET; ++n) {
+    const int size = udp_.parsePacket();
+    if (size <= 0) return false;
+
+    uint8_t buf[PACKET_SIZE];
+    if (size != PACKET_SIZE || udp_.read(buf, PACKET_SIZE) != PACKET_SIZE || !decode(buf, cmd) ||
+        ((uint8_t)cmd.op & ACK_FLAG)) {
+      stats_.malformed++;
+      continue;
+    }
+
+    // 세션 안에서는 seq 가 앞으로만 간다 (16비트 순환)
+    if (session_) {
+      const int16_t diff = (int16_t)(cmd.seq - lastSeq_);
+      if (diff == 0) { stats_.duplicate++; continue; }
+      if (diff < 0)  { stats_.stale++;     continue; }
+    }
+    session_ = true;
+    lastSeq_ = cmd.seq;
+    lastRxMs_ = millis();
+    stats_.accepted++;
+
+    if (cmd.op == Op::Heartbeat) {
+      reply(cmd, Ack::Ok);
+      continue;
+    }
+    return true;
+  }
+  return false;
+}
+
+void UdpTeleop::reply(const Command& cmd, Ack ack) {
+  uint8_t buf[PACKET_SIZE];
+  encode((uint8_t)((uint8_t)cmd.op | ACK_FLAG), cmd.seq, (uint16_t)ack, buf);
+  udp_.beginPacket(udp_.remoteIP(), udp_.remotePort());
+  udp_.write(buf, PACKET_SIZE);
+  udp_.endPacket();
+}
+
+bool UdpTeleop::timedOut() {
+  if (!session_ || millis() - lastRxMs_ < HEARTBEAT_TIMEOUT_MS) return false;
+  session_ = false;
+  stats_.timeouts++;
+  return true;
+}
+
+bool UdpTeleop::active() const { return session_; }
+
+const UdpTeleop::Stats& UdpTeleop::stats() const { return stats_; }
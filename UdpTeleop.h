@@ -0,0 +1,72 @@
+// UdpTeleop.h
+#ifndef UDP_TELEOP_H
+#define UDP_TELEOP_H
+
+#include <cstdint>
+#include "WiFiS3.h"
+
+// 원격 조종용 UDP 채널 (고정 8바이트 이진 패킷, 동적 할당 없음)
+//   [0] MAGIC  [1] op  [2..3] seq  [4..5] arg  [6] 0  [7] 앞 7바이트 XOR   (16비트 값은 리틀엔디언)
+// - seq 는 패킷마다 1씩 늘린다. 마지막으로 받은 seq 와 같으면 중복, 앞서면(16비트 순환 비교) 지난
+//   패킷으로 버린다. 길이/MAGIC/체크섬이 틀린 패킷도 버린다.
+// - 세션은 첫 유효 패킷으로 열리고 HEARTBEAT_TIMEOUT_MS 동안 아무 패킷도 없으면 닫힌다 (timedOut()).
+//   닫힌 뒤에는 아무 seq 로나 새 세션을 열 수 있다.
+// - 받은 명령에는 같은 형식으로 답한다: op | 0x80, 같은 seq, arg = Ack
+//
+// 명령과 arg
+//   Heartbeat  -          (세션 유지만, poll() 로 넘기지 않고 바로 Ok 응답)
+//   Step       0=전진 1=후진 (현재 방향으로 한 칸)
+//   Rotate     0=CW 1=CCW (제자리 90도)
+//   LiftUp     구동 시간 ms (0 이면 기본값)
+//   LiftDown   구동 시간 ms (0 이면 기본값)
+//   Stop       -          (즉시 정지)
+class UdpTeleop {
+public:
+  enum class Op : uint8_t { Heartbeat, Step, Rotate, LiftUp, LiftDown, Stop };
+  enum class Ack : uint8_t { Ok, Busy, Refused };
+
+  struct Command {
+    Op       op;
+    uint16_t seq;
+    uint16_t arg;
+  };
+
+  struct Stats {
+    uint32_t accepted;  // 세션을 유지시킨 유효 패킷 (heartbeat 포함)
+    uint32_t duplicate;
+    uint32_t stale;
+    uint32_t malformed;
+    uint32_t timeouts;
+  };
+
+  static constexpr uint8_t  PACKET_SIZE = 8;
+  static constexpr uint8_t  MAGIC       = 0xA5;
+  static constexpr uint8_t  ACK_FLAG    = 0x80;
+  static constexpr uint8_t  READ_BUDGET = 4;   // poll() 한 번에 처리하는 최대 패킷 수
+  static constexpr uint32_t HEARTBEAT_TIMEOUT_MS = 300;
+
+  bool begin(uint16_t port);
+
+  // 새 명령이 있으면 true. 호출자는 실행 결과를 reply() 로 돌려준다.
+  bool poll(Command& cmd);
+  void reply(const Command& cmd, Ack ack);
+
+  // 세션이 방금 끊겼으면 한 번만 true
+  bool timedOut();
+  bool active() const;
+  const Stats& stats() const;
+
+  // 패킷 인코딩/디코딩 (호스트 도구와 공유). 응답 패킷은 op 에 ACK_FLAG 가 붙어 있다.
+  static void encode(uint8_t op, uint16_t seq, uint16_t arg, uint8_t out[PACKET_SIZE]);
+  static bool decode(const uint8_t in[PACKET_SIZE], Command& cmd);
+
+private:
+  WiFiUDP  udp_;
+  bool     open_{false};
+  bool     session_{false};
+  uint16_t lastSeq_{0};
+  uint32_t lastRxMs_{0};
+  Stats    stats_{0, 0, 0, 0, 0};
+};
+
+#endif // UDP_TELEOP_H
@@ -0,0 +1,205 @@
+// WsSession.cpp
+#include "WsSession.h"
+#include <string.h>
+
+static const char WS_GUID[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+enum : uint8_t { OP_TEXT = 0x1, OP_CLOSE = 0x8, OP_PING = 0x9, OP_PONG = 0xA };
+
+// ---- SHA-1 (핸드셰이크 전용, 입력 64바이트 이하 2블록) ----
+static uint32_t rol(uint32_t v, uint8_t n) { return (v << n) | (v >> (32 - n)); }
+
+static void sha1Block(uint32_t h[5], const uint8_t* p) {
+  uint32_t w[80];
+  for (uint8_t i = 0; i < 16; ++i) {
+    w[i] = ((uint32_t)p[4 * i] << 24) | ((uint32_t)p[4 * i + 1] << 16) |
+           ((uint32_t)p[4 * i + 2] << 8) | p[4 * i + 3];
+  }
+  for (uint8_t i = 16; i < 80; ++i) w[i] = rol(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+  uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+  for (uint8_t i = 0; i < 80; ++i) {
+    uint32_t f, k;
+    if      (i < 20) { f = (b & c) | (~b & d);           k = 0x5A827999; }
+    else if (i < 40) { f = b ^ c ^ d;                    k = 0x6ED9EBA1; }
+    else if (i < 60) { f = (b & c) | (b & d) | (c & d);  k = 0x8F1BBCDC; }
+    else             { f = b ^ c ^ d;                    k = 0xCA62C1D6; }
+    const uint32_t t = rol(a, 5) + f + e + k + w[i];
+    e = d; d = c; c = rol(b, 30); b = a; a = t;
+  }
+  h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+}
+
+static void sha1(const uint8_t* data, size_t n, uint8_t out[20]) {
+  uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+  uint8_t block[64];
+  size_t i = 0;
+  for (; i + 64 <= n; i += 64) sha1Block(h, data + i);
+
+  // 남은 바이트 + 0x80 + 0 채움 + 64비트 길이 (빅엔디언)
+  const size_t rem = n - i;
+  memset(block, 0, sizeof(block));
+  memcpy(block, data + i, rem);
+  block[rem] = 0x80;
+  if (rem >= 56) {
+    sha1Block(h, block);
+    memset(block, 0, sizeof(block));
+  }
+  const uint64_t bits = (uint64_t)n * 8;
+  for (uint8_t k = 0; k < 8; ++k) block[63 - k] = (uint8_t)(bits >> (8 * k));
+  sha1Block(h, block);
+
+  for (uint8_t k = 0; k < 20; ++k) out[k] = (uint8_t)(h[k / 4] >> (24 - 8 * (k % 4)));
+}
+
+static size_t base64(const uint8_t* in, size_t n, char* out) {
+  static const char T[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  size_t o = 0;
+  for (size_t i = 0; i < n; i += 3) {
+    const uint32_t v = ((uint32_t)in[i] << 16) | (i + 1 < n ? (uint32_t)in[i + 1] << 8 : 0) |
+                       (i + 2 < n ? in[i + 2] : 0);
+    out[o++] = T[(v >> 18) & 63];
+    out[o++] = T[(v >> 12) & 63];
+    out[o++] = i + 1 < n ? T[(v >> 6) & 63] : '=';
+    out[o++] = i + 2 < n ? T[v & 63] : '=';
+  }
+  out[o] = '\0';
+  return o;
+}
+
+// ---- 세션 ----
+bool WsSession::active() {
+  if (open_ && !client_.connected()) close();
+  return open_;
+}
+
+bool WsSession::owns(const WiFiClient& c) const { return open_ && client_ == c; }
+
+bool WsSession::accept(WiFiClient& client, const char* key) {
+  const size_t keyLen = strlen(key);
+  if (keyLen == 0 || keyLen > 24) return false;
+  if (open_) close(); // 스트림은 하나만 유지: 새 접속이 이전 접속을 대체
+
+  uint8_t input[24 + sizeof(WS_GUID) - 1];
+  memcpy(input, key, keyLen);
+  memcpy(input + keyLen, WS_GUID, sizeof(WS_GUID) - 1);
+  uint8_t digest[20];
+  sha1(input, keyLen + sizeof(WS_GUID) - 1, digest);
+  char accept[29];
+  base64(digest, sizeof(digest), accept);
+
+  client.print("HTTP/1.1 101 Switching Protocols\r\n"
+               "Upgrade: websocket\r\n"
+               "Connection: Upgrade\r\n"
+               "Sec-WebSocket-Accept: ");
+  client.print(accept);
+  client.print("\r\n\r\n");
+
+  client_ = client;
+  open_ = true;
+  state_ = State::Header0;
+  return true;
+}
+
+bool WsSession::poll(const char*& msg) {
+  if (!active()) return false;
+  for (uint8_t n = 0; n < READ_BUDGET && client_.available() > 0; ++n) {
+    const uint8_t c = (uint8_t)client_.read();
+    switch (state_) {
+      case State::Header0:
+        fin_ = (c & 0x80) != 0;
+        opcode_ = c & 0x0F;
+        state_ = State::Header1;
+        break;
+
+      case State::Header1:
+        masked_ = (c & 0x80) != 0;
+        len_ = c & 0x7F;
+        got_ = 0;
+        maskPos_ = 0;
+        if (len_ >= 126) {
+          extLeft_ = (len_ == 126) ? 2 : 8;
+          len_ = 0;
+          state_ = State::ExtLen;
+        } else {
+          state_ = masked_ ? State::Mask : State::Payload;
+        }
+        break;
+
+      case State::ExtLen:
+        len_ = (len_ << 8) | c; // 64비트 길이의 상위 바이트는 버려진다 (어차피 MSG_MAX 초과)
+        if (--extLeft_ == 0) state_ = masked_ ? State::Mask : State::Payload;
+        break;
+
+      case State::Mask:
+        mask_[maskPos_++] = c;
+        if (maskPos_ == 4) {
+          maskPos_ = 0;
+          state_ = State::Payload;
+        }
+        break;
+
+      case State::Payload: {
+        const uint8_t b = masked_ ? (uint8_t)(c ^ mask_[got_ & 3]) : c;
+        if (got_ < MSG_MAX) buf_[got_] = (char)b;
+        got_++;
+        break;
+      }
+    }
+    // 본문까지 다 받았으면 (길이 0 프레임 포함) 프레임 완료
+    if (state_ == State::Payload && got_ >= len_) {
+      state_ = State::Header0;
+      if (finishFrame(msg)) return true;
+      if (!open_) return false;
+    }
+  }
+  return false;
+}
+
+bool WsSession::finishFrame(const char*& msg) {
+  const size_t n = got_ < MSG_MAX ? got_ : MSG_MAX;
+  switch (opcode_) {
+    case OP_TEXT:
+      if (!fin_ || len_ > MSG_MAX) return false; // 조각난/너무 긴 메시지는 버림
+      buf_[n] = '\0';
+      msg = buf_;
+      return true;
+    case OP_PING:
+      sendFrame(OP_PONG, (const uint8_t*)buf_, n);
+      return false;
+    case OP_CLOSE:
+      sendFrame(OP_CLOSE, nullptr, 0);
+      close();
+      return false;
+    default:
+      return false; // pong, binary, 이어지는 조각은 무시
+  }
+}
+
+bool WsSession::sendText(const char* s, size_t n) {
+  if (!active()) return false;
+  sendFrame(OP_TEXT, (const uint8_t*)s, n);
+  return true;
+}
+
+void WsSession::sendFrame(uint8_t opcode, const uint8_t* data, size_t n) {
+  uint8_t hdr[4];
+  uint8_t h = 0;
+  hdr[h++] = (uint8_t)(0x80 | opcode);
+  if (n < 126) {
+    hdr[h++] = (uint8_t)n;
+  } else {
+    hdr[h++] = 126;
+    hdr[h++] = (uint8_t)(n >> 8);
+    hdr[h++] = (uint8_t)n;
+  }
+  client_.write(hdr, h);
+  if (n > 0) client_.write(data, n);
+}
+
+void WsSession::close() {
+  if (open_) client_.stop();
+  client_ = WiFiClient();
+  open_ = false;
+  state_ = State::Header0;
+}
@@ -0,0 +1,47 @@
+// WsSession.h
+#ifndef WS_SESSION_H
+#define WS_SESSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include "WiFiS3.h"
+
+// 최소 WebSocket 서버 세션 (RFC 6455, 단일 연결, 동적 할당 없음)
+// - accept(): HTTP 업그레이드 요청에 101 응답 (Sec-WebSocket-Accept = base64(SHA-1(key + GUID)))
+// - poll(): 받은 바이트를 조금씩 읽어 텍스트 메시지 하나가 완성되면 돌려준다.
+//   ping 에는 pong, close 에는 close 로 답한다. MSG_MAX 를 넘는 메시지는 버린다.
+// - sendText(): 마스크 없는 텍스트 프레임 (서버 → 클라이언트)
+class WsSession {
+public:
+  static constexpr uint8_t MSG_MAX     = 104;
+  static constexpr uint8_t READ_BUDGET = 64; // poll() 한 번에 읽는 최대 바이트
+
+  bool active();
+  bool accept(WiFiClient& client, const char* key);
+  bool poll(const char*& msg);
+  bool sendText(const char* s, size_t n);
+  void close();
+  bool owns(const WiFiClient& c) const;
+
+private:
+  enum class State : uint8_t { Header0, Header1, ExtLen, Mask, Payload };
+
+  void sendFrame(uint8_t opcode, const uint8_t* data, size_t n);
+  bool finishFrame(const char*& msg);
+
+  WiFiClient client_;
+  bool       open_{false};
+
+  State    state_{State::Header0};
+  uint8_t  opcode_{0};
+  bool     fin_{false};
+  bool     masked_{false};
+  uint8_t  extLeft_{0};
+  uint8_t  maskPos_{0};
+  uint8_t  mask_[4]{};
+  uint32_t len_{0};
+  uint32_t got_{0};
+  char     buf_[MSG_MAX + 1]{};
+};
+
+#endif // WS_SESSION_H
@@ -2,12 +2,16 @@
 #include <cstdint>
 #include <cstdlib>
 #include "PathRunner.h"
+#include "astarGrid.h"
+#include "astarBitboard.h"
 
 // grid[y][x]: 0 = 통로, 1 = 장애물 (5x5 고정)
-struct AStarResult {
-  bool ok;
-  uint16_t n; // out 경로 길이
-};
+// planAstar<5,5>() / planBitboard<5,5>() 의 얇은 래퍼 (AStarResult 는 astarGrid.h)
+
+// 칸 수 최단 경로 엔진. 둘 다 같은 길이의 경로를 낸다.
+// - Astar    : 인덱스 힙 A* (크기 제한 없음, 작업 메모리 static)
+// - Bitboard : uint64_t 물결 BFS (8x8 이하, 힙/칸별 배열 없음, 훨씬 빠르다)
+enum class PlannerEngine : uint8_t { Astar, Bitboard };
 
 // 성공 시 out[0]=(sx,sy) ... out[n-1]=(gx,gy)
 // 실패 시 ok=false, n=0
@@ -17,6 +21,28 @@ AStarResult planAstar5x5(
   PathRunner::Node* out, uint16_t maxOut
 );
 
+AStarResult planBitboard5x5(
+  const bool grid[5][5],
+  int sx, int sy, int gx, int gy,
+  PathRunner::Node* out, uint16_t maxOut
+);
+
+// engine 으로 고른 플래너로 계획
+AStarResult planPath5x5(
+  PlannerEngine engine,
+  const bool grid[5][5],
+  int sx, int sy, int gx, int gy,
+  PathRunner::Node* out, uint16_t maxOut
+);
+
+// 같은 계획을 지도가 바뀌는 OccupancyGrid 에서 (스케치의 gridMap, 변환 없음)
+AStarResult planPath5x5(
+  PlannerEngine engine,
+  const OccupancyGrid<5,5>& grid,
+  int sx, int sy, int gx, int gy,
+  PathRunner::Node* out, uint16_t maxOut
+);
+
 // ---- 경로 유효성 검사 (템플릿: x,y 멤버만 있으면 어느 타입이나 허용) ----
 template <typename NodeT>
 static inline bool validatePath5x5(
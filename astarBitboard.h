@@ -0,0 +1,111 @@
+#pragma once
+#include "astarGrid.h"
+
+// 비트보드 BFS 경로 계획 (8x8 이하, 4-이웃, 한 칸 비용=1)
+// - 칸 (x, y) 는 uint64_t 의 비트 y*8 + x. 지도 전체(통로 = 1)가 정수 하나에 들어간다.
+// - 물결(wavefront): 다음 층 = (지금 층을 상하좌우로 한 칸 민 것) & 통로 & ~이미 닿은 칸.
+//   층 하나에 시프트 4번과 마스크 몇 번이며 칸별 closed/open/g/f 배열과 힙이 없다.
+// - 층 마스크는 거리 mod 3 으로 접어 세 개만 둔다. 이웃 칸끼리는 거리가 1 이하로 차이 나므로
+//   목표에서 거꾸로 갈 때 (지금 층 - 1) mod 3 마스크에 든 이웃이 곧 한 층 앞이다.
+//   고를 수 있으면 직전과 같은 방향을 골라 꺾임을 줄인다.
+// - 칸 수 최단이므로 planAstar 와 길이가 같다 (같은 길이 중 고르는 경로는 다를 수 있다).
+// 작업 메모리는 스택의 uint64_t 몇 개뿐이다 (층별 배열 없음).
+
+namespace bitboard_detail {
+
+static constexpr uint8_t  STRIDE = 8;
+static constexpr uint64_t COL0   = 0x0101010101010101ULL; // x = 0 열
+static constexpr uint64_t COL7   = COL0 << 7;             // x = 7 열
+
+inline uint64_t bit(int x, int y) { return 1ULL << (y * STRIDE + x); }
+
+// 한 칸 이웃으로 번진 칸들 (좌우는 줄을 넘어가지 않게 끝 열을 지운다)
+inline uint64_t spread(uint64_t b) {
+  return (b << STRIDE) | (b >> STRIDE) | ((b & ~COL7) << 1) | ((b & ~COL0) >> 1);
+}
+
+} // namespace bitboard_detail
+
+// 지도 → 통로 비트보드 (지도가 바뀔 때만 다시 만들면 된다)
+template <int W, int H>
+uint64_t bitboardFree(const OccupancyGrid<W, H>& grid) {
+  static_assert(W <= 8 && H <= 8, "bitboard planner supports grids up to 8x8");
+  uint64_t passable = 0;
+  for (int y = 0; y < H; ++y)
+    for (int x = 0; x < W; ++x)
+      if (!grid.blocked(x, y)) passable |= bitboard_detail::bit(x, y);
+  return passable;
+}
+
+// 출력 규약은 planAstar 와 같다: 성공 시 out[0]=(sx,sy) ... out[n-1]=(gx,gy).
+// passable 은 bitboardFree() 결과 (격자 밖 비트는 0 이어야 한다).
+template <int W, int H, typename NodeT>
+AStarResult planBitboard(
+  uint64_t passable,
+  int sx, int sy, int gx, int gy,
+  NodeT* out, uint16_t maxOut
+){
+  using namespace bitboard_detail;
+  static_assert(W <= 8 && H <= 8, "bitboard planner supports grids up to 8x8");
+
+  AStarResult res{false, 0};
+  if (!OccupancyGrid<W, H>::inBounds(sx, sy) || !OccupancyGrid<W, H>::inBounds(gx, gy)) return res;
+  const uint64_t goal = bit(gx, gy);
+  if (!(passable & bit(sx, sy)) || !(passable & goal)) return res; // 시작/목표 막힘
+
+  // 물결: front = 출발점에서 정확히 k 칸인 칸들, layer[d] = 거리 mod 3 이 d 인 칸들
+  uint64_t front = bit(sx, sy);
+  uint64_t seen = front;
+  uint64_t layer[3] = {front, 0, 0};
+  uint16_t k = 0;
+  uint8_t  r = 0; // k mod 3
+  while (!(front & goal)) {
+    front = spread(front) & passable & ~seen;
+    if (!front) break; // 닿을 수 없음
+    seen |= front;
+    k++;
+    r = r == 2 ? 0 : (uint8_t)(r + 1);
+    layer[r] |= front;
+  }
+  res.expanded = (uint16_t)__builtin_popcountll(seen); // 물결이 닿은 칸 수
+  if (!front) return res;
+
+  const uint32_t n = (uint32_t)k + 1;
+  if (n > maxOut) return res;
+
+  // 목표에서 거꾸로: 한 층 앞(mod 3)의 이웃 칸으로 (직전 방향 우선)
+  using astar_detail::DX;
+  using astar_detail::DY;
+  int x = gx, y = gy;
+  uint8_t dir = 0;
+  for (uint32_t i = n; i-- > 0; ) {
+    out[i] = NodeT{};
+    out[i].x = x;
+    out[i].y = y;
+    if (i == 0) break;
+    r = r == 0 ? 2 : (uint8_t)(r - 1);
+    for (uint8_t t = 0; t < 5; ++t) {
+      const uint8_t d = t == 0 ? dir : (uint8_t)(t - 1);
+      const int px = x - DX[d], py = y - DY[d];
+      if (OccupancyGrid<W, H>::inBounds(px, py) && (layer[r] & bit(px, py))) {
+        x = px;
+        y = py;
+        dir = d;
+        break;
+      }
+    }
+  }
+
+  res.ok = true;
+  res.n  = (uint16_t)n;
+  return res;
+}
+
+template <int W, int H, typename NodeT>
+AStarResult planBitboard(
+  const OccupancyGrid<W, H>& grid,
+  int sx, int sy, int gx, int gy,
+  NodeT* out, uint16_t maxOut
+){
+  return planBitboard<W, H>(bitboardFree(grid), sx, sy, gx, gy, out, maxOut);
+}
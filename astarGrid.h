@@ -0,0 +1,269 @@
+#pragma once
+#include <cstdint>
+#include <cstdlib>
+
+// 크기 일반화 A* (4-이웃, 한 칸 비용=1, 맨해튼 휴리스틱)
+// - OccupancyGrid<W,H>: 칸당 1비트 점유 지도
+// - AstarWorkspace<W,H>: 탐색용 작업 메모리 (칸당 6.25바이트, 스택 밖에 둔다)
+// - planAstar<W,H>(): 인덱스 이진 힙(decrease-key) 으로 O(N log N)
+//
+// 좌표계는 planAstar5x5 와 같다: grid(x,y), y+1 = UP.
+
+struct AStarResult {
+  bool ok;
+  uint16_t n;        // out 경로 길이
+  uint16_t expanded = 0; // 탐색 엔진이 전개한 칸 수 (표 조회는 0, 벤치/진단용)
+};
+
+// ---- 비트 패킹 점유 지도: 1 = 장애물 ----
+template <int W, int H>
+class OccupancyGrid {
+public:
+  static_assert(W > 0 && H > 0, "grid must not be empty");
+  static constexpr int      WIDTH  = W;
+  static constexpr int      HEIGHT = H;
+  static constexpr uint32_t CELLS  = (uint32_t)W * H;
+
+  OccupancyGrid() { clear(); }
+
+  static bool inBounds(int x, int y) { return 0 <= x && x < W && 0 <= y && y < H; }
+
+  void clear() { for (auto& w : bits_) w = 0; }
+
+  bool blocked(int x, int y) const {
+    const uint32_t i = (uint32_t)y * W + x;
+    return (bits_[i >> 5] >> (i & 31)) & 1u;
+  }
+
+  void set(int x, int y, bool isBlocked) {
+    const uint32_t i = (uint32_t)y * W + x;
+    if (isBlocked) bits_[i >> 5] |=  (1u << (i & 31));
+    else           bits_[i >> 5] &= ~(1u << (i & 31));
+  }
+
+  // grid[y][x] 형태의 bool 배열에서 변환
+  void load(const bool (&g)[H][W]) {
+    for (int y = 0; y < H; ++y)
+      for (int x = 0; x < W; ++x)
+        set(x, y, g[y][x]);
+  }
+
+private:
+  uint32_t bits_[(CELLS + 31) / 32];
+};
+
+// ---- 탐색 작업 메모리 ----
+namespace astar_detail {
+// 작업 메모리 pos[] 의 특수값
+static constexpr uint16_t POS_UNSEEN = 0xFFFF; // 아직 열린 적 없음
+static constexpr uint16_t POS_CLOSED = 0xFFFE; // 확정됨
+} // namespace astar_detail
+
+template <int W, int H>
+struct AstarWorkspace {
+  static constexpr uint32_t N = (uint32_t)W * H;
+  static_assert(N < 0xFFFE, "grid too large for 16-bit node indices");
+
+  uint16_t g[N];
+  uint16_t heap[N];        // 열린 목록 (노드 인덱스)
+  uint16_t pos[N];         // 힙 안 위치 또는 POS_UNSEEN/POS_CLOSED
+  uint8_t  from[(N + 3) / 4]; // 이 칸에 들어올 때의 이동 방향 (2비트)
+  uint16_t heapLen;
+};
+
+namespace astar_detail {
+
+// 이동 방향: 0=RIGHT(+x) 1=LEFT(-x) 2=UP(+y) 3=DOWN(-y)
+static constexpr int DX[4] = {1, -1, 0, 0};
+static constexpr int DY[4] = {0, 0, 1, -1};
+
+// 인덱스 이진 힙 (decrease-key 지원). 배열은 호출자 작업 메모리를 쓴다.
+// pos[v] 는 힙 안 위치이며, 탐색 전에 호출자가 POS_UNSEEN 으로 채운다.
+template <typename Less>
+class IndexedHeap {
+public:
+  IndexedHeap(uint16_t* heap, uint16_t* pos, uint16_t& len, Less less)
+  : heap_(heap), pos_(pos), len_(len), less_(less) { len_ = 0; }
+
+  bool empty() const { return len_ == 0; }
+
+  // 새 노드 삽입 또는 키가 줄어든 노드 위치 갱신
+  void pushOrDecrease(uint16_t v) {
+    uint16_t i = pos_[v];
+    if (i == POS_UNSEEN) {
+      i = len_++;
+      heap_[i] = v;
+    }
+    siftUp(i);
+  }
+
+  // 힙 안(열림) 여부. pop 된 노드(POS_CLOSED)와 POS_UNSEEN 은 밖에 있다.
+  bool contains(uint16_t v) const { return pos_[v] < POS_CLOSED; }
+  uint16_t top() const { return heap_[0]; }
+
+  // 힙 안 노드의 키가 바뀐 뒤 위치 복구 (증가/감소 모두)
+  void update(uint16_t v) {
+    siftUp(pos_[v]);
+    siftDown(pos_[v]);
+  }
+
+  // 힙 안 노드 제거. 제거된 노드는 POS_UNSEEN 이 되어 다시 넣을 수 있다.
+  void remove(uint16_t v) {
+    const uint16_t i = pos_[v];
+    const uint16_t last = heap_[--len_];
+    pos_[v] = POS_UNSEEN;
+    if (i < len_) {
+      place(i, last);
+      update(last);
+    }
+  }
+
+  uint16_t pop() {
+    const uint16_t top = heap_[0];
+    const uint16_t last = heap_[--len_];
+    pos_[top] = POS_CLOSED;
+    if (len_ > 0) {
+      heap_[0] = last;
+      pos_[last] = 0;
+      siftDown(0);
+    }
+    return top;
+  }
+
+private:
+  void place(uint16_t i, uint16_t v) { heap_[i] = v; pos_[v] = i; }
+
+  void siftUp(uint16_t i) {
+    const uint16_t v = heap_[i];
+    while (i > 0) {
+      const uint16_t p = (uint16_t)((i - 1) / 2);
+      if (!less_(v, heap_[p])) break;
+      place(i, heap_[p]);
+      i = p;
+    }
+    place(i, v);
+  }
+
+  void siftDown(uint16_t i) {
+    const uint16_t v = heap_[i];
+    while (true) {
+      uint16_t c = (uint16_t)(2 * i + 1);
+      if (c >= len_) break;
+      if (c + 1 < len_ && less_(heap_[c + 1], heap_[c])) c++;
+      if (!less_(heap_[c], v)) break;
+      place(i, heap_[c]);
+      i = c;
+    }
+    place(i, v);
+  }
+
+  uint16_t* heap_;
+  uint16_t* pos_;
+  uint16_t& len_;
+  Less less_;
+};
+
+template <typename Less>
+IndexedHeap<Less> makeHeap(uint16_t* heap, uint16_t* pos, uint16_t& len, Less less) {
+  return IndexedHeap<Less>(heap, pos, len, less);
+}
+
+} // namespace astar_detail
+
+// 성공 시 out[0]=(sx,sy) ... out[n-1]=(gx,gy)
+// 실패(막힘/경로 없음/maxOut 부족) 시 ok=false, n=0
+// NodeT 는 x,y 멤버를 가진 집합체면 된다 (PathRunner::Node 등).
+template <int W, int H, typename NodeT>
+AStarResult planAstar(
+  const OccupancyGrid<W, H>& grid,
+  int sx, int sy, int gx, int gy,
+  NodeT* out, uint16_t maxOut,
+  AstarWorkspace<W, H>& ws
+){
+  using Ws = AstarWorkspace<W, H>;
+  using namespace astar_detail;
+
+  AStarResult res{false, 0};
+  if (!grid.inBounds(sx, sy) || !grid.inBounds(gx, gy)) return res;
+  if (grid.blocked(sx, sy) || grid.blocked(gx, gy)) return res; // 시작/목표 막힘
+
+  for (uint32_t i = 0; i < Ws::N; ++i) ws.pos[i] = POS_UNSEEN;
+
+  // f 가 작은 쪽, 같으면 g 가 큰(목표에 가까운) 쪽 우선
+  auto h = [gx, gy](uint16_t v) -> uint32_t {
+    return (uint32_t)(abs((int)(v % W) - gx) + abs((int)(v / W) - gy));
+  };
+  auto less = [&ws, h](uint16_t a, uint16_t b) {
+    const uint32_t fa = ws.g[a] + h(a), fb = ws.g[b] + h(b);
+    return fa != fb ? fa < fb : ws.g[a] > ws.g[b];
+  };
+  auto open = makeHeap(ws.heap, ws.pos, ws.heapLen, less);
+  const uint16_t sidx = (uint16_t)(sy * W + sx);
+  const uint16_t goal = (uint16_t)(gy * W + gx);
+  ws.g[sidx] = 0;
+  open.pushOrDecrease(sidx);
+
+  bool found = false;
+  while (!open.empty()) {
+    const uint16_t cur = open.pop();
+    res.expanded++;
+    if (cur == goal) { found = true; break; }
+
+    const int cx = cur % W, cy = cur / W;
+    const uint16_t ng = (uint16_t)(ws.g[cur] + 1); // 한 칸 비용=1
+    for (uint8_t d = 0; d < 4; ++d) {
+      const int nx = cx + DX[d], ny = cy + DY[d];
+      if (!grid.inBounds(nx, ny) || grid.blocked(nx, ny)) continue;
+      const uint16_t ni = (uint16_t)(ny * W + nx);
+      const uint16_t p = ws.pos[ni];
+      if (p == POS_CLOSED) continue;
+      if (p != POS_UNSEEN && ng >= ws.g[ni]) continue;
+      ws.g[ni] = ng;
+      ws.from[ni >> 2] = (uint8_t)((ws.from[ni >> 2] & ~(3u << ((ni & 3) * 2))) | (d << ((ni & 3) * 2)));
+      open.pushOrDecrease(ni);
+    }
+  }
+  if (!found) return res;
+
+  // 역추적: 길이는 g+1 이므로 임시 버퍼 없이 뒤에서부터 채운다
+  const uint32_t n = (uint32_t)ws.g[goal] + 1;
+  if (n > maxOut) return res;
+  int x = gx, y = gy;
+  for (uint32_t k = n; k-- > 0; ) {
+    out[k] = NodeT{};
+    out[k].x = x;
+    out[k].y = y;
+    if (k == 0) break;
+    const uint16_t i = (uint16_t)(y * W + x);
+    const uint8_t d = (ws.from[i >> 2] >> ((i & 3) * 2)) & 3u;
+    x -= DX[d];
+    y -= DY[d];
+  }
+
+  res.ok = true;
+  res.n  = (uint16_t)n;
+  return res;
+}
+
+// 작업 메모리를 함수 내부 static 으로 두는 편의 버전 (재진입 불가)
+template <int W, int H, typename NodeT>
+AStarResult planAstar(
+  const OccupancyGrid<W, H>& grid,
+  int sx, int sy, int gx, int gy,
+  NodeT* out, uint16_t maxOut
+){
+  static AstarWorkspace<W, H> ws;
+  return planAstar<W, H>(grid, sx, sy, gx, gy, out, maxOut, ws);
+}
+
+// 경로 유효성 검사 (validatePath5x5 의 크기 일반화): 격자 안, 장애물 아님, 이웃 칸끼리만
+template <int W, int H, typename NodeT>
+bool validatePath(const OccupancyGrid<W, H>& grid, const NodeT* p, uint16_t n) {
+  if (!p || n == 0) return false;
+  for (uint16_t i = 0; i < n; ++i) {
+    const int x = p[i].x, y = p[i].y;
+    if (!grid.inBounds(x, y) || grid.blocked(x, y)) return false;
+    if (i + 1 < n && abs(p[i + 1].x - x) + abs(p[i + 1].y - y) != 1) return false; // 비인접
+  }
+  return true;
+}
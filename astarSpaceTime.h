@@ -0,0 +1,383 @@
+#pragma once
+#include "astarTimed.h"
+
+// 여러 대가 같은 바닥을 쓸 때의 시공간 경로 계획 (SIPP: safe interval path planning)
+// - ReservationTable : 로봇들이 (칸, 시간창 [t0, t1)) 을 쓰겠다고 올려 둔 공용 예약표.
+//   고정 크기 배열, 선형 탐색 (칸 수십 개 × 로봇 몇 대 규모).
+// - planSpaceTime()  : planTimed 와 같은 (x, y, heading) 상태와 gridMove 실제 동작 시간에
+//   "다른 로봇이 비워 둔 구간(안전 구간)" 을 더한 A*. 상태 = (칸, heading, 안전 구간).
+//   기다리기는 따로 된 동작이 아니라 다음 칸이 빌 때까지 출발을 늦추는 것으로 다룬다.
+//   같은 안전 구간이면 일찍 도착할수록 좋으므로 상태마다 가장 이른 도착 시각만 남긴다.
+// - 이동 중에는 떠나는 칸과 들어가는 칸을 모두 쓰는 것으로 본다 (맞바꾸기/따라붙기 충돌 방지).
+// - 시각 [ms] 은 표를 쓰는 모든 쪽이 같은 원점으로 잰 값이어야 한다. 플래너는 원점을 모른다.
+//   스케치는 millis() 를 그대로 쓰지 않고 holdClockMs 기준 상대 시각을 쓴다 (sharingFloor() 가
+//   advance() 로 원점을 지금으로 옮기므로 계획 시각 0 = 지금). 호스트 fleet 벤치는 가상 시계 절대값.
+//   ST_FOREVER 는 "끝없음" 표시이므로 실제 시각이 거기 닿지 않게 한다.
+//
+// 출력은 planTimed 와 같은 칸 목록이고, out[i].waitMs 는 out[i-1] 에서 (dwell 과 회전 뒤에)
+// 그만큼 더 기다렸다가 out[i] 로 출발하라는 뜻이다. PathRunner 가 dwell 과 합쳐 Pause 로 넣는다.
+// 경로를 직선 병합 없이 칸마다 (dwell 포함) 실행한다고 보고 시간을 잰다.
+//
+// 우선순위 계획: 로봇 하나를 계획하면 reservePlan() 으로 그 경로의 시간창을 표에 올리고,
+// 다음 로봇은 그것을 피해 계획한다. 도착 칸은 holdMs 동안 (ST_FOREVER 면 다음 계획까지) 잡는다.
+
+static constexpr uint32_t ST_FOREVER     = 0xFFFFFFFFUL;
+static constexpr uint32_t ST_MAX_WAIT_MS = 50000; // 한 칸에서 한 번에 기다리는 최대 시간 (Node::waitMs 16비트)
+
+struct Reservation {
+  uint32_t t0;     // [t0, t1) 동안 사용
+  uint32_t t1;     // ST_FOREVER 면 끝없음
+  uint16_t cell;   // y * W + x
+  uint8_t  agent;
+};
+
+template <uint16_t CAP>
+class ReservationTable {
+public:
+  static constexpr uint16_t CAPACITY = CAP;
+
+  void clear() { n_ = 0; }
+  uint16_t size() const { return n_; }
+  const Reservation& at(uint16_t i) const { return r_[i]; }
+
+  // 표가 가득 차면 false (빈 시간창은 넣지 않고 true)
+  bool reserve(uint8_t agent, uint16_t cell, uint32_t t0, uint32_t t1) {
+    if (t1 <= t0) return true;
+    if (n_ >= CAP) return false;
+    r_[n_++] = Reservation{t0, t1, cell, agent};
+    return true;
+  }
+
+  // agent 가 올린 시간창을 모두 지운다 (다시 계획해 올리기 전)
+  void release(uint8_t agent) {
+    removeIf([agent](const Reservation& r) { return r.agent == agent; });
+  }
+  // now 이전에 끝난 시간창을 지운다
+  void expire(uint32_t now) {
+    removeIf([now](const Reservation& r) { return r.t1 <= now; });
+  }
+
+  // 시각 원점을 dt 만큼 뒤로 옮긴다 (옛 시각 dt 가 새 0). 그 전에 끝난 시간창은 지우고,
+  // 이미 시작한 시간창은 0 부터로 자른다. 상대 시각만 쓰면 시계가 한 바퀴 돌아도 비교가 맞다.
+  void advance(uint32_t dt) {
+    expire(dt);
+    for (uint16_t i = 0; i < n_; ++i) {
+      Reservation& r = r_[i];
+      r.t0 = r.t0 > dt ? r.t0 - dt : 0;
+      if (r.t1 != ST_FOREVER) r.t1 -= dt;
+    }
+  }
+
+  // agent 가 아닌 로봇이 cell 을 [t0, t1) 중에 쓰는지
+  bool busy(uint16_t cell, uint32_t t0, uint32_t t1, uint8_t agent) const {
+    for (uint16_t i = 0; i < n_; ++i) {
+      const Reservation& r = r_[i];
+      if (r.cell == cell && r.agent != agent && r.t0 < t1 && t0 < r.t1) return true;
+    }
+    return false;
+  }
+
+  // t 이후 cell 이 처음 비는 시각 (이어지거나 겹친 시간창을 따라간다). 영영 안 비면 ST_FOREVER.
+  uint32_t freeFrom(uint16_t cell, uint32_t t, uint8_t agent) const {
+    bool moved = true;
+    while (moved && t != ST_FOREVER) {
+      moved = false;
+      for (uint16_t i = 0; i < n_; ++i) {
+        const Reservation& r = r_[i];
+        if (r.cell == cell && r.agent != agent && r.t0 <= t && t < r.t1) { t = r.t1; moved = true; }
+      }
+    }
+    return t;
+  }
+
+  // 비어 있는 시각 t 가 속한 안전 구간의 끝 (다음 시간창의 시작). 없으면 ST_FOREVER.
+  uint32_t freeUntil(uint16_t cell, uint32_t t, uint8_t agent) const {
+    uint32_t hi = ST_FOREVER;
+    for (uint16_t i = 0; i < n_; ++i) {
+      const Reservation& r = r_[i];
+      if (r.cell == cell && r.agent != agent && r.t0 > t && r.t0 < hi) hi = r.t0;
+    }
+    return hi;
+  }
+
+  // 비어 있는 시각 t 가 속한 안전 구간의 시작 (구간을 구별하는 값)
+  uint32_t freeSince(uint16_t cell, uint32_t t, uint8_t agent) const {
+    uint32_t lo = 0;
+    for (uint16_t i = 0; i < n_; ++i) {
+      const Reservation& r = r_[i];
+      if (r.cell == cell && r.agent != agent && r.t1 <= t && r.t1 > lo) lo = r.t1;
+    }
+    return lo;
+  }
+
+private:
+  template <typename Pred>
+  void removeIf(Pred pred) {
+    uint16_t k = 0;
+    for (uint16_t i = 0; i < n_; ++i) {
+      if (!pred(r_[i])) r_[k++] = r_[i];
+    }
+    n_ = k;
+  }
+
+  Reservation r_[CAP];
+  uint16_t    n_{0};
+};
+
+struct SpaceTimeResult {
+  bool     ok;
+  uint16_t n;           // out 경로 길이 (칸 수)
+  uint32_t arriveMs;    // 도착 칸에 goalHeading 으로 서는 시각 (startMs 와 같은 원점)
+  uint8_t  endHeading;
+  uint16_t states;      // 만든 상태 수 (작업 메모리 여유 확인용)
+  uint16_t expanded;    // 전개한 상태 수
+};
+
+// 상태 풀: (칸, heading) 마다 안전 구간별 상태를 연결 목록으로 둔다.
+// 상태 하나 16바이트 + 힙 4바이트. MAXS 가 모자라면 그 이후 상태는 버린다 (계획 실패 가능).
+template <int W, int H, uint16_t MAXS = 256>
+struct SpaceTimeWorkspace {
+  static constexpr uint32_t CELL_STATES = (uint32_t)W * H * 4;
+  static constexpr uint16_t MAX_STATES  = MAXS;
+  static_assert(CELL_STATES < 0xFFFE, "grid too large for 16-bit state indices");
+  static_assert(MAXS < 0xFFFE, "too many states for 16-bit indices");
+
+  struct State {
+    uint32_t g;       // 이 상태에 (dwell/회전까지 끝내고) 서는 시각
+    uint32_t since;   // 안전 구간 시작 (freeSince)
+    uint16_t cs;      // (칸 << 2) | heading
+    uint16_t parent;
+    uint16_t next;    // 같은 (칸, heading) 의 다음 상태
+    uint8_t  move;    // 이 상태로 들어온 동작 (astar_timed_detail::MV_*)
+  };
+
+  State    st[MAXS];
+  uint16_t first[CELL_STATES];
+  uint16_t heap[MAXS];
+  uint16_t pos[MAXS];
+  uint16_t heapLen;
+  uint16_t used;
+};
+
+namespace astar_st_detail {
+
+static constexpr uint16_t NONE = 0xFFFF;
+
+// gridMove::rotationsTo 와 같은 최소 회전 수
+inline uint8_t turns(uint8_t from, uint8_t to) {
+  return from == to ? 0 : (from ^ 1) == to ? 2 : 1;
+}
+
+// 인접 칸 이동 (dx, dy) 의 heading
+inline uint8_t headingOf(int dx, int dy) {
+  return (dx > 0) ? 3 : (dx < 0) ? 2 : (dy > 0) ? 0 : 1;
+}
+
+} // namespace astar_st_detail
+
+// (sx, sy, sHeading) 에서 startMs 에 출발해 (gx, gy) 에 도착, 그 칸을 holdMs 동안 쓸 수 있는 가장 이른 경로.
+// agent 자신이 올린 시간창은 무시한다. sHeading 은 실제 방향이어야 한다 (TIMED_ANY_HEADING 불가).
+template <int W, int H, uint16_t MAXS, typename TableT, typename NodeT>
+SpaceTimeResult planSpaceTime(
+  const OccupancyGrid<W, H>& grid, const TableT& table, uint8_t agent,
+  int sx, int sy, uint8_t sHeading, uint32_t startMs,
+  int gx, int gy, uint32_t holdMs,
+  const MoveCosts& costs,
+  NodeT* out, uint16_t maxOut,
+  SpaceTimeWorkspace<W, H, MAXS>& ws,
+  uint8_t goalHeading = TIMED_ANY_HEADING
+){
+  using namespace astar_detail;
+  using namespace astar_timed_detail;
+  using namespace astar_st_detail;
+  using Ws = SpaceTimeWorkspace<W, H, MAXS>;
+
+  SpaceTimeResult res{false, 0, 0, sHeading, 0, 0};
+  if (!grid.inBounds(sx, sy) || !grid.inBounds(gx, gy)) return res;
+  if (sHeading > 3) return res;
+  if (goalHeading > 3 && goalHeading != TIMED_ANY_HEADING) return res;
+  if (grid.blocked(sx, sy) || grid.blocked(gx, gy)) return res;
+
+  const uint16_t startCell = (uint16_t)(sy * W + sx);
+  const uint16_t goalCell  = (uint16_t)(gy * W + gx);
+  if (table.freeFrom(startCell, startMs, agent) != startMs) return res; // 지금 있는 칸을 남이 쓰고 있음
+
+  for (uint32_t i = 0; i < Ws::CELL_STATES; ++i) ws.first[i] = NONE;
+  ws.used = 0;
+
+  uint32_t cellMin = costs.forwardMs;
+  if (costs.allowReverse && costs.backwardMs < cellMin) cellMin = costs.backwardMs;
+  cellMin += costs.dwellMs;
+
+  auto h = [&ws, gx, gy, cellMin](uint16_t s) -> uint32_t {
+    const int c = ws.st[s].cs >> 2;
+    return (uint32_t)(abs(c % W - gx) + abs(c / W - gy)) * cellMin;
+  };
+  auto less = [&ws, h](uint16_t a, uint16_t b) {
+    const uint32_t fa = ws.st[a].g + h(a), fb = ws.st[b].g + h(b);
+    return fa != fb ? fa < fb : ws.st[a].g > ws.st[b].g;
+  };
+  auto open = makeHeap(ws.heap, ws.pos, ws.heapLen, less);
+
+  // (cs, since) 상태를 찾거나 만든다. 풀이 가득 차면 NONE.
+  auto stateOf = [&ws](uint16_t cs, uint32_t since) -> uint16_t {
+    for (uint16_t s = ws.first[cs]; s != NONE; s = ws.st[s].next) {
+      if (ws.st[s].since == since) return s;
+    }
+    if (ws.used >= MAXS) return NONE;
+    const uint16_t s = ws.used++;
+    ws.st[s] = typename Ws::State{ST_FOREVER, since, cs, NONE, ws.first[cs], MV_FORWARD};
+    ws.first[cs] = s;
+    ws.pos[s] = POS_UNSEEN;
+    return s;
+  };
+  auto relax = [&](uint16_t cs, uint32_t since, uint32_t ng, uint16_t parent, uint8_t mv) {
+    const uint16_t s = stateOf(cs, since);
+    if (s == NONE || ws.pos[s] == POS_CLOSED) return;
+    if (ws.pos[s] != POS_UNSEEN && ng >= ws.st[s].g) return;
+    ws.st[s].g = ng;
+    ws.st[s].parent = parent;
+    ws.st[s].move = mv;
+    open.pushOrDecrease(s);
+  };
+
+  const uint16_t start = stateOf((uint16_t)((startCell << 2) | sHeading), table.freeSince(startCell, startMs, agent));
+  ws.st[start].g = startMs;
+  open.pushOrDecrease(start);
+
+  int goalState = -1;
+  while (!open.empty()) {
+    const uint16_t cur = open.pop();
+    res.expanded++;
+    const uint16_t c = ws.st[cur].cs >> 2;
+    const uint8_t hd = ws.st[cur].cs & 3;
+    const uint32_t g = ws.st[cur].g;
+    const uint32_t hi = table.freeUntil(c, g, agent); // 이 칸에 머물 수 있는 끝
+
+    if (c == goalCell && (goalHeading == TIMED_ANY_HEADING || hd == goalHeading) &&
+        (hi == ST_FOREVER || (holdMs != ST_FOREVER && hi - g >= holdMs))) {
+      goalState = cur;
+      break;
+    }
+
+    // 제자리 회전: 안전 구간 안에 끝나야 한다
+    if (hi == ST_FOREVER || g + costs.rotateMs < hi) {
+      relax((uint16_t)((c << 2) | CW[hd]),  ws.st[cur].since, g + costs.rotateMs, cur, MV_CW);
+      relax((uint16_t)((c << 2) | CCW[hd]), ws.st[cur].since, g + costs.rotateMs, cur, MV_CCW);
+    }
+
+    // 전진/후진: 다음 칸의 안전 구간마다 가장 이른 출발 하나씩.
+    // 출발 a 부터 도착(a + 이동)까지 지금 칸도 계속 쓰므로 a + 이동 <= hi 여야 한다.
+    const int cx = c % W, cy = c / W;
+    for (uint8_t back = 0; back < 2; ++back) {
+      if (back && !costs.allowReverse) break;
+      const int sign = back ? -1 : 1;
+      const int nx = cx + sign * HDX[hd], ny = cy + sign * HDY[hd];
+      if (!grid.inBounds(nx, ny) || grid.blocked(nx, ny)) continue;
+      const uint16_t nc = (uint16_t)(ny * W + nx);
+      const uint32_t d = back ? costs.backwardMs : costs.forwardMs;
+
+      uint32_t a = table.freeFrom(nc, g, agent);
+      while (a != ST_FOREVER && a - g <= ST_MAX_WAIT_MS && (hi == ST_FOREVER || a + d <= hi)) {
+        const uint32_t b = table.freeUntil(nc, a, agent);
+        const uint32_t arrive = a + d + costs.dwellMs;
+        if (b == ST_FOREVER || arrive < b) {
+          relax((uint16_t)((nc << 2) | hd), table.freeSince(nc, a, agent), arrive, cur,
+                back ? MV_BACKWARD : MV_FORWARD);
+        }
+        if (b == ST_FOREVER) break;
+        a = table.freeFrom(nc, b, agent);
+      }
+    }
+  }
+  res.states = ws.used;
+  if (goalState < 0) return res;
+
+  // 역추적 1: 칸 수 세기
+  uint32_t n = 1;
+  for (uint16_t s = (uint16_t)goalState; s != start; s = ws.st[s].parent) {
+    const uint8_t mv = ws.st[s].move;
+    if (mv == MV_FORWARD || mv == MV_BACKWARD) n++;
+  }
+  if (n > maxOut) return res;
+
+  // 역추적 2: 뒤에서부터 채우기. 칸 i 의 기다림 = 출발 시각 - (칸 i-1 에 서는 시각 + 최소 회전).
+  // 탐색이 최소보다 많이 돌았더라도 gridMove 는 최소로 돌므로 그 차이도 기다림이 된다.
+  uint32_t k = n - 1;
+  uint32_t pendDepart = 0;   // 칸 k+1 로의 출발 시각
+  uint8_t  pendHeading = 0;  // 그 이동의 heading
+  for (uint16_t s = (uint16_t)goalState; ; s = ws.st[s].parent) {
+    const typename Ws::State& st = ws.st[s];
+    const bool first = (s == start);
+    if (first || st.move == MV_FORWARD || st.move == MV_BACKWARD) {
+      if (k + 1 < n) {
+        const uint32_t ready = st.g + turns((uint8_t)(st.cs & 3), pendHeading) * costs.rotateMs;
+        const uint32_t wait = pendDepart - ready;
+        if (pendDepart < ready || wait > 0xFFFF) return res;
+        out[k + 1].waitMs = (uint16_t)wait;
+      }
+      const int c = st.cs >> 2;
+      out[k] = NodeT{};
+      out[k].x = c % W;
+      out[k].y = c / W;
+      out[k].reverse = !first && st.move == MV_BACKWARD;
+      if (first) break;
+      pendDepart = st.g - costs.dwellMs - (st.move == MV_BACKWARD ? costs.backwardMs : costs.forwardMs);
+      pendHeading = (uint8_t)(st.cs & 3);
+      k--;
+    }
+  }
+
+  res.ok = true;
+  res.n = (uint16_t)n;
+  res.arriveMs = ws.st[goalState].g - (n > 1 ? costs.dwellMs : 0); // 마지막 칸 뒤에는 dwell 없음
+  res.endHeading = (uint8_t)(ws.st[goalState].cs & 3);
+  return res;
+}
+
+// planSpaceTime 경로의 시간창을 표에 올린다 (PathRunner 가 칸마다 실행하는 시각 그대로).
+// 칸마다 [들어가기 시작, 다 빠져나감) 이고, 마지막 칸은 holdUntilMs 까지 (ST_FOREVER 가능).
+// marginMs 만큼 앞뒤를 넓혀 실제 주행이 예상보다 빠르거나 늦어도 겹치지 않게 한다.
+// 표가 모자라면 false (일부만 올라가 있으므로 호출자가 release 한다).
+template <int W, typename TableT, typename NodeT>
+bool reservePlan(TableT& table, uint8_t agent, const NodeT* path, uint16_t n,
+                 uint8_t sHeading, uint32_t startMs, const MoveCosts& costs,
+                 uint32_t holdUntilMs, uint32_t marginMs)
+{
+  using namespace astar_st_detail;
+  if (n == 0) return true;
+  auto lo = [marginMs](uint32_t t) { return t > marginMs ? t - marginMs : 0; };
+
+  uint32_t t = startMs;      // 지금 칸에서 출발 준비가 되는 시각
+  uint32_t enter = startMs;  // 지금 칸에 들어가기 시작한 시각
+  uint8_t  hd = sHeading;
+  for (uint16_t i = 1; i < n; ++i) {
+    const uint8_t dir = headingOf(path[i].x - path[i - 1].x, path[i].y - path[i - 1].y);
+    const uint8_t need = path[i].reverse ? (uint8_t)(dir ^ 1) : dir;
+    const uint32_t depart = t + turns(hd, need) * costs.rotateMs + path[i].waitMs;
+    const uint32_t d = path[i].reverse ? costs.backwardMs : costs.forwardMs;
+    const uint16_t cell = (uint16_t)(path[i - 1].y * W + path[i - 1].x);
+    if (!table.reserve(agent, cell, lo(enter), depart + d + marginMs)) return false;
+    enter = depart;
+    t = depart + d + costs.dwellMs;
+    hd = need;
+  }
+  const uint16_t last = (uint16_t)(path[n - 1].y * W + path[n - 1].x);
+  const uint32_t until = holdUntilMs == ST_FOREVER ? ST_FOREVER : holdUntilMs + marginMs;
+  return table.reserve(agent, last, lo(enter), until);
+}
+
+// 작업 메모리를 함수 내부 static 으로 두는 편의 버전 (재진입 불가)
+template <int W, int H, typename TableT, typename NodeT>
+SpaceTimeResult planSpaceTime(
+  const OccupancyGrid<W, H>& grid, const TableT& table, uint8_t agent,
+  int sx, int sy, uint8_t sHeading, uint32_t startMs,
+  int gx, int gy, uint32_t holdMs,
+  const MoveCosts& costs,
+  NodeT* out, uint16_t maxOut,
+  uint8_t goalHeading = TIMED_ANY_HEADING
+){
+  static SpaceTimeWorkspace<W, H> ws;
+  return planSpaceTime<W, H>(grid, table, agent, sx, sy, sHeading, startMs, gx, gy, holdMs,
+                             costs, out, maxOut, ws, goalHeading);
+}
@@ -0,0 +1,220 @@
+#pragma once
+#include "astarGrid.h"
+
+// 방향 인지(heading-aware) 최소 시간 경로 계획
+// 상태 = (x, y, heading). 간선 비용은 gridMove 에 설정된 실제 동작 시간:
+//   Forward  : heading 방향으로 한 칸   forwardMs  + dwellMs
+//   Backward : heading 반대로 한 칸     backwardMs + dwellMs (allowReverse 일 때)
+//   RotateCW / RotateCCW : 제자리 90도  rotateMs
+// forwardRunMs 를 주면 PathRunner 의 직선 구간 합치기에 맞춰 한 방향 k 칸을 간선 하나로 본다:
+//   forwardMs + (k-1)×forwardRunMs + dwellMs (가감속과 dwell 은 구간마다 한 번, 후진도 같음)
+// heading 값은 gridMove::Direction 순서를 따른다: 0=UP 1=DOWN 2=LEFT 3=RIGHT.
+//
+// sHeading 에 TIMED_ANY_HEADING 을 주면 네 방향 중 어느 쪽에서 출발해도 되는 것으로 보고
+// (출발 방향을 모를 때의 하한), goalHeading 을 주면 그 방향을 보고 도착해야 끝난다.
+//
+// 출력은 칸 목록이며, out[i].reverse 는 out[i-1]→out[i] 를 후진으로 가라는 뜻이다.
+// 회전은 출력하지 않는다: 각 칸 이동에 필요한 heading 으로의 최소 회전은
+// gridMove::stepTo / stepBackTo 가 그대로 재현한다. 도착 칸에서의 마지막 회전(goalHeading)은
+// 호출자가 맡는다 (costMs 에는 들어 있다).
+
+static constexpr uint8_t TIMED_ANY_HEADING = 0xFF;
+
+struct MoveCosts {
+  uint32_t forwardMs;
+  uint32_t backwardMs;
+  uint32_t rotateMs;
+  uint32_t dwellMs;      // PathRunner 가 칸 이동마다 쉬는 시간
+  bool     allowReverse;
+  uint32_t forwardRunMs = 0;  // 직선 구간에서 한 칸 더 갈 때 (0 이면 칸마다 멈춘다)
+  uint32_t backwardRunMs = 0;
+};
+
+struct TimedResult {
+  bool ok;
+  uint16_t n;          // out 경로 길이 (칸 수)
+  uint32_t costMs;     // 예상 소요 시간
+  uint8_t  endHeading; // 도착 시 heading
+};
+
+template <int W, int H>
+struct TimedWorkspace {
+  static constexpr uint32_t N = (uint32_t)W * H * 4;
+  static_assert(N < 0xFFFE, "grid too large for 16-bit state indices");
+  static_assert(W < 256 && H < 256, "straight runs are counted in 8 bits");
+
+  uint32_t g[N];
+  uint16_t heap[N];
+  uint16_t pos[N];
+  uint8_t  move[(N + 3) / 4]; // 이 상태로 들어온 동작 (2비트)
+  uint8_t  run[N];            // 이 상태로 들어온 직진/후진 칸 수
+  uint16_t heapLen;
+};
+
+namespace astar_timed_detail {
+
+// heading(UP, DOWN, LEFT, RIGHT) 별 전진 방향
+static constexpr int HDX[4] = {0, 0, -1, 1};
+static constexpr int HDY[4] = {1, -1, 0, 0};
+static constexpr uint8_t CW[4]  = {3, 2, 0, 1}; // UP→RIGHT, DOWN→LEFT, LEFT→UP, RIGHT→DOWN
+static constexpr uint8_t CCW[4] = {2, 3, 1, 0}; // UP→LEFT, DOWN→RIGHT, LEFT→DOWN, RIGHT→UP
+
+enum : uint8_t { MV_FORWARD = 0, MV_BACKWARD = 1, MV_CW = 2, MV_CCW = 3 };
+
+} // namespace astar_timed_detail
+
+template <int W, int H, typename NodeT>
+TimedResult planTimed(
+  const OccupancyGrid<W, H>& grid,
+  int sx, int sy, uint8_t sHeading, int gx, int gy,
+  const MoveCosts& costs,
+  NodeT* out, uint16_t maxOut,
+  TimedWorkspace<W, H>& ws,
+  uint8_t goalHeading = TIMED_ANY_HEADING
+){
+  using namespace astar_detail;
+  using namespace astar_timed_detail;
+
+  TimedResult res{false, 0, 0, sHeading};
+  if (!grid.inBounds(sx, sy) || !grid.inBounds(gx, gy)) return res;
+  if (sHeading > 3 && sHeading != TIMED_ANY_HEADING) return res;
+  if (goalHeading > 3 && goalHeading != TIMED_ANY_HEADING) return res;
+  if (grid.blocked(sx, sy) || grid.blocked(gx, gy)) return res;
+
+  for (uint32_t i = 0; i < TimedWorkspace<W, H>::N; ++i) ws.pos[i] = POS_UNSEEN;
+
+  // 휴리스틱: 남은 맨해튼 거리 × 가장 싼 한 칸 이동 (회전 무시 → 허용적)
+  auto cellMs = [&costs](uint32_t stepMs, uint32_t runMs) {
+    const uint32_t single = stepMs + costs.dwellMs;
+    return (runMs != 0 && runMs < single) ? runMs : single;
+  };
+  uint32_t cellMin = cellMs(costs.forwardMs, costs.forwardRunMs);
+  if (costs.allowReverse) {
+    const uint32_t b = cellMs(costs.backwardMs, costs.backwardRunMs);
+    if (b < cellMin) cellMin = b;
+  }
+
+  auto h = [gx, gy, cellMin](uint16_t s) -> uint32_t {
+    const int c = s >> 2;
+    return (uint32_t)(abs(c % W - gx) + abs(c / W - gy)) * cellMin;
+  };
+  auto less = [&ws, h](uint16_t a, uint16_t b) {
+    const uint32_t fa = ws.g[a] + h(a), fb = ws.g[b] + h(b);
+    return fa != fb ? fa < fb : ws.g[a] > ws.g[b];
+  };
+  auto open = makeHeap(ws.heap, ws.pos, ws.heapLen, less);
+
+  auto relax = [&](uint16_t to, uint32_t ng, uint8_t mv, uint8_t cells) {
+    const uint16_t p = ws.pos[to];
+    if (p == POS_CLOSED) return;
+    if (p != POS_UNSEEN && ng >= ws.g[to]) return;
+    ws.g[to] = ng;
+    ws.move[to >> 2] = (uint8_t)((ws.move[to >> 2] & ~(3u << ((to & 3) * 2))) | (mv << ((to & 3) * 2)));
+    ws.run[to] = cells;
+    open.pushOrDecrease(to);
+  };
+
+  // 출발 상태: g=0 인 출발 칸 상태 (방향 무관이면 네 개)
+  const int startCell = sy * W + sx;
+  for (uint8_t hd = 0; hd < 4; ++hd) {
+    if (sHeading != TIMED_ANY_HEADING && hd != sHeading) continue;
+    const uint16_t st = (uint16_t)((startCell << 2) | hd);
+    ws.g[st] = 0;
+    open.pushOrDecrease(st);
+  }
+  auto isStart = [&ws, startCell](uint16_t s) { return (s >> 2) == startCell && ws.g[s] == 0; };
+
+  int goalState = -1;
+  while (!open.empty()) {
+    const uint16_t cur = open.pop();
+    const int c = cur >> 2;
+    const uint8_t hd = cur & 3;
+    const int cx = c % W, cy = c / W;
+    if (cx == gx && cy == gy && (goalHeading == TIMED_ANY_HEADING || hd == goalHeading)) {
+      goalState = cur;
+      break;
+    }
+
+    const uint32_t gc = ws.g[cur];
+    relax((uint16_t)((c << 2) | CW[hd]),  gc + costs.rotateMs, MV_CW, 0);
+    relax((uint16_t)((c << 2) | CCW[hd]), gc + costs.rotateMs, MV_CCW, 0);
+
+    // 한 방향으로 1..k 칸. runMs 가 0 이면 한 칸만 (칸마다 멈추는 실행)
+    auto drive = [&](int sign, uint8_t mv, uint32_t stepMs, uint32_t runMs) {
+      uint32_t ng = gc + stepMs + costs.dwellMs;
+      for (uint8_t k = 1; ; ++k) {
+        const int x = cx + sign * k * HDX[hd], y = cy + sign * k * HDY[hd];
+        if (!grid.inBounds(x, y) || grid.blocked(x, y)) break;
+        relax((uint16_t)(((y * W + x) << 2) | hd), ng, mv, k);
+        if (runMs == 0) break;
+        ng += runMs;
+      }
+    };
+    drive(1, MV_FORWARD, costs.forwardMs, costs.forwardRunMs);
+    if (costs.allowReverse) drive(-1, MV_BACKWARD, costs.backwardMs, costs.backwardRunMs);
+  }
+  if (goalState < 0) return res;
+
+  // 역추적 1: 칸 수 세기
+  auto prevOf = [&ws](uint16_t s, uint8_t mv) -> uint16_t {
+    const int c = s >> 2;
+    const uint8_t hd = s & 3;
+    const int k = ws.run[s];
+    switch (mv) {
+      case MV_FORWARD:  return (uint16_t)(((c - k * (HDY[hd] * W + HDX[hd])) << 2) | hd);
+      case MV_BACKWARD: return (uint16_t)(((c + k * (HDY[hd] * W + HDX[hd])) << 2) | hd);
+      case MV_CW:       return (uint16_t)((c << 2) | CCW[hd]);
+      default:          return (uint16_t)((c << 2) | CW[hd]);
+    }
+  };
+  auto moveOf = [&ws](uint16_t s) -> uint8_t { return (ws.move[s >> 2] >> ((s & 3) * 2)) & 3u; };
+
+  uint32_t n = 1;
+  for (uint16_t s = (uint16_t)goalState; !isStart(s); ) {
+    const uint8_t mv = moveOf(s);
+    if (mv == MV_FORWARD || mv == MV_BACKWARD) n += ws.run[s];
+    s = prevOf(s, mv);
+  }
+  if (n > maxOut) return res;
+
+  // 역추적 2: 뒤에서부터 채우기
+  uint32_t k = n - 1;
+  uint16_t s = (uint16_t)goalState;
+  while (!isStart(s)) {
+    const uint8_t mv = moveOf(s);
+    if (mv == MV_FORWARD || mv == MV_BACKWARD) {
+      const uint8_t hd = s & 3;
+      const int step = (mv == MV_FORWARD ? 1 : -1) * (HDY[hd] * W + HDX[hd]);
+      for (int j = 0; j < ws.run[s]; ++j, --k) {
+        const int c = (s >> 2) - j * step;
+        out[k] = NodeT{};
+        out[k].x = c % W;
+        out[k].y = c / W;
+        out[k].reverse = mv == MV_BACKWARD;
+      }
+    }
+    s = prevOf(s, mv);
+  }
+  out[0] = NodeT{};
+  out[0].x = sx;
+  out[0].y = sy;
+
+  res.ok = true;
+  res.n = (uint16_t)n;
+  res.costMs = ws.g[goalState] - (n > 1 ? costs.dwellMs : 0); // 마지막 구간 뒤에는 dwell 없음
+  res.endHeading = (uint8_t)(goalState & 3);
+  return res;
+}
+
+// 작업 메모리를 함수 내부 static 으로 두는 편의 버전 (재진입 불가)
+template <int W, int H, typename NodeT>
+TimedResult planTimed(
+  const OccupancyGrid<W, H>& grid,
+  int sx, int sy, uint8_t sHeading, int gx, int gy,
+  const MoveCosts& costs,
+  NodeT* out, uint16_t maxOut,
+  uint8_t goalHeading = TIMED_ANY_HEADING
+){
+  static TimedWorkspace<W, H> ws;
+  return planTimed<W, H>(grid, sx, sy, sHeading, gx, gy, costs, out, maxOut, ws, goalHeading);
+}
@@ -0,0 +1,199 @@
+#pragma once
+#include "astarGrid.h"
+
+// D* Lite 증분 경로 계획 (Koenig & Likhachev, 4-이웃, 한 칸 비용=1)
+// 목표에서 거꾸로 g/rhs 를 유지하므로, 칸이 막히거나 풀리면 영향받은 칸만 다시 계산하고
+// 로봇(시작점)이 움직여도 이전 결과를 버리지 않는다.
+//
+//   DStarLite<5,5> ds(gridMap);
+//   ds.begin(sx, sy, gx, gy);  ds.compute();  ds.path(out, maxOut);
+//   ... gridMap.set(x, y, true);
+//   ds.moveStart(bx, by);  ds.cellChanged(x, y);  ds.compute();  ds.path(out, maxOut);
+//
+// 지도는 참조로만 들고 있으므로 gridMap 을 바꾼 뒤 cellChanged() 로 알려줘야 한다.
+template <int W, int H>
+class DStarLite {
+public:
+  static constexpr uint32_t N = (uint32_t)W * H;
+  static_assert(N < 0xFFFE, "grid too large for 16-bit node indices");
+  static constexpr uint16_t INF = 0xFFFF;
+
+  explicit DStarLite(const OccupancyGrid<W, H>& grid)
+  : grid_(grid), open_(heap_, pos_, heapLen_, KeyLess{this}) {}
+
+  // 새 목표로 초기화. 실제 탐색은 compute() 에서 한다.
+  bool begin(int sx, int sy, int gx, int gy) {
+    active_ = false;
+    if (!grid_.inBounds(sx, sy) || !grid_.inBounds(gx, gy)) return false;
+    for (uint32_t i = 0; i < N; ++i) {
+      g_[i] = INF;
+      rhs_[i] = INF;
+      pos_[i] = astar_detail::POS_UNSEEN;
+    }
+    heapLen_ = 0;
+    km_ = 0;
+    start_ = last_ = idx(sx, sy);
+    goal_ = idx(gx, gy);
+    rhs_[goal_] = 0;
+    insert(goal_);
+    active_ = true;
+    return true;
+  }
+
+  bool active() const { return active_; }
+
+  // 로봇이 (x,y) 로 옮겨감: 키 보정값 km 만 늘리고 기존 결과는 유지
+  void moveStart(int x, int y) {
+    if (!active_ || !grid_.inBounds(x, y)) return;
+    start_ = idx(x, y);
+    km_ += h(last_, start_);
+    last_ = start_;
+  }
+
+  // (x,y) 의 점유가 바뀜: 그 칸과 이웃 칸의 rhs 만 다시 계산
+  void cellChanged(int x, int y) {
+    if (!active_ || !grid_.inBounds(x, y)) return;
+    const uint16_t u = idx(x, y);
+    updateVertex(u);
+    for (uint8_t d = 0; d < 4; ++d) {
+      uint16_t v;
+      if (neighbor(u, d, v)) updateVertex(v);
+    }
+  }
+
+  // 시작점이 일관될 때까지 확장. 경로가 있으면 true.
+  bool compute() {
+    if (!active_) return false;
+    expanded_ = 0;
+    while (!open_.empty()) {
+      const uint16_t u = open_.top();
+      const Key ks = calcKey(start_);
+      if (!less(key_[u], ks) && rhs_[start_] == g_[start_]) break;
+
+      expanded_++;
+      const Key kNew = calcKey(u);
+      if (less(key_[u], kNew)) {
+        key_[u] = kNew;
+        open_.update(u);
+      } else if (g_[u] > rhs_[u]) {
+        g_[u] = rhs_[u];
+        open_.pop();
+        for (uint8_t d = 0; d < 4; ++d) {
+          uint16_t v;
+          if (neighbor(u, d, v)) updateVertex(v);
+        }
+      } else {
+        g_[u] = INF;
+        updateVertex(u);
+        for (uint8_t d = 0; d < 4; ++d) {
+          uint16_t v;
+          if (neighbor(u, d, v)) updateVertex(v);
+        }
+      }
+    }
+    return g_[start_] != INF;
+  }
+
+  // 직전 compute() 에서 확장한 노드 수
+  uint16_t expanded() const { return expanded_; }
+
+  // 현재 시작점 → 목표. planAstar 와 같은 출력 규약.
+  template <typename NodeT>
+  AStarResult path(NodeT* out, uint16_t maxOut) const {
+    using namespace astar_detail;
+    AStarResult res{false, 0};
+    if (!active_ || g_[start_] == INF) return res;
+
+    uint16_t s = start_;
+    uint16_t n = 0;
+    while (true) {
+      if (n >= maxOut) return AStarResult{false, 0};
+      out[n] = NodeT{};
+      out[n].x = s % W;
+      out[n].y = s / W;
+      n++;
+      if (s == goal_) break;
+
+      // g 가 가장 작은 이웃으로 내려간다 (일관된 상태면 g 가 정확히 1씩 준다)
+      uint16_t best = INF, bestG = INF;
+      for (uint8_t d = 0; d < 4; ++d) {
+        uint16_t v;
+        if (neighbor(s, d, v) && g_[v] < bestG) { bestG = g_[v]; best = v; }
+      }
+      if (best == INF || bestG >= g_[s]) return AStarResult{false, 0};
+      s = best;
+    }
+    res.ok = true;
+    res.n = n;
+    return res;
+  }
+
+private:
+  struct Key { uint32_t k1; uint16_t k2; };
+
+  struct KeyLess {
+    const DStarLite* self;
+    bool operator()(uint16_t a, uint16_t b) const { return self->less(self->key_[a], self->key_[b]); }
+  };
+
+  static uint16_t idx(int x, int y) { return (uint16_t)(y * W + x); }
+
+  static uint16_t h(uint16_t a, uint16_t b) {
+    return (uint16_t)(abs((int)(a % W) - (int)(b % W)) + abs((int)(a / W) - (int)(b / W)));
+  }
+
+  static bool less(const Key& a, const Key& b) {
+    return a.k1 != b.k1 ? a.k1 < b.k1 : a.k2 < b.k2;
+  }
+
+  // 막히지 않은 이웃만. 막힌 칸으로 드나드는 간선 비용은 무한대다.
+  bool neighbor(uint16_t u, uint8_t d, uint16_t& v) const {
+    const int x = u % W + astar_detail::DX[d], y = u / W + astar_detail::DY[d];
+    if (!grid_.inBounds(x, y) || grid_.blocked(x, y)) return false;
+    v = idx(x, y);
+    return true;
+  }
+
+  Key calcKey(uint16_t s) const {
+    const uint16_t m = g_[s] < rhs_[s] ? g_[s] : rhs_[s];
+    if (m == INF) return Key{0xFFFFFFFFu, INF};
+    return Key{(uint32_t)m + h(start_, s) + km_, m};
+  }
+
+  void insert(uint16_t s) {
+    key_[s] = calcKey(s);
+    pos_[s] = astar_detail::POS_UNSEEN;
+    open_.pushOrDecrease(s);
+  }
+
+  void updateVertex(uint16_t u) {
+    if (u != goal_) {
+      uint16_t best = INF;
+      if (!grid_.blocked(u % W, u / W)) {
+        for (uint8_t d = 0; d < 4; ++d) {
+          uint16_t v;
+          if (neighbor(u, d, v) && g_[v] != INF && g_[v] + 1 < best) best = (uint16_t)(g_[v] + 1);
+        }
+      }
+      rhs_[u] = best;
+    }
+    if (open_.contains(u)) open_.remove(u);
+    if (g_[u] != rhs_[u]) insert(u);
+  }
+
+  const OccupancyGrid<W, H>& grid_;
+  uint16_t g_[N];
+  uint16_t rhs_[N];
+  Key      key_[N];
+  uint16_t heap_[N];
+  uint16_t pos_[N];
+  uint16_t heapLen_{0};
+  astar_detail::IndexedHeap<KeyLess> open_;
+
+  uint16_t start_{0};
+  uint16_t last_{0};
+  uint16_t goal_{0};
+  uint16_t km_{0};
+  uint16_t expanded_{0};
+  bool     active_{false};
+};
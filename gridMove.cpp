@@ -1,6 +1,7 @@
 // gridMove.cpp
 #include "gridMove.h"
 #include <Arduino.h>
+#include "Telemetry.h"
 
 // ───────── 핀 매핑 ─────────
 static constexpr uint8_t RIGHT_DIR_PIN = 2;
@@ -13,6 +14,31 @@ static constexpr uint8_t LEFT_PWM_PIN  = 5;
 static constexpr bool RIGHT_DIR_FORWARD_HIGH = false;
 static constexpr bool LEFT_DIR_FORWARD_HIGH  = false;
 
+// ───────── 엔코더 (UNO R4: A1~A4 는 외부 인터럽트 가능) ─────────
+static constexpr uint8_t LEFT_ENC_A_PIN  = A1;
+static constexpr uint8_t LEFT_ENC_B_PIN  = A2;
+static constexpr uint8_t RIGHT_ENC_A_PIN = A3;
+static constexpr uint8_t RIGHT_ENC_B_PIN = A4;
+
+// 감속 끝자락에서 PWM 이 0 으로 반올림되어 목표 앞에서 서지 않도록 남기는 최소 비율 [‰]
+static constexpr uint32_t CREEP_PERMILLE = 200;
+
+// ───────── 엔코더 틱 카운트 ─────────
+// A상 양쪽 에지마다 B상과 비교해 방향을 정한다 (A != B → 앞으로).
+// 바퀴 엔코더는 보드에 한 벌뿐이므로 파일 범위 상태로 둔다.
+static volatile int32_t s_leftTicks  = 0;
+static volatile int32_t s_rightTicks = 0;
+
+static void onLeftEncoder() {
+  if (digitalRead(LEFT_ENC_A_PIN) != digitalRead(LEFT_ENC_B_PIN)) s_leftTicks++;
+  else s_leftTicks--;
+}
+
+static void onRightEncoder() {
+  if (digitalRead(RIGHT_ENC_A_PIN) != digitalRead(RIGHT_ENC_B_PIN)) s_rightTicks++;
+  else s_rightTicks--;
+}
+
 gridMove::gridMove() {
   pinMode(RIGHT_DIR_PIN, OUTPUT);
   pinMode(RIGHT_PWM_PIN, OUTPUT);
@@ -22,185 +48,511 @@ gridMove::gridMove() {
 }
 
 // ----------------- Public API -----------------
-void gridMove::stepTo(int currX, int currY, int nextX, int nextY) {
-  // 이미 동작 중이면 무시(또는 큐만 쌓고 싶다면 정책 변경 가능)
-  if (!isIdle()) return;
-
-  const int dx = nextX - currX;
-  const int dy = nextY - currY;
-
-  Direction targetDir = currentDirection;
-  if      (dx == 1 && dy == 0)  targetDir = Direction::RIGHT;
-  else if (dx == -1 && dy == 0) targetDir = Direction::LEFT;
-  else if (dx == 0 && dy == 1)  targetDir = Direction::UP;
-  else if (dx == 0 && dy == -1) targetDir = Direction::DOWN;
-  else {
-    // 인접 아님 → 무시
-    return;
+bool gridMove::stepTo(int currX, int currY, int nextX, int nextY) {
+  // 이미 동작 중이면 무시(또는 큐만 쌓고 싶다면 queueDrive 사용)
+  if (!isIdle()) return false;
+
+  // 인접 아님 → 무시
+  if (abs(nextX - currX) + abs(nextY - currY) != 1) return false;
+
+  // 1) 최소회전 예약  2) 직진 예약 (첫 액션은 다음 update() 가 시작)
+  return queueDrive(nextX - currX, nextY - currY, 1, false, 0);
+}
+
+bool gridMove::stepBackTo(int currX, int currY, int nextX, int nextY) {
+  if (!isIdle()) return false;
+  if (abs(nextX - currX) + abs(nextY - currY) != 1) return false;
+
+  // 이동 방향의 반대를 바라보도록 최소회전 후 후진 (180도 회전 대신 후진으로 진입)
+  return queueDrive(nextX - currX, nextY - currY, 1, true, 0);
+}
+
+bool gridMove::driveTo(int currX, int currY, int endX, int endY, bool reverse) {
+  if (!isIdle()) return false;
+
+  const int dx = endX - currX;
+  const int dy = endY - currY;
+  const int cells = abs(dx) + abs(dy);
+  Direction moveDir = Direction::UP;
+  if (cells == 0 || cells > 255 || !directionOf(dx / cells, dy / cells, moveDir)) return false; // 직선 아님 → 무시
+
+  return queueDrive(dx / cells, dy / cells, (uint8_t)cells, reverse, 0);
+}
+
+bool gridMove::queueDrive(int dx, int dy, uint8_t cells, bool reverse, uint16_t tag) {
+  Direction moveDir = Direction::UP; // directionOf 가 실패하면 쓰지 않고 바로 돌아간다
+  if (cells == 0 || !directionOf(dx, dy, moveDir)) return false;
+
+  const Direction face = reverse ? opposite(moveDir) : moveDir;
+  // 회전 + 직진을 한꺼번에 넣을 자리가 없으면 일부만 넣지 않는다
+  if (queueFree() < rotationsTo(face) + 1) {
+    overflow_++;
+    return false;
   }
+  scheduleRotateTo(face, tag);
+  return enqueue(reverse ? Action::Backward : Action::Forward, cells, tag);
+}
 
-  // 1) 최소회전 예약  2) 직진 예약
-  scheduleRotateTo(targetDir);
-  enqueue(Action::Forward);
+bool gridMove::queuePause(uint32_t ms, uint16_t tag) {
+  if (ms == 0) return true;
+  Primitive p = makePrimitive(Action::Pause, 0, tag);
+  p.durationMs = ms;
+  if (queueFree() == 0) {
+    overflow_++;
+    return false;
+  }
+  q_[(qHead_ + qlen_) & (QUEUE_SIZE - 1)] = p;
+  qlen_++;
+  return true;
+}
 
-  // 즉시 첫 액션 시작
-  if (action_ == Action::Idle && hasQueued()) {
-    startAction(popQueued());
+bool gridMove::queueRotateTo(Direction target, uint16_t tag) {
+  if (queueFree() < rotationsTo(target)) {
+    overflow_++;
+    return false;
   }
+  scheduleRotateTo(target, tag);
+  return true;
+}
+
+uint8_t gridMove::queueFree() const { return (uint8_t)(QUEUE_SIZE - qlen_); }
+uint16_t gridMove::overflowCount() const { return overflow_; }
+
+void gridMove::clearQueued() {
+  qlen_ = 0;
+  // 남은 방향 계획은 진행 중인 동작이 끝난 뒤의 방향으로 되돌린다
+  plannedDirection_ = (action_ == Action::RotateCW || action_ == Action::RotateCCW)
+                      ? turned(currentDirection, action_) : currentDirection;
+}
+
+void gridMove::abort() {
+  stopMotors();
+  action_ = Action::Idle;
+  cur_ = Primitive{Action::Idle, 0, 0, 0, 0, 0, 0, 0};
+  targetTicks_ = 0; // 엔코더 목표가 남아 있으면 serviceProfile 이 옛 목표로 다시 몬다
+  rampDownTicks_ = 0;
+  limitMs_ = 0;
+  clearQueued();    // action_ 이 Idle 이므로 방향 계획도 currentDirection 으로
 }
 
+uint16_t gridMove::reachedTag() const { return reachedTag_; }
+void gridMove::setReachedTag(uint16_t tag) { reachedTag_ = tag; }
+uint16_t gridMove::currentTag() const { return cur_.tag; }
+
 void gridMove::update() {
   if (action_ == Action::Idle) {
     // 큐가 남아 있으면 다음 시작
-    if (hasQueued()) startAction(popQueued());
+    if (hasQueued()) startNext(millis());
+    return;
+  }
+
+  const uint32_t now = millis();
+  if (odometryActive()) {
+    // 거리/각도 목표에 닿으면 종료. 시간은 안전장치로만 보고, 틱이 없으면 예상 시간에 끝낸다.
+    const uint32_t travel = travelTicks();
+    const bool reached = travel >= targetTicks_;
+    if (reached || (int32_t)(now - (travel ? limitMs_ : actionEndMs_)) >= 0) {
+      if (!reached) {
+        odoTimeouts_++;
+        TLOG_FAULT(Telemetry::Event::OdometryTimeout, (uint8_t)action_, 0, 0, (int32_t)travel);
+      }
+      recordEnd(now);
+      finishAction();
+      if (hasQueued()) startNext(now);
+      return;
+    }
+    serviceProfile(now);
     return;
   }
 
   // 시간 도달 시 액션 종료
-  if ((int32_t)(millis() - actionEndMs_) >= 0) {
+  if ((int32_t)(now - actionEndMs_) >= 0) {
+    const uint32_t endMs = actionEndMs_;
+    recordEnd(now);
     finishAction();
-    // 다음 액션이 있으면 즉시 시작
-    if (hasQueued()) startAction(popQueued());
+    // 다음 액션이 있으면 앞 동작이 끝난 시각 기준으로 바로 이어서 시작 (loop 지연이 쌓이지 않음)
+    if (hasQueued()) startNext(endMs);
+    return;
   }
+  serviceProfile(now);
 }
 
 bool gridMove::isIdle() const { return action_ == Action::Idle && qlen_ == 0; }
 gridMove::Action gridMove::currentAction() const { return action_; }
 gridMove::Direction gridMove::getDirection() const { return currentDirection; }
 
-void gridMove::startForward()   { enqueue(Action::Forward);   if (action_==Action::Idle) startAction(popQueued()); }
-void gridMove::startBackward()  { enqueue(Action::Backward);  if (action_==Action::Idle) startAction(popQueued()); } // ★ 신규
-void gridMove::startRotateCW()  { enqueue(Action::RotateCW);  if (action_==Action::Idle) startAction(popQueued()); }
-void gridMove::startRotateCCW() { enqueue(Action::RotateCCW); if (action_==Action::Idle) startAction(popQueued()); }
+void gridMove::startForward()   { enqueue(Action::Forward);   if (action_==Action::Idle) startNext(millis()); }
+void gridMove::startBackward()  { enqueue(Action::Backward);  if (action_==Action::Idle) startNext(millis()); } // ★ 신규
+void gridMove::startRotateCW()  { enqueue(Action::RotateCW);  if (action_==Action::Idle) startNext(millis()); }
+void gridMove::startRotateCCW() { enqueue(Action::RotateCCW); if (action_==Action::Idle) startNext(millis()); }
 
 void gridMove::setForwardDurationMs(uint32_t ms){ forwardDurationMs = ms; }
 void gridMove::setBackwardDurationMs(uint32_t ms){ backwardDurationMs = ms; } // ★ 신규
 void gridMove::setRotateDurationMs(uint32_t ms) { rotateDurationMs  = ms; }
 
+uint32_t gridMove::getForwardDurationMs() const  { return forwardDurationMs; }
+uint32_t gridMove::getBackwardDurationMs() const { return backwardDurationMs; }
+uint32_t gridMove::getRotateDurationMs() const   { return rotateDurationMs; }
+
+void gridMove::setProfile(const Profile& profile) {
+  profile_ = profile;
+  if (profile_.accelPerS && profile_.accelPerS < MIN_RAMP_PER_S) profile_.accelPerS = MIN_RAMP_PER_S;
+  if (profile_.decelPerS && profile_.decelPerS < MIN_RAMP_PER_S) profile_.decelPerS = MIN_RAMP_PER_S;
+}
+const gridMove::Profile& gridMove::profile() const { return profile_; }
+
+uint32_t gridMove::actionMs(Action a, uint8_t cells) const {
+  return makePrimitive(a, cells, 0).durationMs;
+}
+
+void gridMove::setOdometry(const Odometry& odometry) {
+  odo_ = odometry;
+  if (odo_.ticksPerCell == 0 || encodersAttached_) return;
+  pinMode(LEFT_ENC_A_PIN, INPUT_PULLUP);
+  pinMode(LEFT_ENC_B_PIN, INPUT_PULLUP);
+  pinMode(RIGHT_ENC_A_PIN, INPUT_PULLUP);
+  pinMode(RIGHT_ENC_B_PIN, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(LEFT_ENC_A_PIN), onLeftEncoder, CHANGE);
+  attachInterrupt(digitalPinToInterrupt(RIGHT_ENC_A_PIN), onRightEncoder, CHANGE);
+  encodersAttached_ = true;
+}
+
+const gridMove::Odometry& gridMove::odometry() const { return odo_; }
+
+void gridMove::encoderTicks(int32_t& left, int32_t& right) const {
+  noInterrupts();
+  left = s_leftTicks;
+  right = s_rightTicks;
+  interrupts();
+}
+
+uint16_t gridMove::odometryTimeouts() const { return odoTimeouts_; }
+
+const Histogram& gridMove::endLateMs() const { return endLateMs_; }
+uint16_t gridMove::lateActions() const { return lateActions_; }
+
+void gridMove::resetTiming() {
+  endLateMs_.reset();
+  lateActions_ = 0;
+}
+
+void gridMove::recordEnd(uint32_t now) {
+  const int32_t late = (int32_t)(now - actionEndMs_);
+  endLateMs_.record(late > 0 ? (uint32_t)late : 0);
+  if (late > LATE_SLACK_MS) lateActions_++;
+  TLOG_DEBUG(Telemetry::Event::ActionEnd, (uint8_t)action_, 0, (int16_t)cur_.tag, late);
+}
+
+uint8_t gridMove::actionProgressPct() const {
+  if (action_ == Action::Idle) return 0;
+  uint32_t pct;
+  if (odometryActive() && travelTicks() > 0) pct = travelTicks() * 100u / targetTicks_;
+  else pct = cur_.durationMs ? (millis() - actionStartMs_) * 100u / cur_.durationMs : 100;
+  return (uint8_t)(pct < 100 ? pct : 100);
+}
+
+uint8_t gridMove::driveCellsDone() const {
+  if (action_ != Action::Forward && action_ != Action::Backward) return 0;
+  const uint32_t perCell = cellMs(cur_);
+  if (perCell == 0 || actionCells_ == 0) return 0;
+  if (odometryActive()) {
+    const uint32_t done = travelTicks() / odo_.ticksPerCell;
+    return (uint8_t)(done < actionCells_ ? done : actionCells_ - 1);
+  }
+  // 가속 구간은 순항 속도의 절반으로 가므로 그만큼 늦게 칸 경계를 지난다
+  const uint32_t elapsed = millis() - actionStartMs_;
+  const uint32_t lag = cur_.rampUpMs / 2u;
+  const uint32_t done = elapsed > lag ? (elapsed - lag) / perCell : 0;
+  return (uint8_t)(done < actionCells_ ? done : actionCells_ - 1);
+}
+
+uint8_t gridMove::limitDrive(uint8_t cells) {
+  if (action_ != Action::Forward && action_ != Action::Backward) return 0;
+  const uint8_t minCells = (uint8_t)(driveCellsDone() + 1);
+  if (cells < minCells) cells = minCells;
+  if (cells >= actionCells_) return actionCells_;
+  const uint32_t perCell = cellMs(cur_);
+  actionCells_ = cells;
+  cur_.cells = cells;
+  cur_.durationMs = perCell * cells + (cur_.rampUpMs + cur_.rampDownMs) / 2u;
+  actionEndMs_ = actionStartMs_ + cur_.durationMs; // 감속은 새 종료 시각 기준으로 시작
+  if (targetTicks_) {
+    targetTicks_ = targetTicks(cur_);
+    limitMs_ = actionStartMs_ + cur_.durationMs * odo_.timeoutPct / 100u;
+  }
+  return cells;
+}
+
 void gridMove::setForwardPWMs(int l, int r)     { forwardLeftPWM=l;  forwardRightPWM=r; }
 void gridMove::setBackwardPWMs(int l, int r)    { backwardLeftPWM=l; backwardRightPWM=r; } // ★ 신규
 void gridMove::setRotatePWMs(int l, int r)      { rotateLeftPWM=l;   rotateRightPWM=r;  }
+void gridMove::getForwardPWMs(int& l, int& r) const  { l=forwardLeftPWM;  r=forwardRightPWM; }
+void gridMove::getBackwardPWMs(int& l, int& r) const { l=backwardLeftPWM; r=backwardRightPWM; }
+void gridMove::getRotatePWMs(int& l, int& r) const   { l=rotateLeftPWM;   r=rotateRightPWM; }
 
 // ----------------- Internal helpers -----------------
-void gridMove::scheduleRotateTo(Direction target) {
-  if (target == currentDirection) {
-    // 회전 불필요
-    return;
+bool gridMove::directionOf(int dx, int dy, Direction& out) {
+  if      (dx == 1 && dy == 0)  out = Direction::RIGHT;
+  else if (dx == -1 && dy == 0) out = Direction::LEFT;
+  else if (dx == 0 && dy == 1)  out = Direction::UP;
+  else if (dx == 0 && dy == -1) out = Direction::DOWN;
+  else return false;
+  return true;
+}
+
+gridMove::Direction gridMove::opposite(Direction d) {
+  switch (d) {
+    case Direction::UP:    return Direction::DOWN;
+    case Direction::DOWN:  return Direction::UP;
+    case Direction::LEFT:  return Direction::RIGHT;
+    case Direction::RIGHT: return Direction::LEFT;
   }
-  // 최소 회전: 현재→목표
-  switch (currentDirection) {
-    case Direction::UP:
-      if      (target == Direction::RIGHT) enqueue(Action::RotateCW);
-      else if (target == Direction::LEFT)  enqueue(Action::RotateCCW);
-      else if (target == Direction::DOWN)  { enqueue(Action::RotateCW); enqueue(Action::RotateCW); }
-      break;
-    case Direction::DOWN:
-      if      (target == Direction::LEFT)  enqueue(Action::RotateCW);
-      else if (target == Direction::RIGHT) enqueue(Action::RotateCCW);
-      else if (target == Direction::UP)    { enqueue(Action::RotateCW); enqueue(Action::RotateCW); }
-      break;
-    case Direction::LEFT:
-      if      (target == Direction::UP)    enqueue(Action::RotateCW);
-      else if (target == Direction::DOWN)  enqueue(Action::RotateCCW);
-      else if (target == Direction::RIGHT) { enqueue(Action::RotateCW); enqueue(Action::RotateCW); }
-      break;
-    case Direction::RIGHT:
-      if      (target == Direction::DOWN)  enqueue(Action::RotateCW);
-      else if (target == Direction::UP)    enqueue(Action::RotateCCW);
-      else if (target == Direction::LEFT)  { enqueue(Action::RotateCW); enqueue(Action::RotateCW); }
-      break;
+  return d;
+}
+
+gridMove::Direction gridMove::turned(Direction d, Action rot) {
+  if (rot == Action::RotateCW) {
+    switch (d) {
+      case Direction::UP:    return Direction::RIGHT;
+      case Direction::RIGHT: return Direction::DOWN;
+      case Direction::DOWN:  return Direction::LEFT;
+      case Direction::LEFT:  return Direction::UP;
+    }
+  } else if (rot == Action::RotateCCW) {
+    switch (d) {
+      case Direction::UP:    return Direction::LEFT;
+      case Direction::LEFT:  return Direction::DOWN;
+      case Direction::DOWN:  return Direction::RIGHT;
+      case Direction::RIGHT: return Direction::UP;
+    }
   }
-  // 실제 currentDirection 갱신은 회전 완료 시점(finishAction)에서 수행
+  return d;
 }
 
-void gridMove::startAction(Action a) {
-  action_ = a;
-  const uint32_t now = millis();
+uint8_t gridMove::rotationsTo(Direction target) const {
+  if (target == plannedDirection_) return 0;
+  return target == opposite(plannedDirection_) ? 2 : 1;
+}
 
+void gridMove::scheduleRotateTo(Direction target, uint16_t tag) {
+  // 최소 회전: 큐의 마지막 동작이 끝난 방향 → 목표 (90도는 한 번, 180도는 CW 두 번)
+  if (rotationsTo(target) == 2) {
+    enqueue(Action::RotateCW, 1, tag);
+    enqueue(Action::RotateCW, 1, tag);
+  } else if (turned(plannedDirection_, Action::RotateCW) == target) {
+    enqueue(Action::RotateCW, 1, tag);
+  } else if (turned(plannedDirection_, Action::RotateCCW) == target) {
+    enqueue(Action::RotateCCW, 1, tag);
+  }
+  // 실제 currentDirection 갱신은 회전 완료 시점(finishAction)에서 수행
+}
+
+gridMove::Primitive gridMove::makePrimitive(Action a, uint8_t cells, uint16_t tag) const {
+  Primitive p{a, cells, tag, 0, 0, 0, 0, 0};
   switch (a) {
     case Action::Forward:
-      driveMotors(forwardLeftPWM, forwardRightPWM);
-      actionEndMs_ = now + forwardDurationMs;
+      p.durationMs = forwardDurationMs * cells;
+      p.leftPWM = (int16_t)forwardLeftPWM;
+      p.rightPWM = (int16_t)forwardRightPWM;
       break;
-
     case Action::Backward: // ★ 신규: 회전 없이 바로 후진
-      driveMotors(backwardLeftPWM, backwardRightPWM);
-      actionEndMs_ = now + backwardDurationMs; // 기본은 forward와 동일
+      p.durationMs = backwardDurationMs * cells; // 기본은 forward와 동일
+      p.leftPWM = (int16_t)backwardLeftPWM;
+      p.rightPWM = (int16_t)backwardRightPWM;
       break;
-
     case Action::RotateCW:
-      driveMotors(rotateLeftPWM, rotateRightPWM);
-      actionEndMs_ = now + rotateDurationMs;
+      p.durationMs = rotateDurationMs;
+      p.leftPWM = (int16_t)rotateLeftPWM;
+      p.rightPWM = (int16_t)rotateRightPWM;
       break;
-
     case Action::RotateCCW:
-      driveMotors(-rotateLeftPWM, -rotateRightPWM);
-      actionEndMs_ = now + rotateDurationMs;
+      p.durationMs = rotateDurationMs;
+      p.leftPWM = (int16_t)-rotateLeftPWM;
+      p.rightPWM = (int16_t)-rotateRightPWM;
       break;
-
-    case Action::Idle:
     default:
-      stopMotors();
-      actionEndMs_ = now;
-      break;
+      return p;
+  }
+
+  // 순항 PWM 을 올린 만큼 순항 시간을 줄이고, 가감속 구간의 모자란 거리만큼 늘린다
+  // (정수 PWM 으로 잘린 실제 비율로 나눈다)
+  const uint8_t pct = profile_.cruisePct ? profile_.cruisePct : 100;
+  const uint32_t basePeak = (uint32_t)(abs(p.leftPWM) > abs(p.rightPWM) ? abs(p.leftPWM) : abs(p.rightPWM));
+  p.leftPWM = (int16_t)constrain((int32_t)p.leftPWM * pct / 100, -255, 255);
+  p.rightPWM = (int16_t)constrain((int32_t)p.rightPWM * pct / 100, -255, 255);
+  const uint32_t peak = (uint32_t)(abs(p.leftPWM) > abs(p.rightPWM) ? abs(p.leftPWM) : abs(p.rightPWM));
+  if (peak == 0) return p;
+  const uint32_t cruiseMs = p.durationMs * basePeak / peak;
+  uint32_t up = profile_.accelPerS ? peak * 1000u / profile_.accelPerS : 0;
+  uint32_t down = profile_.decelPerS ? peak * 1000u / profile_.decelPerS : 0;
+  if ((up + down) / 2u <= cruiseMs) {
+    p.durationMs = cruiseMs + (up + down) / 2u;
+  } else {
+    // 삼각형: 최고 PWM 을 k 배로 낮추면 가감속 시간도 k 배, 거리는 k^2 배
+    const float k = sqrtf(2.0f * cruiseMs / (float)(up + down));
+    up = (uint32_t)(up * k);
+    down = (uint32_t)(down * k);
+    p.leftPWM = (int16_t)(p.leftPWM * k);
+    p.rightPWM = (int16_t)(p.rightPWM * k);
+    p.durationMs = up + down;
   }
+  p.rampUpMs = (uint16_t)up;
+  p.rampDownMs = (uint16_t)down;
+  return p;
 }
 
-void gridMove::finishAction() {
-  // 액션 종료 처리
-  stopMotors();
+// 순항 속도 기준 한 칸 시간 (가감속 보정을 뺀 값)
+uint32_t gridMove::cellMs(const Primitive& p) const {
+  if (p.cells == 0) return 0;
+  const uint32_t ramps = (p.rampUpMs + p.rampDownMs) / 2u;
+  return p.durationMs > ramps ? (p.durationMs - ramps) / p.cells : p.durationMs / p.cells;
+}
 
+// pwm × permille/1000, 반올림 (버리면 가감속 구간 거리가 늘 모자란다)
+static int16_t scaledPwm(int16_t pwm, uint32_t permille) {
+  const int32_t v = (int32_t)pwm * (int32_t)permille;
+  return (int16_t)(v >= 0 ? (v + 500) / 1000 : (v - 500) / 1000);
+}
+
+bool gridMove::odometryActive() const {
+  return targetTicks_ > 0 && action_ != Action::Idle;
+}
+
+// 동작 시작 뒤 두 바퀴가 간 틱 수의 평균 (방향 무관)
+uint32_t gridMove::travelTicks() const {
+  int32_t l, r;
+  encoderTicks(l, r);
+  l -= tick0Left_;
+  r -= tick0Right_;
+  return ((uint32_t)abs(l) + (uint32_t)abs(r)) / 2u;
+}
+
+uint32_t gridMove::targetTicks(const Primitive& p) const {
+  if (odo_.ticksPerCell == 0) return 0;
+  switch (p.action) {
+    case Action::Forward:
+    case Action::Backward:  return (uint32_t)odo_.ticksPerCell * p.cells;
+    case Action::RotateCW:
+    case Action::RotateCCW: return odo_.ticksPer90;
+    default:                return 0;
+  }
+}
+
+// 가감속 구간이면 경과 시간(엔코더가 있으면 남은 틱)에 맞춰 PWM 을 다시 걸고,
+// 엔코더가 있으면 좌우 틱 차이로 방향을 유지한다 (바뀐 경우에만)
+void gridMove::serviceProfile(uint32_t now) {
+  const bool odo = odometryActive();
+  if (!odo && cur_.rampUpMs == 0 && cur_.rampDownMs == 0) return;
+  if (action_ == Action::Idle || action_ == Action::Pause) return;
+  const uint32_t elapsed = now - actionStartMs_;
+  uint32_t permille = 1000;
+  if (cur_.rampUpMs && elapsed < cur_.rampUpMs) permille = elapsed * 1000u / cur_.rampUpMs;
+
+  int32_t hold = 0;
+  if (odo) {
+    int32_t l, r;
+    encoderTicks(l, r);
+    l = abs(l - tick0Left_);
+    r = abs(r - tick0Right_);
+    const uint32_t travel = ((uint32_t)l + (uint32_t)r) / 2u;
+    // 등감속이면 속도 ∝ √남은 거리
+    if (rampDownTicks_ && travel > 0 && targetTicks_ - travel < rampDownTicks_) {
+      uint32_t downPm = (uint32_t)(1000.0f * sqrtf((float)(targetTicks_ - travel) / rampDownTicks_));
+      if (downPm < CREEP_PERMILLE) downPm = CREEP_PERMILLE;
+      if (downPm < permille) permille = downPm;
+    }
+    hold = (l - r) * (int32_t)odo_.holdGain / 16;
+  } else if (cur_.rampDownMs) {
+    const int32_t remain = (int32_t)(actionEndMs_ - now);
+    if (remain < (int32_t)cur_.rampDownMs) {
+      const uint32_t downPm = remain > 0 ? (uint32_t)remain * 1000u / cur_.rampDownMs : 0;
+      if (downPm < permille) permille = downPm;
+    }
+  }
+
+  int16_t l = scaledPwm(cur_.leftPWM, permille);
+  int16_t r = scaledPwm(cur_.rightPWM, permille);
+  if (hold) {
+    // 앞선 바퀴는 늦추고 뒤진 바퀴는 당긴다. 보정은 순항 PWM 의 1/4 까지, 방향은 뒤집지 않는다.
+    const int32_t peak = abs(l) > abs(r) ? abs(l) : abs(r);
+    hold = constrain(hold * (int32_t)permille / 1000, -peak / 4, peak / 4);
+    const int32_t lMag = abs(l) - hold > 0 ? abs(l) - hold : 0;
+    const int32_t rMag = abs(r) + hold > 0 ? abs(r) + hold : 0;
+    l = (int16_t)(l < 0 ? -lMag : lMag);
+    r = (int16_t)(r < 0 ? -rMag : rMag);
+  }
+  if (l != outLeft_ || r != outRight_) driveMotors(l, r);
+}
+
+void gridMove::startAction(const Primitive& p, uint32_t startMs) {
+  cur_ = p;
+  action_ = p.action;
+  actionStartMs_ = startMs;
+  actionCells_ = p.cells;
+  actionEndMs_ = startMs + p.durationMs;
+  TLOG_DEBUG(Telemetry::Event::ActionStart, (uint8_t)p.action, p.cells, (int16_t)p.tag, (int32_t)p.durationMs);
+
+  // 엔코더 목표: 감속 구간 틱 = 순항 속도[틱/ms] × 감속 시간 / 2
+  targetTicks_ = targetTicks(p);
+  rampDownTicks_ = 0;
+  if (targetTicks_) {
+    encoderTicks(tick0Left_, tick0Right_);
+    limitMs_ = startMs + p.durationMs * odo_.timeoutPct / 100u;
+    const uint32_t cruiseMs = p.durationMs - (p.rampUpMs + p.rampDownMs) / 2u;
+    if (cruiseMs) rampDownTicks_ = targetTicks_ * p.rampDownMs / (2u * cruiseMs);
+  }
+
+  if (p.action == Action::Idle || p.action == Action::Pause) stopMotors();
+  else if (p.rampUpMs == 0) driveMotors(p.leftPWM, p.rightPWM);
+  else serviceProfile(millis()); // 0 에서 올리기 시작
+}
+
+void gridMove::finishAction() {
   // 방향 갱신은 회전 완료 시점에만
   if (action_ == Action::RotateCW || action_ == Action::RotateCCW) {
-    auto cw = [](Direction d)->Direction {
-      switch (d) {
-        case Direction::UP:    return Direction::RIGHT;
-        case Direction::RIGHT: return Direction::DOWN;
-        case Direction::DOWN:  return Direction::LEFT;
-        case Direction::LEFT:  return Direction::UP;
-      }
-      return Direction::UP;
-    };
-    auto ccw = [](Direction d)->Direction {
-      switch (d) {
-        case Direction::UP:    return Direction::LEFT;
-        case Direction::LEFT:  return Direction::DOWN;
-        case Direction::DOWN:  return Direction::RIGHT;
-        case Direction::RIGHT: return Direction::UP;
-      }
-      return Direction::UP;
-    };
-    currentDirection = (action_ == Action::RotateCW) ? cw(currentDirection)
-                                                     : ccw(currentDirection);
+    currentDirection = turned(currentDirection, action_);
   }
+  reachedTag_ = (uint16_t)(cur_.tag + ((action_ == Action::Forward || action_ == Action::Backward) ? cur_.cells : 0));
 
+  // 다음 동작이 이어지면 모터를 끄지 않는다 (startAction 이 바로 새 PWM 을 건다)
+  if (!hasQueued()) stopMotors();
   action_ = Action::Idle;
 }
 
-void gridMove::enqueue(Action a) {
-  if (qlen_ < 3) {
-    q_[qlen_++] = a;
+bool gridMove::enqueue(Action a, uint8_t cells, uint16_t tag) {
+  if (qlen_ >= QUEUE_SIZE) {
+    overflow_++; // 조용히 버리지 않고 센다
+    return false;
   }
+  q_[(qHead_ + qlen_) & (QUEUE_SIZE - 1)] = makePrimitive(a, cells, tag);
+  qlen_++;
+  plannedDirection_ = turned(plannedDirection_, a);
+  return true;
+}
+
+void gridMove::startNext(uint32_t startMs) {
+  const Primitive p = q_[qHead_];
+  qHead_ = (qHead_ + 1) & (QUEUE_SIZE - 1);
+  qlen_--;
+  startAction(p, startMs);
 }
 
 bool gridMove::hasQueued() const { return qlen_ > 0; }
 
 gridMove::Action gridMove::popQueued() {
   if (qlen_ == 0) return Action::Idle;
-  
-  Action a = q_[0]; // 첫 번째 동작을 변수에 저장
-  qlen_--; // 큐 길이를 먼저 줄임
-
-  // 남은 항목들을 앞으로 한 칸씩 이동
-  for (uint8_t i = 0; i < qlen_; i++) {
-    q_[i] = q_[i + 1];
-  }
-
-  return a; // 저장해둔 첫 번째 동작을 반환
+  const Action a = q_[qHead_].action;
+  qHead_ = (qHead_ + 1) & (QUEUE_SIZE - 1);
+  qlen_--;
+  if (qlen_ == 0) clearQueued(); // 방향 계획 복구
+  return a;
 }
 
 // ----------------- Low-level motor -----------------
 void gridMove::driveMotors(int leftPWM, int rightPWM) {
+  outLeft_ = (int16_t)leftPWM;
+  outRight_ = (int16_t)rightPWM;
+
   // 좌측
   const bool leftForward  = (leftPWM >= 0);
   const uint8_t leftDuty  = (uint8_t)constrain(abs(leftPWM), 0, 255);
@@ -217,6 +569,8 @@ void gridMove::driveMotors(int leftPWM, int rightPWM) {
 }
 
 void gridMove::stopMotors() {
+  outLeft_ = 0;
+  outRight_ = 0;
   analogWrite(LEFT_PWM_PIN,  0);
   analogWrite(RIGHT_PWM_PIN, 0);
 }
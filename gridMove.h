@@ -3,15 +3,81 @@
 #define GRIDMOVE_H
 
 #include <cstdint>
+#include "Histogram.h"
 
 class gridMove {
 public:
     enum class Direction { UP, DOWN, LEFT, RIGHT };
-    enum class Action { Idle, RotateCW, RotateCCW, Forward, Backward };
+    enum class Action { Idle, RotateCW, RotateCCW, Forward, Backward, Pause };
+
+    // 시간 지정 동작 단위. 큐에 넣는 시점의 시간/PWM 설정을 그대로 담는다.
+    // tag: 호출자 정의 값 (PathRunner 는 동작을 시작하는 경로 인덱스를 넣는다)
+    struct Primitive {
+        Action   action;
+        uint8_t  cells;       // Forward/Backward 의 칸 수
+        uint16_t tag;
+        uint32_t durationMs;  // 가감속 포함 전체 시간
+        int16_t  leftPWM;     // 순항(최고) PWM
+        int16_t  rightPWM;
+        uint16_t rampUpMs;    // 0 → 순항 PWM 까지 올리는 시간
+        uint16_t rampDownMs;  // 순항 PWM → 0 까지 내리는 시간
+    };
+
+    // 사다리꼴 속도 프로파일. PWM 을 기울기에 맞춰 올리고 내려 바퀴 헛돎 없이 출발/정지한다.
+    // - accelPerS/decelPerS : PWM 듀티 증가/감소 기울기 [듀티/s]. 0 이면 계단 (예전 동작).
+    // - cruisePct : 순항 PWM = 설정 PWM × cruisePct/100. 시간 설정(set*DurationMs)은 100% 계단
+    //   기준 한 칸/90도 시간이며, 속도가 듀티에 비례한다고 보고 순항 구간을 줄인다.
+    // 가감속 구간은 순항 속도의 절반만 가므로 동작 시간이 (올림 + 내림)/2 만큼 늘어난다.
+    // 너무 짧은 동작은 순항 PWM 에 닿기 전에 내려오는 삼각형 프로파일이 된다.
+    // 0 이 아닌 기울기는 MIN_RAMP_PER_S 이상으로 올린다 (램프 시간이 16비트 ms 에 들어가도록).
+    static constexpr uint16_t MIN_RAMP_PER_S = 4; // 255 듀티 / 4 = 63.75 s
+    struct Profile {
+        uint16_t accelPerS;
+        uint16_t decelPerS;
+        uint8_t  cruisePct;
+    };
+
+    // 바퀴 엔코더 주행거리. 켜면 직진/회전이 시간 대신 거리/각도 목표에 닿을 때 끝난다.
+    // - ticksPerCell : 한 칸 직진할 때 바퀴 하나의 엔코더 틱 수 (A상 양쪽 에지). 0 이면 엔코더 없음.
+    // - ticksPer90   : 제자리 90도 회전할 때 바퀴 하나의 틱 수
+    // - holdGain     : 방향 유지 보정. 좌우 틱 차이 1틱당 PWM 을 holdGain/16 만큼 한쪽은 빼고 한쪽은 더한다.
+    // - timeoutPct   : 예상 시간의 이 비율(%)이 지나도 목표에 못 닿으면 시간으로 끝낸다 (안전장치).
+    // 감속은 남은 틱 수로 한다. 틱이 하나도 안 들어오면(배선 불량 등) 예전처럼 예상 시간에 끝낸다.
+    struct Odometry {
+        uint16_t ticksPerCell;
+        uint16_t ticksPer90;
+        uint8_t  holdGain;
+        uint8_t  timeoutPct;
+    };
+    static constexpr uint8_t QUEUE_SIZE = 32; // 2의 거듭제곱
+    static constexpr uint8_t LATE_SLACK_MS = 5; // 예정 종료 시각을 이보다 넘겨 끝나면 마감 초과로 센다
 
     gridMove();
 
-    void stepTo(int currX, int currY, int nextX, int nextY);
+    // 아래 세 함수는 정지 상태에서만 받는다. 큐가 모자라면 아무것도 넣지 않고 false.
+    // 큐에 넣기만 하고, 첫 동작은 다음 update() (스케줄러의 구동부 작업) 가 시작한다.
+    bool stepTo(int currX, int currY, int nextX, int nextY);
+    bool stepBackTo(int currX, int currY, int nextX, int nextY); // 후진으로 인접 칸 이동
+    // 같은 행/열의 여러 칸을 한 번의 전진(또는 후진)으로 이동. 시간은 칸 수에 비례.
+    bool driveTo(int currX, int currY, int endX, int endY, bool reverse);
+
+    // 미리 쌓기: 앞서 넣은 동작이 끝난 방향 기준으로 (최소 회전 + 직진) 을 큐 뒤에 붙인다.
+    // 동작 중에도 받으며, update() 가 틈 없이 이어서 실행한다.
+    bool queueDrive(int dx, int dy, uint8_t cells, bool reverse, uint16_t tag);
+    bool queuePause(uint32_t ms, uint16_t tag);
+    bool queueRotateTo(Direction target, uint16_t tag = 0); // 최소 회전 (0~2번)
+    uint8_t queueFree() const;
+    void clearQueued();            // 아직 시작하지 않은 동작을 모두 버린다
+    // 비상 정지: 모터를 끄고 큐를 비우고 진행 중인 동작을 버린다 (끝난 것으로 치지 않는다).
+    // 회전 중이었다면 방향은 회전 전 그대로 둔다. 이후 update() 는 모터를 다시 켜지 않는다.
+    void abort();
+    uint16_t overflowCount() const; // 큐가 가득 차 거절된 동작 수
+
+    // 마지막으로 끝난 동작의 도착 tag (Forward/Backward 는 tag + 칸 수)
+    uint16_t reachedTag() const;
+    void setReachedTag(uint16_t tag);
+    uint16_t currentTag() const;   // 진행 중인 동작의 tag
+
     void update();
 
     bool isIdle() const;
@@ -29,6 +95,39 @@ public:
     void setForwardPWMs(int leftPWM, int rightPWM);
     void setBackwardPWMs(int leftPWM, int rightPWM);
     void setRotatePWMs(int leftPWM, int rightPWM);
+    uint32_t getForwardDurationMs() const;
+    uint32_t getBackwardDurationMs() const;
+    uint32_t getRotateDurationMs() const;
+    void getForwardPWMs(int& leftPWM, int& rightPWM) const;
+    void getBackwardPWMs(int& leftPWM, int& rightPWM) const;
+    void getRotatePWMs(int& leftPWM, int& rightPWM) const;
+
+    void setProfile(const Profile& profile);
+    const Profile& profile() const;
+    // 지금 프로파일 설정으로 동작 하나(직진은 cells 칸)를 실행하는 시간
+    uint32_t actionMs(Action a, uint8_t cells = 1) const;
+
+    // 처음 켤 때 엔코더 인터럽트를 붙인다
+    void setOdometry(const Odometry& odometry);
+    const Odometry& odometry() const;
+    // 엔코더 누적 틱 (바퀴가 앞으로 돌면 +)
+    void encoderTicks(int32_t& left, int32_t& right) const;
+    uint16_t odometryTimeouts() const; // 목표 거리/각도에 못 닿고 시간 안전장치로 끝난 동작 수
+
+    // 동작이 예정 종료 시각(시작 + 예상 시간)보다 얼마나 늦게 끝났는지 [ms] (일찍 끝나면 0).
+    // 시간 종료는 update() 호출 간격만큼, 엔코더 종료는 실제 주행이 예상보다 느린 만큼 늦는다.
+    const Histogram& endLateMs() const;
+    uint16_t lateActions() const;  // LATE_SLACK_MS 를 넘겨 끝난 동작 수
+    void resetTiming();
+
+    // 경로 수정용: 진행 중인 직진(Forward/Backward)에서 이미 지난 칸 수 (직진이 아니면 0).
+    // 마지막 칸은 동작이 끝나야 지난 것으로 치므로 최대 (칸 수 - 1).
+    uint8_t driveCellsDone() const;
+    // 진행 중인 동작의 진행률 [%]. 엔코더가 켜져 있으면 틱, 아니면 시간 기준.
+    uint8_t actionProgressPct() const;
+    // 진행 중인 직진이 cells 칸에서 끝나도록 줄이고, 줄인 뒤의 칸 수를 돌려준다.
+    // 이미 들어선 칸 경계(지난 칸 + 1)보다 짧게는 줄이지 않는다. 직진이 아니면 0.
+    uint8_t limitDrive(uint8_t cells);
     
     // PathRunner가 접근할 수 있도록 public으로 변경된 함수들
     void stopMotors();
@@ -36,20 +135,53 @@ public:
     Action popQueued();
 
 private:
-    void scheduleRotateTo(Direction target);
-    void startAction(Action a);
+    static bool directionOf(int dx, int dy, Direction& out);
+    static Direction opposite(Direction d);
+    static Direction turned(Direction d, Action rot);
+    uint8_t rotationsTo(Direction target) const;
+    void scheduleRotateTo(Direction target, uint16_t tag = 0);
+    void startAction(const Primitive& p, uint32_t startMs);
+    void serviceProfile(uint32_t now);
+    bool odometryActive() const;
+    uint32_t travelTicks() const;
+    uint32_t targetTicks(const Primitive& p) const;
+    uint32_t cellMs(const Primitive& p) const;
+    void startNext(uint32_t startMs);
     void finishAction();
+    void recordEnd(uint32_t now);
     void driveMotors(int leftPWM, int rightPWM);
-    void enqueue(Action a);
+    Primitive makePrimitive(Action a, uint8_t cells, uint16_t tag) const;
+    bool enqueue(Action a, uint8_t cells = 1, uint16_t tag = 0);
 
 private:
     Direction currentDirection{Direction::RIGHT};
+    Direction plannedDirection_{Direction::RIGHT}; // 큐의 모든 동작이 끝난 뒤의 방향
+    Primitive cur_{Action::Idle, 0, 0, 0, 0, 0, 0, 0};
     Action    action_{Action::Idle};
     uint32_t  actionEndMs_{0};
+    uint32_t  actionStartMs_{0};
+    uint8_t   actionCells_{1};
+    uint16_t  reachedTag_{0};
+    Profile   profile_{0, 0, 100};
+    int16_t   outLeft_{0};    // 지금 모터에 건 PWM (프로파일 갱신용)
+    int16_t   outRight_{0};
+
+    Odometry  odo_{0, 0, 0, 150};
+    bool      encodersAttached_{false};
+    int32_t   tick0Left_{0};      // 동작 시작 때의 엔코더 값
+    int32_t   tick0Right_{0};
+    uint32_t  targetTicks_{0};    // 0 이면 시간으로 끝낸다
+    uint32_t  rampDownTicks_{0};  // 남은 틱이 이보다 적으면 감속
+    uint32_t  limitMs_{0};        // 시간 안전장치 (엔코더 동작)
+    uint16_t  odoTimeouts_{0};
+    Histogram endLateMs_;
+    uint16_t  lateActions_{0};
 
-    // --- [BUG FIX] 180도 회전(2) + 전진(1)을 위해 큐 크기를 3으로 늘림 ---
-    Action    q_[3]{Action::Idle, Action::Idle, Action::Idle};
+    // 동작 링 버퍼: head_ 가 다음에 시작할 동작, 길이 qlen_
+    Primitive q_[QUEUE_SIZE];
+    uint8_t   qHead_{0};
     uint8_t   qlen_{0};
+    uint16_t  overflow_{0};
     
     uint32_t forwardDurationMs{5373};
     uint32_t backwardDurationMs{5373};
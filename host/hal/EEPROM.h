@@ -0,0 +1,35 @@
+// host/hal/EEPROM.h
+// 호스트 빌드용 EEPROM 대체 헤더 (UNO R4 의 데이터 플래시 에뮬레이션 EEPROM 과 같은 API).
+// 내용은 sim::eeprom() 에 있고 sim::reset() 으로 지워지지 않는다 (재부팅 뒤에도 남음).
+#ifndef HOST_EEPROM_H
+#define HOST_EEPROM_H
+
+#include <cstdint>
+#include <cstring>
+#include "sim.h"
+
+class EEPROMClass {
+public:
+    uint8_t read(int idx) const { return inRange(idx, 1) ? sim::eeprom()[idx] : 0xFF; }
+    void write(int idx, uint8_t val) { if (inRange(idx, 1)) sim::eeprom()[idx] = val; }
+    void update(int idx, uint8_t val) { write(idx, val); }
+    uint16_t length() const { return (uint16_t)sim::EEPROM_SIZE; }
+
+    template <typename T>
+    T& get(int idx, T& t) const {
+        if (inRange(idx, sizeof(T))) memcpy(&t, sim::eeprom() + idx, sizeof(T));
+        return t;
+    }
+    template <typename T>
+    const T& put(int idx, const T& t) {
+        if (inRange(idx, sizeof(T))) memcpy(sim::eeprom() + idx, &t, sizeof(T));
+        return t;
+    }
+
+private:
+    static bool inRange(int idx, size_t n) { return idx >= 0 && (size_t)idx + n <= sim::EEPROM_SIZE; }
+};
+
+extern EEPROMClass EEPROM;
+
+#endif // HOST_EEPROM_H
@@ -0,0 +1,92 @@
+// host/hal/WiFiS3.h
+// 호스트 빌드용 WiFiS3 대체 헤더.
+// 접속/요청은 시뮬레이터(sim::openConnection, sim::sendUdp)가 가상 시각에 맞춰 주입한다.
+#ifndef HOST_WIFIS3_H
+#define HOST_WIFIS3_H
+
+#include <Arduino.h>
+#include <memory>
+#include <string>
+
+#define WL_IDLE_STATUS 0
+#define WL_CONNECTED   3
+
+namespace sim { struct Connection; }
+
+class IPAddress : public Printable {
+public:
+    IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0) : b_{a, b, c, d} {}
+    size_t printTo(Print& p) const override;
+private:
+    uint8_t b_[4];
+};
+
+class WiFiClass {
+public:
+    int begin(const char* ssid, const char* pass);
+    IPAddress localIP() const { return IPAddress(127, 0, 0, 1); }
+};
+
+extern WiFiClass WiFi;
+
+class WiFiClient : public Print {
+public:
+    WiFiClient() = default;
+    explicit WiFiClient(std::shared_ptr<sim::Connection> c) : conn_(std::move(c)) {}
+
+    explicit operator bool() const;
+    bool operator==(const WiFiClient& rhs) const { return conn_ == rhs.conn_; }
+    bool operator!=(const WiFiClient& rhs) const { return conn_ != rhs.conn_; }
+
+    uint8_t connected();
+    int available();
+    int read();
+    int read(uint8_t* buf, size_t n);
+    int peek();
+    String readStringUntil(char terminator);
+    void setTimeout(unsigned long ms) { timeoutMs_ = ms; }
+    void flush() {}
+    void stop();
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buf, size_t n) override;
+    using Print::write;
+
+private:
+    std::shared_ptr<sim::Connection> conn_;
+    unsigned long timeoutMs_{1000};
+};
+
+class WiFiServer {
+public:
+    explicit WiFiServer(uint16_t port) : port_(port) {}
+    void begin() {}
+    WiFiClient available();
+private:
+    uint16_t port_;
+};
+
+// 데이터그램 단위 UDP: parsePacket() 으로 다음 패킷을 고른 뒤 read() 로 읽는다.
+class WiFiUDP {
+public:
+    uint8_t begin(uint16_t port) { port_ = port; return 1; }
+    void stop() { port_ = 0; }
+
+    int parsePacket();
+    int available() const { return (int)(rx_.size() - rpos_); }
+    int read(uint8_t* buf, size_t n);
+    IPAddress remoteIP() const { return IPAddress(127, 0, 0, 1); }
+    uint16_t remotePort() const { return 40000; }
+
+    int beginPacket(IPAddress ip, uint16_t port) { (void)ip; (void)port; tx_.clear(); return 1; }
+    size_t write(const uint8_t* buf, size_t n) { tx_.append((const char*)buf, n); return n; }
+    int endPacket();
+
+private:
+    uint16_t    port_{0};
+    std::string rx_;
+    size_t      rpos_{0};
+    std::string tx_;
+};
+
+#endif // HOST_WIFIS3_H
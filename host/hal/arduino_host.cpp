@@ -0,0 +1,180 @@
+// host/hal/arduino_host.cpp
+// Arduino / WiFiS3 API 의 호스트 구현. 시간과 I/O 는 모두 sim:: 으로 위임한다.
+#include <Arduino.h>
+#include <WiFiS3.h>
+#include <EEPROM.h>
+#include "sim.h"
+#include <cstdio>
+
+HardwareSerial Serial;
+WiFiClass WiFi;
+EEPROMClass EEPROM;
+
+// ----- 시간 -----
+unsigned long millis() { return (unsigned long)(sim::nowUs() / 1000); }
+unsigned long micros() { return (unsigned long)sim::nowUs(); }
+void delay(unsigned long ms) { sim::advanceUs((uint64_t)ms * 1000); }
+void delayMicroseconds(unsigned int us) { sim::advanceUs(us); }
+
+// ----- 핀 -----
+void pinMode(uint8_t, uint8_t) {}
+void digitalWrite(uint8_t pin, uint8_t val) { sim::pinWrite(pin, val); }
+int  digitalRead(uint8_t pin) { return sim::pinLevel(pin); }
+void analogWrite(uint8_t pin, int val) { sim::pwmWrite(pin, val); }
+unsigned long pulseIn(uint8_t pin, uint8_t state, unsigned long timeout) {
+    return sim::pulseIn(pin, state, timeout);
+}
+
+// ----- 인터럽트 -----
+int  digitalPinToInterrupt(uint8_t pin) { return pin; }
+void attachInterrupt(int irq, void (*isr)(), int mode) { sim::attachIsr((uint8_t)irq, isr, mode); }
+void detachInterrupt(int irq) { sim::attachIsr((uint8_t)irq, nullptr, 0); }
+void noInterrupts() {}
+void interrupts() {}
+
+// ----- String -----
+String::String(double v, unsigned char decimals) {
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%.*f", (int)decimals, v);
+    s_ = buf;
+}
+
+int String::indexOf(char c, unsigned int from) const {
+    const size_t p = s_.find(c, from);
+    return p == std::string::npos ? -1 : (int)p;
+}
+
+int String::indexOf(const String& str, unsigned int from) const {
+    const size_t p = s_.find(str.s_, from);
+    return p == std::string::npos ? -1 : (int)p;
+}
+
+String String::substring(unsigned int from) const {
+    return substring(from, (unsigned int)s_.size());
+}
+
+String String::substring(unsigned int from, unsigned int to) const {
+    if (from > to) { const unsigned int t = from; from = to; to = t; }
+    if (from >= s_.size()) return String();
+    if (to > s_.size()) to = (unsigned int)s_.size();
+    return String(s_.substr(from, to - from));
+}
+
+bool String::startsWith(const String& prefix) const {
+    return s_.compare(0, prefix.s_.size(), prefix.s_) == 0;
+}
+
+// ----- Print -----
+size_t Print::write(const uint8_t* buf, size_t n) {
+    size_t k = 0;
+    while (k < n && write(buf[k])) k++;
+    return k;
+}
+
+size_t Print::print(const Printable& p) { return p.printTo(*this); }
+
+size_t HardwareSerial::write(uint8_t c) {
+    if (sim::config().echoSerial) fputc(c, stdout);
+    return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t* buf, size_t n) {
+    if (sim::config().echoSerial) fwrite(buf, 1, n, stdout);
+    return n;
+}
+
+// ----- WiFi -----
+size_t IPAddress::printTo(Print& p) const {
+    size_t n = 0;
+    for (int i = 0; i < 4; ++i) {
+        n += p.print((unsigned int)b_[i]);
+        if (i < 3) n += p.print('.');
+    }
+    return n;
+}
+
+int WiFiClass::begin(const char*, const char*) { return WL_CONNECTED; }
+
+WiFiClient::operator bool() const { return conn_ && !conn_->closed; }
+
+uint8_t WiFiClient::connected() {
+    return (conn_ && !conn_->closed) ? 1 : 0;
+}
+
+int WiFiClient::available() { return conn_ ? (int)conn_->available() : 0; }
+
+int WiFiClient::read() {
+    if (!conn_ || conn_->available() == 0) return -1;
+    return (uint8_t)conn_->rx[conn_->rpos++];
+}
+
+int WiFiClient::read(uint8_t* buf, size_t n) {
+    size_t k = 0;
+    while (k < n && available() > 0) buf[k++] = (uint8_t)read();
+    return (int)k;
+}
+
+int WiFiClient::peek() {
+    if (!conn_ || conn_->available() == 0) return -1;
+    return (uint8_t)conn_->rx[conn_->rpos];
+}
+
+// Stream::readStringUntil 과 같이 바이트가 오지 않으면 타임아웃까지 블로킹한다.
+String WiFiClient::readStringUntil(char terminator) {
+    std::string out;
+    if (!conn_) return String();
+    const uint64_t deadline = sim::nowUs() + (uint64_t)timeoutMs_ * 1000;
+    while (true) {
+        if (conn_->available() > 0) {
+            const char c = (char)read();
+            if (c == terminator) break;
+            out += c;
+            continue;
+        }
+        if (conn_->rpos >= conn_->rx.size() || sim::nowUs() >= deadline) break;
+        const uint64_t next = conn_->rxAtUs[conn_->rpos];
+        sim::advanceUs((next < deadline ? next : deadline) - sim::nowUs());
+    }
+    return String(out);
+}
+
+void WiFiClient::stop() {
+    if (conn_) conn_->closed = true;
+}
+
+size_t WiFiClient::write(uint8_t c) {
+    if (!conn_ || conn_->closed) return 0;
+    conn_->tx += (char)c;
+    return 1;
+}
+
+size_t WiFiClient::write(const uint8_t* buf, size_t n) {
+    if (!conn_ || conn_->closed) return 0;
+    conn_->tx.append((const char*)buf, n);
+    return n;
+}
+
+WiFiClient WiFiServer::available() {
+    return WiFiClient(sim::nextReadableConnection());
+}
+
+int WiFiUDP::parsePacket() {
+    sim::Datagram d;
+    rx_.clear();
+    rpos_ = 0;
+    if (port_ == 0 || !sim::receiveUdp(port_, d)) return 0;
+    rx_ = d.data;
+    return (int)rx_.size();
+}
+
+int WiFiUDP::read(uint8_t* buf, size_t n) {
+    size_t k = 0;
+    while (k < n && rpos_ < rx_.size()) buf[k++] = (uint8_t)rx_[rpos_++];
+    return (int)k;
+}
+
+int WiFiUDP::endPacket() {
+    sim::udpSent().push_back(sim::Datagram{tx_, sim::nowUs()});
+    tx_.clear();
+    return 1;
+}
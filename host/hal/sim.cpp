@@ -0,0 +1,334 @@
+// host/hal/sim.cpp
+#include "sim.h"
+#include <Arduino.h>
+#include <cmath>
+#include <map>
+#include <queue>
+
+namespace sim {
+
+// ───────── 핀 매핑 (gridMove.cpp / lift.cpp 와 동일) ─────────
+static constexpr uint8_t RIGHT_DIR_PIN = 2;
+static constexpr uint8_t RIGHT_PWM_PIN = 3;
+static constexpr uint8_t LEFT_DIR_PIN  = 4;
+static constexpr uint8_t LEFT_PWM_PIN  = 5;
+static constexpr uint8_t LEFT_ENC_A_PIN  = A1;
+static constexpr uint8_t LEFT_ENC_B_PIN  = A2;
+static constexpr uint8_t RIGHT_ENC_A_PIN = A3;
+static constexpr uint8_t RIGHT_ENC_B_PIN = A4;
+
+static constexpr uint8_t LIFT_DIR_PIN   = 10;
+static constexpr uint8_t LIFT_STEP_PIN  = 11;
+static constexpr uint8_t LIFT_EN_PIN    = 12;
+static constexpr uint8_t LIFT_RELAY_PIN = 13;
+static constexpr uint8_t LIFT_TRIG_PIN  = 8;
+static constexpr uint8_t LIFT_ECHO_PIN  = 9;
+
+static constexpr int NUM_PINS = 32;
+static constexpr double HALF_PI = 1.5707963267948966;
+
+struct Event {
+    uint64_t at;
+    uint64_t seq;
+    std::function<void()> fn;
+    bool operator>(const Event& o) const { return at != o.at ? at > o.at : seq > o.seq; }
+};
+
+struct Isr { void (*fn)() = nullptr; int mode = 0; };
+
+struct State {
+    Config   cfg;
+    uint64_t now = 0;
+    uint64_t seq = 0;
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events;
+
+    int level[NUM_PINS]{};
+    int duty[NUM_PINS]{};
+    Isr isr[NUM_PINS]{};
+
+    Pose   pose{0.0, 0.0, 0.0};
+    double gl = 0.0, gr = 0.0; // 바퀴 접지 속도 [칸/ms]
+    double wheelL = 0.0, wheelR = 0.0; // 바퀴가 간 거리 누적 [칸] (앞으로 +)
+    int64_t encL = 0, encR = 0;        // 쿼드러처 상태 번호 (A/B 한 번 바뀔 때마다 ±1)
+    double spun = 0.0;
+    uint32_t starts = 0;
+    bool   moving = false;
+    uint64_t startUs = 0;
+    uint64_t stopUs = 0;
+
+    double   liftCm = 1.5;
+    uint32_t liftSteps = 0;
+
+    std::vector<std::shared_ptr<Connection>> conns;
+    std::multimap<std::pair<uint16_t, uint64_t>, std::string> udpIn; // (포트, 도착 시각) 순
+    std::vector<Datagram> udpOut;
+};
+
+static State& S() { static State s; return s; }
+
+Config& config() { return S().cfg; }
+
+// ----- 구동 모델 -----
+// 바퀴 속도[칸/ms] = 듀티 / 기준 듀티 / 전진 시간 × 배율. DIR=LOW → 전진.
+static double wheelSpeed(uint8_t dirPin, uint8_t pwmPin, double refDuty, double gain) {
+    const State& s = S();
+    const double v = gain * (s.duty[pwmPin] / refDuty) / s.cfg.fwdCellMs;
+    return s.level[dirPin] == LOW ? v : -v;
+}
+
+static double trackWidth() {
+    // 기준 듀티로 제자리 회전 시 rot90Ms 에 90도가 되도록 역산
+    const Config& c = S().cfg;
+    return 2.0 * (1.0 / c.fwdCellMs) * c.rot90Ms / HALF_PI;
+}
+
+// 접지 속도 g 를 목표 u 쪽으로 최대 a*dt 만큼 옮긴다
+static double approach(double g, double u, double step) {
+    if (g < u) return g + step < u ? g + step : u;
+    return g - step > u ? g - step : u;
+}
+
+// 바퀴 접지 속도 (vl, vr) 로 dt[ms] 동안 자세를 적분
+static void advancePose(double vl, double vr, double dt) {
+    State& s = S();
+    const double v = 0.5 * (vl + vr);
+    const double w = (vr - vl) / trackWidth();
+    const double th = s.pose.theta;
+    s.wheelL += vl * dt;
+    s.wheelR += vr * dt;
+    if (std::fabs(w) < 1e-12) {
+        s.pose.x += v * std::cos(th) * dt;
+        s.pose.y += v * std::sin(th) * dt;
+    } else {
+        const double th2 = th + w * dt;
+        s.pose.x += v / w * (std::sin(th2) - std::sin(th));
+        s.pose.y -= v / w * (std::cos(th2) - std::cos(th));
+        s.pose.theta = th2;
+        if (vl * vr < 0) s.spun += std::fabs(w * dt);
+    }
+}
+
+// 상태 번호를 target 까지 한 칸씩 옮기며 A/B 를 그레이 코드(00→10→11→01)로 바꾼다.
+// 상태 4개에 A 에지가 2번이므로 상태 수 = A 에지(틱) 수 × 2.
+static void stepEncoder(int64_t& state, int64_t target, uint8_t pinA, uint8_t pinB) {
+    while (state != target) {
+        state += state < target ? 1 : -1;
+        const int p = (int)(state & 3);
+        setInputLevel(pinA, p == 1 || p == 2);
+        setInputLevel(pinB, p >= 2);
+    }
+}
+
+static void syncEncoders() {
+    State& s = S();
+    if (s.cfg.encoderTicksPerCell <= 0) return;
+    const double k = 2.0 * s.cfg.encoderTicksPerCell;
+    stepEncoder(s.encL, (int64_t)std::floor(s.wheelL * k), LEFT_ENC_A_PIN, LEFT_ENC_B_PIN);
+    stepEncoder(s.encR, (int64_t)std::floor(s.wheelR * k), RIGHT_ENC_A_PIN, RIGHT_ENC_B_PIN);
+}
+
+static void integrateTo(uint64_t t) {
+    State& s = S();
+    if (t <= s.now) return;
+    double dt = (t - s.now) / 1000.0; // ms
+    const double ul = wheelSpeed(LEFT_DIR_PIN,  LEFT_PWM_PIN,  s.cfg.leftRefDuty,  s.cfg.leftWheelGain);
+    const double ur = wheelSpeed(RIGHT_DIR_PIN, RIGHT_PWM_PIN, s.cfg.rightRefDuty, s.cfg.rightWheelGain);
+    const double accel = s.cfg.tractionCellsPerS2 / 1e6; // 칸/ms^2
+    if (accel <= 0) { s.gl = ul; s.gr = ur; }
+
+    // 접지 속도가 목표에 닿을 때까지는 1ms 씩 (가감속 구간), 닿은 뒤는 한 번에
+    while (dt > 0 && (s.gl != ul || s.gr != ur)) {
+        const double h = dt < 1.0 ? dt : 1.0;
+        const double gl = approach(s.gl, ul, accel * h);
+        const double gr = approach(s.gr, ur, accel * h);
+        advancePose(0.5 * (s.gl + gl), 0.5 * (s.gr + gr), h);
+        s.gl = gl;
+        s.gr = gr;
+        dt -= h;
+    }
+    if (dt > 0) advancePose(s.gl, s.gr, dt);
+    s.now = t;
+    syncEncoders();
+}
+
+static void updateMotion() {
+    State& s = S();
+    const bool movingNow = s.duty[LEFT_PWM_PIN] > 0 || s.duty[RIGHT_PWM_PIN] > 0;
+    if (movingNow && !s.moving) { s.starts++; s.startUs = s.now; }
+    if (!movingNow && s.moving) s.stopUs = s.now;
+    s.moving = movingNow;
+}
+
+// ----- 가상 시계 -----
+uint64_t nowUs() { return S().now; }
+
+void advanceUs(uint64_t us) {
+    State& s = S();
+    const uint64_t target = s.now + us;
+    while (!s.events.empty() && s.events.top().at <= target) {
+        Event e = s.events.top();
+        s.events.pop();
+        integrateTo(e.at);
+        e.fn();
+    }
+    integrateTo(target);
+}
+
+void schedule(uint64_t atUs, std::function<void()> fn) {
+    State& s = S();
+    s.events.push(Event{atUs < s.now ? s.now : atUs, s.seq++, std::move(fn)});
+}
+
+void reset() {
+    Config keep = S().cfg;
+    S() = State{};
+    S().cfg = keep;
+}
+
+// ----- 핀 -----
+void pinWrite(uint8_t pin, int level) {
+    State& s = S();
+    if (pin >= NUM_PINS) return;
+    integrateTo(s.now);
+    const int prev = s.level[pin];
+    s.level[pin] = level ? HIGH : LOW;
+
+    // 리프트: EN(LOW=활성) + 릴레이 ON 상태에서 STEP 상승 에지마다 한 스텝
+    if (pin == LIFT_STEP_PIN && prev == LOW && level == HIGH &&
+        s.level[LIFT_EN_PIN] == LOW && s.level[LIFT_RELAY_PIN] == HIGH) {
+        const double d = s.level[LIFT_DIR_PIN] == HIGH ? s.cfg.liftCmPerStep : -s.cfg.liftCmPerStep;
+        s.liftCm = std::fmin(s.cfg.liftMaxCm, std::fmax(s.cfg.liftMinCm, s.liftCm + d));
+        s.liftSteps++;
+    }
+    // 초음파: TRIG 하강 후 echoDelayUs 뒤 ECHO 가 높이에 비례한 폭으로 HIGH
+    if (pin == LIFT_TRIG_PIN && prev == HIGH && level == LOW && !s.cfg.noEcho) {
+        const uint64_t rise = s.now + s.cfg.echoDelayUs;
+        const uint64_t width = (uint64_t)std::lround(s.liftCm * 2.0 / 0.034);
+        schedule(rise, [] { setInputLevel(LIFT_ECHO_PIN, HIGH); });
+        schedule(rise + width, [] { setInputLevel(LIFT_ECHO_PIN, LOW); });
+    }
+    if (pin == LEFT_DIR_PIN || pin == RIGHT_DIR_PIN) updateMotion();
+}
+
+int pinLevel(uint8_t pin) { return pin < NUM_PINS ? S().level[pin] : LOW; }
+
+void pwmWrite(uint8_t pin, int duty) {
+    State& s = S();
+    if (pin >= NUM_PINS) return;
+    integrateTo(s.now);
+    s.duty[pin] = duty < 0 ? 0 : (duty > 255 ? 255 : duty);
+    s.level[pin] = s.duty[pin] > 0 ? HIGH : LOW;
+    updateMotion();
+}
+
+void setInputLevel(uint8_t pin, int level) {
+    State& s = S();
+    if (pin >= NUM_PINS) return;
+    const int prev = s.level[pin];
+    s.level[pin] = level ? HIGH : LOW;
+    const Isr& h = s.isr[pin];
+    if (!h.fn || prev == s.level[pin]) return;
+    if (h.mode == CHANGE ||
+        (h.mode == RISING && s.level[pin] == HIGH) ||
+        (h.mode == FALLING && s.level[pin] == LOW)) {
+        h.fn();
+    }
+}
+
+void attachIsr(uint8_t pin, void (*fn)(), int mode) {
+    if (pin < NUM_PINS) S().isr[pin] = Isr{fn, mode};
+}
+
+unsigned long pulseIn(uint8_t pin, uint8_t state, unsigned long timeoutUs) {
+    State& s = S();
+    if (pin != LIFT_ECHO_PIN || state != HIGH || s.cfg.noEcho) {
+        advanceUs(timeoutUs);
+        return 0;
+    }
+    // 왕복 거리 / 음속(0.034 cm/us)
+    const unsigned long dur = (unsigned long)std::lround(s.liftCm * 2.0 / 0.034);
+    if (s.cfg.echoDelayUs + dur > timeoutUs) {
+        advanceUs(timeoutUs);
+        return 0;
+    }
+    advanceUs(s.cfg.echoDelayUs + dur);
+    return dur;
+}
+
+// ----- 로봇 상태 -----
+Pose pose() { integrateTo(S().now); return S().pose; }
+void setPose(const Pose& p) {
+    S().pose = p;
+    S().gl = S().gr = 0.0; // 정지 상태로 놓는다
+}
+double spunRad() { return S().spun; }
+uint32_t motorStarts() { return S().starts; }
+uint64_t lastMotorStartUs() { return S().startUs; }
+uint64_t lastMotorStopUs() { return S().stopUs; }
+
+double liftHeightCm() { return S().liftCm; }
+void setLiftHeightCm(double cm) { S().liftCm = cm; }
+uint32_t liftSteps() { return S().liftSteps; }
+
+// ----- EEPROM -----
+static uint8_t* eepromBytes() {
+    static uint8_t bytes[EEPROM_SIZE];
+    static bool init = false;
+    if (!init) { memset(bytes, 0xFF, sizeof(bytes)); init = true; }
+    return bytes;
+}
+uint8_t* eeprom() { return eepromBytes(); }
+void eraseEeprom() { memset(eepromBytes(), 0xFF, EEPROM_SIZE); }
+
+// ----- 네트워크 -----
+size_t Connection::available() const {
+    const uint64_t now = S().now;
+    size_t n = 0;
+    for (size_t i = rpos; i < rx.size() && rxAtUs[i] <= now; ++i) n++;
+    return n;
+}
+
+std::shared_ptr<Connection> openConnection(const std::string& bytes,
+                                           uint64_t atUs,
+                                           uint32_t bytesPerMs) {
+    auto c = std::make_shared<Connection>();
+    c->rx = bytes;
+    c->rxAtUs.resize(bytes.size());
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        c->rxAtUs[i] = bytesPerMs ? atUs + (uint64_t)i * 1000 / bytesPerMs : atUs;
+    }
+    S().conns.push_back(c);
+    return c;
+}
+
+void appendRx(const std::shared_ptr<Connection>& c, const std::string& bytes, uint64_t atUs) {
+    c->rx += bytes;
+    c->rxAtUs.insert(c->rxAtUs.end(), bytes.size(), atUs);
+}
+
+std::shared_ptr<Connection> nextReadableConnection() {
+    auto& conns = S().conns;
+    for (size_t i = 0; i < conns.size();) {
+        if (conns[i]->closed) { conns.erase(conns.begin() + i); continue; }
+        if (conns[i]->available() > 0) return conns[i];
+        ++i;
+    }
+    return nullptr;
+}
+
+void sendUdp(uint16_t port, const std::string& bytes, uint64_t atUs) {
+    S().udpIn.emplace(std::make_pair(port, atUs), bytes);
+}
+
+bool receiveUdp(uint16_t port, Datagram& out) {
+    auto& in = S().udpIn;
+    auto it = in.lower_bound(std::make_pair(port, (uint64_t)0));
+    if (it == in.end() || it->first.first != port || it->first.second > S().now) return false;
+    out = Datagram{it->second, it->first.second};
+    in.erase(it);
+    return true;
+}
+
+std::vector<Datagram>& udpSent() { return S().udpOut; }
+
+} // namespace sim
@@ -0,0 +1,109 @@
+// host/hal/sim.h
+// 결정적(deterministic) 호스트 시뮬레이터.
+// - 가상 시계: delay/delayMicroseconds/pulseIn 등 블로킹 호출만 시간을 소모한다.
+// - 차동 구동 모터 모델: DIR/PWM 핀 출력으로 로봇 자세(칸 단위)를 적분하고,
+//   바퀴가 간 거리만큼 쿼드러처 엔코더 A/B 핀을 토글한다 (ISR 호출 포함).
+// - 리프트 모델: STEP 상승 에지마다 높이 변화, 초음파 ECHO 는 높이에 비례.
+#ifndef HOST_SIM_H
+#define HOST_SIM_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sim {
+
+// ----- 모델 파라미터 (gridMove.h / lift.cpp 기본값에 맞춤) -----
+struct Config {
+    // 구동부: 기준 듀티에서 한 칸 전진 시간, 90도 회전 시간
+    double fwdCellMs     = 5373.0;
+    double rot90Ms       = 1970.0;
+    double leftRefDuty   = 73.0;
+    double rightRefDuty  = 63.0;
+    // 접지력: 바퀴 접지 속도가 바뀔 수 있는 최대 가감속 [칸/s^2] (0 = 무한, 즉시 듀티 속도)
+    // 듀티가 이보다 빨리 바뀌면 바퀴가 헛돌거나 미끄러져 접지 속도가 늦게 따라간다.
+    double tractionCellsPerS2 = 0.0;
+    // 바퀴별 속도 배율 (좌우 모터 차이, 배터리 전압 저하 흉내). 1 = 기준 듀티에서 설계 속도.
+    double leftWheelGain  = 1.0;
+    double rightWheelGain = 1.0;
+    // 바퀴 엔코더: 한 칸 갈 때 A상 에지 수 (gridMove 의 ticksPerCell 과 같은 단위). 0 = 엔코더 없음.
+    double encoderTicksPerCell = 360.0;
+
+    // 리프트
+    double liftCmPerStep = 0.0015;
+    double liftMinCm     = 0.0;
+    double liftMaxCm     = 6.0;
+    uint32_t echoDelayUs = 250;   // TRIG 후 ECHO 상승까지 지연
+    bool   noEcho        = false; // true 면 ECHO 없음 → pulseIn 타임아웃
+
+    bool   echoSerial    = false; // Serial 출력을 stdout 으로
+};
+
+Config& config();
+
+// ----- 가상 시계 -----
+uint64_t nowUs();
+void advanceUs(uint64_t us);
+void schedule(uint64_t atUs, std::function<void()> fn);
+void reset();
+
+// ----- 핀 (Arduino.h 구현부에서 사용) -----
+void pinWrite(uint8_t pin, int level);
+int  pinLevel(uint8_t pin);
+void pwmWrite(uint8_t pin, int duty);
+void setInputLevel(uint8_t pin, int level); // 외부 신호 입력 (ISR 호출 포함)
+void attachIsr(uint8_t pin, void (*fn)(), int mode);
+unsigned long pulseIn(uint8_t pin, uint8_t state, unsigned long timeoutUs);
+
+// ----- 로봇 상태 -----
+struct Pose { double x; double y; double theta; }; // 칸 단위, theta=0 → RIGHT(+x)
+Pose pose();
+void setPose(const Pose& p);
+double spunRad();        // 누적 제자리 회전각 (절대값)
+uint32_t motorStarts();  // 정지 → 구동 전환 횟수
+uint64_t lastMotorStartUs(); // 마지막 정지 → 구동 전환 시각
+uint64_t lastMotorStopUs();  // 마지막 구동 → 정지 전환 시각
+
+double liftHeightCm();
+void setLiftHeightCm(double cm);
+uint32_t liftSteps();
+
+// ----- EEPROM (UNO R4 는 1KB) -----
+static constexpr size_t EEPROM_SIZE = 1024;
+uint8_t* eeprom();       // 처음엔 0xFF (지운 상태). reset() 으로 지워지지 않는다.
+void eraseEeprom();
+
+// ----- 네트워크 -----
+struct Connection {
+    std::string rx;               // 클라이언트 → 로봇
+    std::vector<uint64_t> rxAtUs; // 각 바이트 도착 시각
+    size_t rpos = 0;
+    std::string tx;               // 로봇 → 클라이언트
+    bool closed = false;
+    size_t available() const;
+};
+
+// bytes 를 atUs 부터 bytesPerMs 속도로 보낸다 (0 이면 한꺼번에 도착).
+std::shared_ptr<Connection> openConnection(const std::string& bytes,
+                                           uint64_t atUs,
+                                           uint32_t bytesPerMs = 0);
+// 열린 연결에 바이트를 더 보낸다 (WebSocket 프레임 등)
+void appendRx(const std::shared_ptr<Connection>& c, const std::string& bytes, uint64_t atUs);
+std::shared_ptr<Connection> nextReadableConnection();
+
+// UDP 데이터그램 (WiFiUDP 대체). 로봇 쪽 포트로 atUs 에 도착하도록 보낸다.
+struct Datagram {
+    std::string data;
+    uint64_t atUs;
+};
+void sendUdp(uint16_t port, const std::string& bytes, uint64_t atUs);
+// port 로 지금까지 도착한 것 중 가장 이른 데이터그램을 꺼낸다
+bool receiveUdp(uint16_t port, Datagram& out);
+// 로봇 → 클라이언트로 보낸 데이터그램 (보낸 순서)
+std::vector<Datagram>& udpSent();
+
+} // namespace sim
+
+#endif // HOST_SIM_H
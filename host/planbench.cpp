@@ -0,0 +1,437 @@
+// host/planbench.cpp
+// 칸 플래너 엔진 벤치 (보드 빌드와 무관한 호스트 전용 도구)
+// 시드 무작위 지도 (크기 × 장애물 밀도) 마다 통로 칸 (출발, 목표) 쌍을 계획해 엔진별로
+// 초당 계획 수, 계획 한 번의 평균 전개 칸 수, 작업 메모리/최대 스택 바이트, 칸 수 최적 비율을 낸다.
+// 결과는 모두 validatePath (5x5 는 validatePath5x5 도), 끝점, 기준 BFS 의 도달 여부와 비교한다.
+//
+//   ./build/scvplanbench                                         # 표만
+//   ./build/scvplanbench --baseline host/planbench_baseline.txt  # 기준과 비교, 회귀면 종료 코드 1
+//   ./build/scvplanbench --write-baseline host/planbench_baseline.txt
+//
+// 새 엔진은 Engine 구조체 하나 (prepare/plan/scratch) 를 만들어 benchSize() 에 한 줄 넣으면 된다.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <ucontext.h>
+#include "astar5x5.h"
+#include "routeTable.h"
+
+namespace {
+
+struct Options {
+  uint32_t    seed    = 1;
+  int         maps    = 20;   // 크기 × 밀도마다 지도 수
+  int         queries = 100;  // 지도마다 (출발, 목표) 쌍 수
+  int         reps    = 20;   // 시간 잴 때 지도마다 되풀이 (가장 빠른 회차를 쓴다)
+  double      speedTol = 50;  // 기준 대비 허용하는 초당 계획 수 감소 [%]
+  std::string baseline;
+  std::string writeBaseline;
+};
+
+constexpr int kDensities[] = {0, 15, 30}; // 장애물 비율 [%]
+
+struct Query {
+  int sx, sy, gx, gy;
+  int dist; // 기준 BFS 칸 수 거리, 닿을 수 없으면 -1
+};
+
+template <int W, int H>
+struct Case {
+  OccupancyGrid<W, H> grid;
+  std::vector<Query>  queries;
+};
+
+struct Row {
+  std::string engine;
+  std::string map;   // "5x5" 등
+  int      density = 0;
+  double   plansPerS = 0;
+  double   expanded = 0;   // 계획 한 번 평균
+  double   optimalPct = 0; // 찾은 경로 중 칸 수 최단 비율
+  size_t   scratch = 0;    // 스택 밖 작업 메모리 [B]
+  size_t   stack = 0;      // 계획 중 최대 스택 [B]
+  unsigned plans = 0;      // 확인한 계획 수 (되풀이 제외)
+  unsigned found = 0;
+  unsigned invalid = 0;    // 잘못된 경로 또는 도달 여부 불일치
+};
+
+// ---- 기준 BFS (플래너 코드와 독립) ----
+template <int W, int H>
+int bfsDistance(const OccupancyGrid<W, H>& grid, int sx, int sy, int gx, int gy) {
+  std::vector<int> dist(W * H, -1);
+  std::vector<int> queue;
+  queue.reserve(W * H);
+  dist[sy * W + sx] = 0;
+  queue.push_back(sy * W + sx);
+  for (size_t head = 0; head < queue.size(); ++head) {
+    const int u = queue[head], ux = u % W, uy = u / W;
+    if (ux == gx && uy == gy) return dist[u];
+    const int nx[4] = {ux + 1, ux - 1, ux, ux}, ny[4] = {uy, uy, uy + 1, uy - 1};
+    for (int d = 0; d < 4; ++d) {
+      if (!grid.inBounds(nx[d], ny[d]) || grid.blocked(nx[d], ny[d])) continue;
+      const int v = ny[d] * W + nx[d];
+      if (dist[v] >= 0) continue;
+      dist[v] = dist[u] + 1;
+      queue.push_back(v);
+    }
+  }
+  return -1;
+}
+
+// 크기/밀도마다 시드를 달리해 표의 한 줄이 다른 줄 설정에 영향받지 않게 한다
+template <int W, int H>
+std::vector<Case<W, H>> makeCases(int density, const Options& opt) {
+  std::mt19937 rng(opt.seed * 1000003u + (uint32_t)(W * 10007 + H * 101 + density));
+  std::vector<Case<W, H>> cases;
+  while ((int)cases.size() < opt.maps) {
+    Case<W, H> c;
+    std::vector<int> open;
+    for (int y = 0; y < H; ++y) {
+      for (int x = 0; x < W; ++x) {
+        const bool blocked = (int)(rng() % 100) < density;
+        c.grid.set(x, y, blocked);
+        if (!blocked) open.push_back(y * W + x);
+      }
+    }
+    if (open.size() < 2) continue;
+    for (int i = 0; i < opt.queries; ++i) {
+      const int s = open[rng() % open.size()], g = open[rng() % open.size()];
+      Query q{s % W, s / W, g % W, g / W, 0};
+      q.dist = bfsDistance(c.grid, q.sx, q.sy, q.gx, q.gy);
+      c.queries.push_back(q);
+    }
+    cases.push_back(std::move(c));
+  }
+  return cases;
+}
+
+// ---- 최대 스택 측정 ----
+// 0xA5 로 칠한 별도 스택에서 함수를 돌리고, 칠이 지워진 깊이를 잰다 (빈 함수의 깊이는 뺀다).
+namespace stackprobe {
+
+constexpr size_t  kBytes = 64 * 1024;
+constexpr uint8_t kPaint = 0xA5;
+alignas(16) uint8_t stack_[kBytes];
+ucontext_t caller_, probe_;
+const std::function<void()>* job_ = nullptr;
+
+void trampoline() { (*job_)(); }
+
+size_t rawDepth(const std::function<void()>& f) {
+  memset(stack_, kPaint, kBytes);
+  job_ = &f;
+  getcontext(&probe_);
+  probe_.uc_stack.ss_sp = stack_;
+  probe_.uc_stack.ss_size = kBytes;
+  probe_.uc_link = &caller_;
+  makecontext(&probe_, trampoline, 0);
+  swapcontext(&caller_, &probe_);
+  size_t untouched = 0; // 스택은 높은 주소에서 낮은 쪽으로 자란다
+  while (untouched < kBytes && stack_[untouched] == kPaint) ++untouched;
+  return kBytes - untouched;
+}
+
+size_t depth(const std::function<void()>& f) {
+  static const size_t empty = rawDepth([] {});
+  const size_t d = rawDepth(f);
+  return d > empty ? d - empty : 0;
+}
+
+} // namespace stackprobe
+
+// ---- 엔진 ----
+// prepare() 는 지도가 바뀔 때 한 번 (시간 재기에서 뺌), plan() 은 계획 한 번.
+// 5x5 는 스케치가 부르는 planPath5x5() 래퍼 그대로 잰다 (bool 지도 → 엔진 변환 포함).
+template <int W, int H>
+struct AstarEngine {
+  static constexpr const char* NAME = "astar";
+  static size_t scratch() { return sizeof(AstarWorkspace<W, H>); }
+
+  void prepare(const OccupancyGrid<W, H>& grid) {
+    grid_ = grid;
+    for (int y = 0; y < H; ++y)
+      for (int x = 0; x < W; ++x) cells_[y][x] = grid.blocked(x, y);
+  }
+  AStarResult plan(const Query& q, PathRunner::Node* out, uint16_t maxOut) {
+    if constexpr (W == 5 && H == 5)
+      return planPath5x5(PlannerEngine::Astar, cells_, q.sx, q.sy, q.gx, q.gy, out, maxOut);
+    else
+      return planAstar<W, H>(grid_, q.sx, q.sy, q.gx, q.gy, out, maxOut, ws_);
+  }
+
+  OccupancyGrid<W, H>  grid_;
+  bool                 cells_[H][W];
+  AstarWorkspace<W, H> ws_;
+};
+
+template <int W, int H>
+struct BitboardEngine {
+  static constexpr const char* NAME = "bitboard";
+  static size_t scratch() { return 0; }
+
+  void prepare(const OccupancyGrid<W, H>& grid) {
+    passable_ = bitboardFree(grid);
+    for (int y = 0; y < H; ++y)
+      for (int x = 0; x < W; ++x) cells_[y][x] = grid.blocked(x, y);
+  }
+  AStarResult plan(const Query& q, PathRunner::Node* out, uint16_t maxOut) {
+    if constexpr (W == 5 && H == 5)
+      return planPath5x5(PlannerEngine::Bitboard, cells_, q.sx, q.sy, q.gx, q.gy, out, maxOut);
+    else
+      return planBitboard<W, H>(passable_, q.sx, q.sy, q.gx, q.gy, out, maxOut);
+  }
+
+  uint64_t passable_ = 0;
+  bool     cells_[H][W];
+};
+
+// 전 쌍 다음 칸 표: 질의는 탐색 없이 표를 따라간다 (build 는 prepare 에서, 시간 제외)
+template <int W, int H>
+struct RouteEngine {
+  static constexpr const char* NAME = "routes";
+  static size_t scratch() { return sizeof(RouteTable<W, H>); }
+
+  void prepare(const OccupancyGrid<W, H>& grid) { table_->build(grid); }
+  AStarResult plan(const Query& q, PathRunner::Node* out, uint16_t maxOut) {
+    return table_->path(q.sx, q.sy, q.gx, q.gy, out, maxOut);
+  }
+
+  std::unique_ptr<RouteTable<W, H>> table_{new RouteTable<W, H>()};
+};
+
+// ---- 한 줄 (엔진 × 크기 × 밀도) ----
+template <int W, int H>
+bool checkPlan(const Case<W, H>& c, const Query& q, const PathRunner::Node* p, const AStarResult& r) {
+  if (r.ok != (q.dist >= 0)) return false;
+  if (!r.ok) return true;
+  if (!validatePath(c.grid, p, r.n)) return false;
+  if (p[0].x != q.sx || p[0].y != q.sy || p[r.n - 1].x != q.gx || p[r.n - 1].y != q.gy) return false;
+  if constexpr (W == 5 && H == 5) {
+    bool cells[5][5];
+    for (int y = 0; y < 5; ++y)
+      for (int x = 0; x < 5; ++x) cells[y][x] = c.grid.blocked(x, y);
+    if (!validatePath5x5(cells, p, r.n)) return false;
+  }
+  return true;
+}
+
+template <template <int, int> class Engine, int W, int H>
+Row benchEngine(const std::vector<Case<W, H>>& cases, int density, const Options& opt) {
+  constexpr uint16_t kMaxOut = W * H;
+  static PathRunner::Node out[kMaxOut];
+  auto engine = std::make_unique<Engine<W, H>>();
+
+  Row row;
+  row.engine = Engine<W, H>::NAME;
+  row.map = std::to_string(W) + "x" + std::to_string(H);
+  row.density = density;
+  row.scratch = Engine<W, H>::scratch();
+
+  uint64_t expanded = 0;
+  unsigned optimal = 0, timed = 0;
+  double seconds = 0;
+  for (const Case<W, H>& c : cases) {
+    engine->prepare(c.grid);
+    for (const Query& q : c.queries) {
+      const AStarResult r = engine->plan(q, out, kMaxOut);
+      row.plans++;
+      expanded += r.expanded;
+      if (!checkPlan(c, q, out, r)) { row.invalid++; continue; }
+      if (!r.ok) continue;
+      row.found++;
+      if (r.n == q.dist + 1) optimal++;
+    }
+    if (&c == &cases.front()) {
+      row.stack = stackprobe::depth([&] {
+        for (const Query& q : c.queries) engine->plan(q, out, kMaxOut);
+      });
+    }
+
+    // 지도의 질의 전체를 한 묶음으로 reps 번 재고 가장 빠른 묶음을 쓴다 (선점/캐시 잡음 제거)
+    unsigned sink = 0;
+    double best = 0;
+    for (int rep = 0; rep < opt.reps; ++rep) {
+      const auto t0 = std::chrono::steady_clock::now();
+      for (const Query& q : c.queries) sink += engine->plan(q, out, kMaxOut).n;
+      const double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+      if (rep == 0 || s < best) best = s;
+    }
+    seconds += best;
+    timed += (unsigned)c.queries.size();
+    if (sink == 0xFFFFFFFFu) printf(" "); // 최적화로 계획이 지워지지 않게
+  }
+  row.plansPerS = seconds > 0 ? timed / seconds : 0;
+  row.expanded = row.plans ? (double)expanded / row.plans : 0;
+  row.optimalPct = row.found ? 100.0 * optimal / row.found : 100.0;
+  return row;
+}
+
+template <int W, int H>
+void benchSize(const Options& opt, std::vector<Row>& rows) {
+  for (int density : kDensities) {
+    const std::vector<Case<W, H>> cases = makeCases<W, H>(density, opt);
+    rows.push_back(benchEngine<AstarEngine>(cases, density, opt));
+    if constexpr (W <= 8 && H <= 8) rows.push_back(benchEngine<BitboardEngine>(cases, density, opt));
+    rows.push_back(benchEngine<RouteEngine>(cases, density, opt));
+  }
+}
+
+void printRow(const Row& r) {
+  printf("%-9s %-6s %4d%% %12.0f %9.2f %8.2f%% %10zu %8zu %8u\n", r.engine.c_str(), r.map.c_str(), r.density,
+         r.plansPerS, r.expanded, r.optimalPct, r.scratch, r.stack, r.invalid);
+}
+
+// ---- 기준 파일 ----
+// # 주석
+// params <seed> <maps> <queries>
+// <engine> <map> <density> <plans/s> <expanded> <optimal%> <scratch> <stack>
+bool writeBaseline(const std::string& path, const Options& opt, const std::vector<Row>& rows) {
+  FILE* f = fopen(path.c_str(), "w");
+  if (!f) {
+    perror(path.c_str());
+    return false;
+  }
+  fprintf(f, "# scvplanbench 기준값 (--write-baseline 으로 다시 만든다)\n");
+  fprintf(f, "# engine map density plans_per_s expanded optimal_pct scratch_B stack_B\n");
+  fprintf(f, "params %u %d %d\n", opt.seed, opt.maps, opt.queries);
+  for (const Row& r : rows)
+    fprintf(f, "%s %s %d %.0f %.2f %.2f %zu %zu\n", r.engine.c_str(), r.map.c_str(), r.density, r.plansPerS,
+            r.expanded, r.optimalPct, r.scratch, r.stack);
+  fclose(f);
+  return true;
+}
+
+bool readBaseline(const std::string& path, const Options& opt, std::vector<Row>& rows) {
+  FILE* f = fopen(path.c_str(), "r");
+  if (!f) {
+    perror(path.c_str());
+    return false;
+  }
+  char line[256];
+  bool paramsOk = false;
+  while (fgets(line, sizeof(line), f)) {
+    if (line[0] == '#' || line[0] == '\n') continue;
+    unsigned seed;
+    int maps, queries;
+    if (sscanf(line, "params %u %d %d", &seed, &maps, &queries) == 3) {
+      paramsOk = seed == opt.seed && maps == opt.maps && queries == opt.queries;
+      if (!paramsOk)
+        fprintf(stderr, "%s: recorded with --seed %u --maps %d --queries %d\n", path.c_str(), seed, maps, queries);
+      continue;
+    }
+    char engine[32], map[16];
+    Row r;
+    if (sscanf(line, "%31s %15s %d %lf %lf %lf %zu %zu", engine, map, &r.density, &r.plansPerS, &r.expanded,
+               &r.optimalPct, &r.scratch, &r.stack) != 8) {
+      fprintf(stderr, "%s: bad line: %s", path.c_str(), line);
+      fclose(f);
+      return false;
+    }
+    r.engine = engine;
+    r.map = map;
+    rows.push_back(r);
+  }
+  fclose(f);
+  return paramsOk;
+}
+
+// 전개 수/최적 비율/작업 메모리는 같은 시드면 결정적이라 거의 그대로 비교하고,
+// 스택은 컴파일러에 따라 조금 달라 25%, 초당 계획 수는 기계/부하에 따라 --speed-tol 만큼 봐준다.
+unsigned compareBaseline(const std::vector<Row>& base, const std::vector<Row>& rows, const Options& opt) {
+  unsigned regressions = 0;
+  printf("\nbaseline comparison (speed tolerance %.0f%%)\n", opt.speedTol);
+  for (const Row& b : base) {
+    const Row* cur = nullptr;
+    for (const Row& r : rows)
+      if (r.engine == b.engine && r.map == b.map && r.density == b.density) cur = &r;
+    char what[200] = "";
+    size_t n = 0;
+    auto note = [&](const char* fmt, double now, double was) {
+      n += snprintf(what + n, n < sizeof(what) ? sizeof(what) - n : 0, fmt, now, was);
+    };
+    if (!cur) {
+      snprintf(what, sizeof(what), " missing");
+    } else {
+      if (cur->plansPerS < b.plansPerS * (1.0 - opt.speedTol / 100.0)) note(" plans/s %.0f < %.0f", cur->plansPerS, b.plansPerS);
+      if (cur->expanded > b.expanded * 1.01 + 0.01) note(" expanded %.2f > %.2f", cur->expanded, b.expanded);
+      if (cur->optimalPct < b.optimalPct - 0.01) note(" optimal %.2f%% < %.2f%%", cur->optimalPct, b.optimalPct);
+      if (cur->scratch > b.scratch) note(" scratch %.0f > %.0f B", (double)cur->scratch, (double)b.scratch);
+      if (cur->stack > b.stack * 1.25 + 16) note(" stack %.0f > %.0f B", (double)cur->stack, (double)b.stack);
+    }
+    const bool bad = what[0] != '\0';
+    regressions += bad;
+    printf("%-9s %-6s %4d%%  %s%s\n", b.engine.c_str(), b.map.c_str(), b.density, bad ? "REGRESSION" : "ok", what);
+  }
+  for (const Row& r : rows) {
+    bool known = false;
+    for (const Row& b : base) known = known || (r.engine == b.engine && r.map == b.map && r.density == b.density);
+    if (!known) printf("%-9s %-6s %4d%%  new (not in baseline)\n", r.engine.c_str(), r.map.c_str(), r.density);
+  }
+  return regressions;
+}
+
+bool parseArgs(int argc, char** argv, Options& opt) {
+  for (int i = 1; i < argc; ++i) {
+    const char* a = argv[i];
+    const bool hasValue = i + 1 < argc;
+    if (!strcmp(a, "--seed") && hasValue) opt.seed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+    else if (!strcmp(a, "--maps") && hasValue) opt.maps = atoi(argv[++i]);
+    else if (!strcmp(a, "--queries") && hasValue) opt.queries = atoi(argv[++i]);
+    else if (!strcmp(a, "--reps") && hasValue) opt.reps = atoi(argv[++i]);
+    else if (!strcmp(a, "--speed-tol") && hasValue) opt.speedTol = atof(argv[++i]);
+    else if (!strcmp(a, "--baseline") && hasValue) opt.baseline = argv[++i];
+    else if (!strcmp(a, "--write-baseline") && hasValue) opt.writeBaseline = argv[++i];
+    else return false;
+  }
+  return opt.maps > 0 && opt.queries > 0 && opt.reps > 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  Options opt;
+  if (!parseArgs(argc, argv, opt)) {
+    fprintf(stderr, "usage: scvplanbench [--seed S] [--maps N] [--queries N] [--reps N]\n"
+                    "                    [--baseline FILE [--speed-tol PCT]] [--write-baseline FILE]\n");
+    return 2;
+  }
+
+  printf("seed %u, %d maps x %d queries per row, timing best of %d\n\n", opt.seed, opt.maps, opt.queries, opt.reps);
+  printf("%-9s %-6s %5s %12s %9s %9s %10s %8s %8s\n", "engine", "map", "dens", "plans/s", "expanded", "optimal",
+         "scratch_B", "stack_B", "invalid");
+  std::vector<Row> rows;
+  benchSize<5, 5>(opt, rows);
+  benchSize<8, 8>(opt, rows);
+  benchSize<16, 16>(opt, rows);
+  benchSize<32, 32>(opt, rows);
+
+  unsigned invalid = 0;
+  for (const Row& r : rows) {
+    printRow(r);
+    invalid += r.invalid;
+  }
+  printf("\ncross-check    : %u invalid plans (%s)\n", invalid, invalid == 0 ? "ok" : "FAIL");
+
+  if (!opt.writeBaseline.empty()) {
+    if (invalid) {
+      fprintf(stderr, "not writing a baseline from a run with invalid plans\n");
+      return 1;
+    }
+    if (!writeBaseline(opt.writeBaseline, opt, rows)) return 1;
+    printf("baseline       : written to %s\n", opt.writeBaseline.c_str());
+  }
+  unsigned regressions = 0;
+  if (!opt.baseline.empty()) {
+    std::vector<Row> base;
+    if (!readBaseline(opt.baseline, opt, base)) return 2;
+    regressions = compareBaseline(base, rows, opt);
+    printf("baseline       : %u regressions (%s)\n", regressions, regressions == 0 ? "ok" : "FAIL");
+  }
+  return invalid == 0 && regressions == 0 ? 0 : 1;
+}
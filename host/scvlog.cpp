@@ -0,0 +1,52 @@
+// host/scvlog.cpp
+// GET /log 로 받은 이진 이벤트 기록을 한 줄씩 글로 푼다.
+//
+//   curl -s http://<로봇 주소>/log -o log.bin
+//   ./build/scvlog log.bin        # 파일을 주지 않으면 표준 입력
+//
+// HTTP 응답 헤더가 붙어 있으면 (curl -i) 빈 줄 뒤부터 읽는다.
+#include <cstdio>
+#include <string>
+#include "Telemetry.h"
+
+int main(int argc, char** argv) {
+  if (argc > 2) {
+    fprintf(stderr, "usage: scvlog [log.bin]\n");
+    return 2;
+  }
+  FILE* in = argc == 2 ? fopen(argv[1], "rb") : stdin;
+  if (!in) {
+    perror(argv[1]);
+    return 1;
+  }
+  std::string bytes;
+  char chunk[4096];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), in)) > 0) bytes.append(chunk, n);
+  if (in != stdin) fclose(in);
+
+  if (bytes.compare(0, 5, "HTTP/") == 0) {
+    const size_t end = bytes.find("\r\n\r\n");
+    bytes.erase(0, end == std::string::npos ? bytes.size() : end + 4);
+  }
+
+  const uint8_t* p = (const uint8_t*)bytes.data();
+  Telemetry::Header h;
+  if (!Telemetry::unpackHeader(p, bytes.size(), h)) {
+    fprintf(stderr, "scvlog: not a telemetry log (or unsupported version)\n");
+    return 1;
+  }
+  const size_t have = (bytes.size() - Telemetry::HEADER_BYTES) / Telemetry::RECORD_BYTES;
+  printf("# %u records from seq %u (ring %u), robot clock %u ms at download\n", h.count, h.firstSeq,
+         h.capacity, h.nowMs);
+  if (have < h.count) printf("# truncated: only %zu records present\n", have);
+
+  char line[160];
+  for (size_t i = 0; i < have && i < h.count; ++i) {
+    Telemetry::Record r;
+    Telemetry::unpack(p + Telemetry::HEADER_BYTES + i * Telemetry::RECORD_BYTES, r);
+    Telemetry::format(r, line, sizeof(line));
+    printf("%6zu %s\n", h.firstSeq + i, line);
+  }
+  return have < h.count ? 1 : 0;
+}
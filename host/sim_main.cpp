@@ -0,0 +1,1313 @@
+// host/sim_main.cpp
+// 가상 시계 위에서 SCVRobot.ino 의 loop() 를 돌려 미션 단위 사이클 타임을 측정한다.
+//
+//   scvsim                       기본 시나리오 실행
+//   scvsim --missions 1000 --seed 7 --quiet
+//
+// 옵션
+//   --missions N   무작위 미션 N 개 (move_/box/lift_*)
+//   --seed S       난수 시드 (기본 1)
+//   --loop-us U    loop() 1회당 CPU 시간 가정치 [us] (기본 200)
+//   --client-bpms B  느린 클라이언트: 요청 바이트가 ms 당 B 바이트씩 도착 (기본 0 = 한꺼번에)
+//   --no-echo      초음파 ECHO 없음 (pulseIn 타임아웃 상황)
+//   --gap-ms G     앱 왕복 지연 가정치: 이전 미션이 끝나고 G ms 뒤에 다음 명령 전송
+//   --pipeline     끝나기를 기다리지 않고 작업 큐에 자리가 있으면 바로 다음 명령 전송
+//   --stream       /ws WebSocket 하나로 명령을 보내고 상태 프레임을 받는다
+//   --teleop       UDP 원격 조종 루프백 시나리오: 명령 → 모터 지연, 중복/지난 패킷, heartbeat 끊김
+//   --box-pipelined   상자 집기 단계를 겹쳐 실행 (기본은 하나씩, 사이클 비교용)
+//   --drive-bench  가감속 프로파일별 한 칸/네 칸/90도 시간과 자세 오차
+//   --fleet-bench  로봇 대수별 시공간 계획 시간과 시간당 집기 수 (공용 예약표, 우선순위 계획)
+//   --planner-check  칸 플래너 엔진(A*, 비트보드) 결과를 validatePath5x5 로 확인하고 계획 시간 비교
+//   --traction A   바퀴 접지력 [칸/s^2] (기본 0 = 무한, --drive-bench 는 1.5)
+//   --wheel-gain L,R  바퀴별 속도 배율 (좌우 모터 차이/배터리 저하, 기본 1,1)
+//   --no-encoders  바퀴 엔코더 없음: 동작을 시간으로 끝낸다
+//   --calibrate    바퀴 배율을 틀어 둔 채 calib 작업으로 구동 보정 → EEPROM 저장/재적용 확인
+//   --stats        미션 뒤 GET /stats 응답(JSON) 출력
+//   --log          미션 뒤 GET /log 이진 기록을 풀어 출력
+//   --quiet        미션별 출력 생략, 요약만
+//   -v             스케치의 Serial 출력 표시 (이벤트 기록도 Serial 에 한 줄씩)
+#include <Arduino.h>
+#include "hal/sim.h"
+#include "sketch_bridge.h"
+#include "../UdpTeleop.h"
+#include "../Telemetry.h"
+#include "../PathRunner.h"
+#include "../astarSpaceTime.h"
+#include "../astar5x5.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Mission {
+  std::string cmd;
+  int expectX;   // move_ 일 때 도착 예정 칸, 아니면 -1
+  int expectY;
+  std::string during = "";  // 미션 도중 보낼 두 번째 명령 (예: block_)
+  uint32_t    duringAtMs = 0;
+  bool        legFails = false; // mission_ 의 마지막 구간이 실패해야 하고, 리프트는 움직이지 않아야 한다
+};
+
+// 모델 차체의 제자리 90도 회전 틱 수 (바퀴 하나, sim.cpp 바퀴 간격 기준)
+constexpr unsigned kSimTicksPer90 = 132;
+
+struct Options {
+  int      missions = 0;
+  uint32_t seed     = 1;
+  uint32_t loopUs   = 200;
+  uint32_t gapMs    = 0;
+  uint32_t clientBpms = 0;
+  bool     pipeline = false;
+  bool     stream   = false;
+  bool     teleop   = false;
+  bool     boxPipelined = false;
+  bool     driveBench = false;
+  bool     fleetBench = false;
+  bool     plannerCheck = false;
+  double   traction = -1.0;  // 접지력 [칸/s^2], 음수면 모델 기본값
+  bool     noEncoders = false;
+  bool     calibrate = false;
+  bool     stats    = false;
+  bool     log      = false;
+  bool     quiet    = false;
+};
+
+// 루프 지연 히스토그램: 10us 단위, 마지막 칸은 넘침
+class LatencyHist {
+public:
+  void add(uint64_t us) {
+    size_t b = (size_t)(us / 10);
+    if (b >= kBins) b = kBins - 1;
+    bins_[b]++;
+    n_++;
+    if (us > max_) max_ = us;
+    sum_ += us;
+  }
+  uint64_t percentile(double p) const {
+    const uint64_t want = (uint64_t)std::ceil(p * n_);
+    uint64_t acc = 0;
+    for (size_t b = 0; b < kBins; ++b) {
+      acc += bins_[b];
+      if (acc >= want && want > 0) return std::min<uint64_t>((b + 1) * 10, max_); // 칸 위 끝, 최대값을 넘지 않게
+    }
+    return max_;
+  }
+  uint64_t max() const { return max_; }
+  double mean() const { return n_ ? (double)sum_ / n_ : 0.0; }
+  uint64_t count() const { return n_; }
+private:
+  static constexpr size_t kBins = 10000; // 100 ms
+  std::vector<uint64_t> bins_ = std::vector<uint64_t>(kBins, 0);
+  uint64_t n_ = 0, max_ = 0, sum_ = 0;
+};
+
+// 웹 앱 좌표(0~100, y 아래가 0) ↔ 그리드 좌표 변환 (SCVRobot.ino 의 역변환)
+std::string moveCmd(int gx, int gy) {
+  const int wx = gx * 20 + 10;
+  const int wy = (4 - gy) * 20 + 10;
+  return "move_" + std::to_string(wx) + "_" + std::to_string(wy);
+}
+
+std::string cellCmd(const char* verb, int gx, int gy) {
+  return std::string(verb) + moveCmd(gx, gy).substr(4);
+}
+
+// 여러 정류장 미션: 칸 + 동작 문자 (p 집기, d 내려놓기, 0 들르기만)
+struct Stop { int gx, gy; char action; };
+
+std::string missionCmd(const std::vector<Stop>& stops) {
+  std::string cmd = "mission";
+  for (size_t i = 0; i < stops.size(); ++i) {
+    cmd += (i == 0 ? "_" : ".") + moveCmd(stops[i].gx, stops[i].gy).substr(5);
+    if (stops[i].action) cmd += stops[i].action;
+  }
+  return cmd;
+}
+
+std::vector<Mission> defaultScenario() {
+  return {
+    {moveCmd(4, 4), 4, 4},
+    {moveCmd(4, 0), 4, 0},
+    {moveCmd(0, 0), 0, 0},
+    {"lift_up", -1, -1},
+    {"lift_down", -1, -1},
+    // (0,0)→(4,0) 직진 중 (2,0) 을 막음 → (1,0) 에서 위로 우회
+    {moveCmd(4, 0), 4, 0, cellCmd("block", 2, 0), 2000},
+    {cellCmd("free", 2, 0), -1, -1},
+    {moveCmd(2, 2), 2, 2},
+    {"box", -1, -1},
+    {moveCmd(0, 4), 0, 4},
+    // 상자 칸을 지정해 집기: 가장 빠른 쪽 (1,4) 에 오른쪽을 보고 도착 → 회전 없이 집는다
+    {cellCmd("pick", 2, 4), 1, 4},
+    // 위쪽에서만 집을 수 있는 상자: (4,3) 에 아래를 보고 도착
+    {cellCmd("boxsides", 4, 2) + "_u", -1, -1},
+    {cellCmd("pick", 4, 2), 4, 3},
+    // 내려놓을 칸을 가는 도중 막음 → move 가 실패하면 그 자리에서 내려놓지 않는다 (리프트 그대로)
+    {missionCmd({{0, 4, 'd'}}), -1, -1, cellCmd("block", 0, 4), 3000, true},
+    {cellCmd("free", 0, 4), -1, -1},
+    // 요청 순서 그대로면 왕복이 많은 정류장 5개: 로봇이 이동 시간 기준으로 순서를 다시 정한다
+    {missionCmd({{4, 0, 'p'}, {1, 2, 0}, {4, 4, 'd'}, {0, 0, 0}, {2, 4, 0}}), -1, -1},
+    // 다른 로봇이 (2,0) 을 20초 동안 쓴다고 알려 둔 뒤 (0,0)→(4,0): 위로 도는 것보다 (1,0) 에서 기다리는 편이 빠르다
+    {moveCmd(0, 0), 0, 0},
+    {cellCmd("hold", 2, 0) + "_0_20000", -1, -1},
+    {moveCmd(4, 0), 4, 0},
+  };
+}
+
+std::vector<Mission> randomScenario(int count, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::vector<Mission> out;
+  int x = 0, y = 0;
+  bridge::position(x, y);
+  while ((int)out.size() < count) {
+    const int r = (int)(rng() % 10);
+    if (r == 0) { out.push_back({"box", -1, -1}); continue; }
+    if (r == 1) { out.push_back({(rng() & 1) ? "lift_up" : "lift_down", -1, -1}); continue; }
+    const int gx = (int)(rng() % bridge::gridWidth());
+    const int gy = (int)(rng() % bridge::gridHeight());
+    if (bridge::cellBlocked(gx, gy) || (gx == x && gy == y)) continue;
+    out.push_back({moveCmd(gx, gy), gx, gy});
+    x = gx; y = gy;
+  }
+  return out;
+}
+
+std::string request(const std::string& cmd) {
+  return "GET /?cmd=" + cmd + " HTTP/1.1\r\nHost: scv\r\n\r\n";
+}
+
+// ---- /ws 상태 스트림 클라이언트 ----
+// 명령은 마스크한 텍스트 프레임으로 보내고, 로봇이 보낸 프레임을 loop 마다 읽어 시각을 잰다.
+std::string wsFrame(const std::string& text) {
+  static const uint8_t mask[4] = {0x12, 0x34, 0x56, 0x78};
+  std::string f;
+  f += (char)0x81;
+  f += (char)(0x80 | text.size()); // 125 바이트 이하만 사용
+  f.append((const char*)mask, 4);
+  for (size_t i = 0; i < text.size(); ++i) f += (char)(text[i] ^ mask[i & 3]);
+  return f;
+}
+
+struct StreamClient {
+  std::shared_ptr<sim::Connection> conn;
+  size_t   txPos = 0;
+  uint64_t statusFrames = 0;
+  uint64_t replies = 0;
+  std::string lastReply;
+  uint64_t cmdAtUs = 0;
+  uint64_t firstStatusAfterCmd = 0; // 명령 뒤 첫 상태 프레임까지 [us]
+  bool     waitStatus = false;
+  LatencyHist replyLat;    // 명령 → 응답 프레임
+  LatencyHist feedbackLat; // 명령 → 상태 프레임 (작업 반영)
+
+  bool open() {
+    conn = sim::openConnection(
+        "GET /ws HTTP/1.1\r\nHost: scv\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+        "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\nSec-WebSocket-Version: 13\r\n\r\n",
+        sim::nowUs());
+    for (int i = 0; i < 100 && conn->tx.find("\r\n\r\n") == std::string::npos; ++i) {
+      loop();
+      sim::advanceUs(200);
+    }
+    const size_t end = conn->tx.find("\r\n\r\n");
+    // RFC 6455 예시 키의 정답
+    if (end == std::string::npos || conn->tx.find("s3pPLMBiTxaQ9kYGzzhZRbK+xOo=") == std::string::npos) return false;
+    txPos = end + 4;
+    return true;
+  }
+
+  void send(const std::string& cmd, uint64_t atUs) {
+    sim::appendRx(conn, wsFrame(cmd), atUs);
+    cmdAtUs = atUs;
+    waitStatus = true;
+  }
+
+  // 새로 도착한 서버 프레임 처리 (마스크 없음, 길이 < 126)
+  void pump() {
+    const std::string& tx = conn->tx;
+    while (txPos + 2 <= tx.size()) {
+      const size_t len = (uint8_t)tx[txPos + 1] & 0x7F;
+      if (txPos + 2 + len > tx.size()) break;
+      const std::string text = tx.substr(txPos + 2, len);
+      txPos += 2 + len;
+      const uint64_t now = sim::nowUs();
+      if (text.compare(0, 7, "{\"cmd\":") == 0) {
+        replies++;
+        lastReply = text;
+        replyLat.add(now - cmdAtUs);
+      } else {
+        statusFrames++;
+        if (waitStatus && now >= cmdAtUs) {
+          feedbackLat.add(now - cmdAtUs);
+          waitStatus = false;
+        }
+      }
+    }
+  }
+};
+
+StreamClient g_stream;
+
+struct MissionResult {
+  bool     ok;
+  double   virtMs;
+  uint32_t rot90;
+  uint32_t starts;
+  uint64_t loops;
+  double   loopMeanUs;
+  uint64_t loopMaxUs;
+  double   poseErr;
+};
+
+MissionResult runMission(const Mission& m, const Options& opt, LatencyHist& total) {
+  static constexpr uint64_t kTimeoutUs = 300ull * 1000 * 1000;
+  const double   spun0 = sim::spunRad();
+  const uint32_t starts0 = sim::motorStarts();
+  const uint32_t liftSteps0 = sim::liftSteps();
+  const uint64_t t0    = sim::nowUs();
+
+  std::shared_ptr<sim::Connection> conn;
+  const uint64_t replies0 = g_stream.replies;
+  if (opt.stream) g_stream.send(m.cmd, t0 + (uint64_t)opt.gapMs * 1000);
+  else            conn = sim::openConnection(request(m.cmd), t0 + (uint64_t)opt.gapMs * 1000, opt.clientBpms);
+  std::shared_ptr<sim::Connection> extra;
+  if (!m.during.empty()) {
+    extra = sim::openConnection(request(m.during), t0 + (uint64_t)(opt.gapMs + m.duringAtMs) * 1000,
+                                opt.clientBpms);
+  }
+
+  LatencyHist local;
+  MissionResult r{false, 0, 0, 0, 0, 0, 0, 0};
+  while (sim::nowUs() - t0 < kTimeoutUs) {
+    const uint64_t before = sim::nowUs();
+    loop();
+    sim::advanceUs(opt.loopUs);
+    const uint64_t dt = sim::nowUs() - before;
+    local.add(dt);
+    total.add(dt);
+    if (opt.stream) g_stream.pump();
+    const bool replied = opt.stream ? g_stream.replies > replies0 : conn->closed;
+    if (replied && (!extra || extra->closed) && bridge::robotIdle()) { r.ok = true; break; }
+  }
+
+  r.virtMs     = (sim::nowUs() - t0) / 1000.0;
+  r.rot90      = (uint32_t)std::lround((sim::spunRad() - spun0) / 1.5707963267948966);
+  r.starts     = sim::motorStarts() - starts0;
+  r.loops      = local.count();
+  r.loopMeanUs = local.mean();
+  r.loopMaxUs  = local.max();
+  if (m.expectX >= 0) {
+    const sim::Pose p = sim::pose();
+    r.poseErr = std::hypot(p.x - m.expectX, p.y - m.expectY);
+    int x = 0, y = 0;
+    bridge::position(x, y);
+    if (x != m.expectX || y != m.expectY) r.ok = false;
+  }
+  if (m.legFails) {
+    const int k = bridge::missionLegCount() - 1;
+    int x, y;
+    unsigned plannedMs, actualMs;
+    if (k < 0 || bridge::missionLeg(k, x, y, plannedMs, actualMs) || sim::liftSteps() != liftSteps0) r.ok = false;
+  }
+  return r;
+}
+
+// 파이프라인: 작업 큐에 자리가 있으면 응답을 받자마자 다음 명령을 보낸다.
+// 미션별 시간은 겹치므로 전체 시간과 최종 위치만 확인한다.
+bool runPipeline(const std::vector<Mission>& missions, const Options& opt, LatencyHist& total,
+                 double& virtMs) {
+  static constexpr uint64_t kTimeoutUs = 300ull * 1000 * 1000;
+  const uint64_t t0 = sim::nowUs();
+  const unsigned failed0 = bridge::jobsFailed();
+  std::shared_ptr<sim::Connection> conn;
+  size_t sent = 0;
+  uint64_t lastProgress = t0;
+  int lastX = -1, lastY = -1;
+
+  while (sim::nowUs() - lastProgress < kTimeoutUs) {
+    if ((!conn || conn->closed) && sent < missions.size() && !bridge::jobQueueFull()) {
+      const Mission& m = missions[sent++];
+      if (m.legFails) continue; // 실패를 기대하는 미션은 하나씩 실행할 때만 (실패 작업 수 확인과 맞지 않는다)
+      conn = sim::openConnection(request(m.cmd), sim::nowUs(), opt.clientBpms);
+      if (m.expectX >= 0) { lastX = m.expectX; lastY = m.expectY; }
+      if (!m.during.empty()) {
+        sim::openConnection(request(m.during), sim::nowUs() + (uint64_t)m.duringAtMs * 1000, opt.clientBpms);
+      }
+      lastProgress = sim::nowUs();
+    }
+    const uint64_t before = sim::nowUs();
+    loop();
+    sim::advanceUs(opt.loopUs);
+    total.add(sim::nowUs() - before);
+    if (sent == missions.size() && conn->closed && bridge::robotIdle()) break;
+  }
+  virtMs = (sim::nowUs() - t0) / 1000.0;
+
+  int x = 0, y = 0;
+  bridge::position(x, y);
+  return bridge::robotIdle() && bridge::jobsFailed() == failed0 &&
+         (lastX < 0 || (x == lastX && y == lastY));
+}
+
+// ---- UDP 원격 조종 클라이언트 (루프백) ----
+// 패킷 도착 → 모터 PWM 변화까지를 가상 시계로 잰다. 응답(ack)은 sim::udpSent() 로 받는다.
+static constexpr uint16_t kTeleopPort = 4210;
+static constexpr uint32_t kHeartbeatMs = 100;
+
+struct TeleopClient {
+  uint16_t seq = 0;
+  size_t   ackPos = 0;
+  bool     heartbeats = false;
+  uint64_t lastSentUs = 0;
+  LatencyHist ackLat;    // 패킷 도착 → 응답
+  LatencyHist motorLat;  // 패킷 도착 → 모터 시동/정지
+
+  std::string packet(UdpTeleop::Op op, uint16_t s, uint16_t arg) {
+    uint8_t buf[UdpTeleop::PACKET_SIZE];
+    UdpTeleop::encode((uint8_t)op, s, arg, buf);
+    return std::string((const char*)buf, sizeof(buf));
+  }
+
+  uint16_t send(UdpTeleop::Op op, uint16_t arg, const Options& opt) {
+    seq++;
+    sendRaw(packet(op, seq, arg), opt);
+    return seq;
+  }
+
+  // 도착 시각을 loop 주기 안에서 흩뜨린다 (loop 시작과 딱 맞으면 지연이 0 으로 보인다).
+  // 보낸 순서대로 도착한다.
+  void sendRaw(const std::string& bytes, const Options& opt) {
+    const uint64_t at = sim::nowUs() + 1 + (seq * 37u) % (opt.loopUs ? opt.loopUs : 1);
+    lastSentUs = at > lastSentUs ? at : lastSentUs + 1;
+    sim::sendUdp(kTeleopPort, bytes, lastSentUs);
+  }
+
+  // loop() 한 번 + 필요하면 heartbeat
+  void tick(const Options& opt) {
+    if (heartbeats && sim::nowUs() - lastSentUs >= kHeartbeatMs * 1000) send(UdpTeleop::Op::Heartbeat, 0, opt);
+    loop();
+    sim::advanceUs(opt.loopUs);
+  }
+
+  // seq 에 대한 응답을 기다린다. 응답 코드, 시간 안에 없으면 -1.
+  int waitAck(uint16_t s, uint64_t sentUs, const Options& opt) {
+    const uint64_t deadline = sim::nowUs() + 1000 * 1000;
+    while (sim::nowUs() < deadline) {
+      auto& out = sim::udpSent();
+      for (; ackPos < out.size(); ++ackPos) {
+        UdpTeleop::Command c;
+        if (out[ackPos].data.size() != UdpTeleop::PACKET_SIZE ||
+            !UdpTeleop::decode((const uint8_t*)out[ackPos].data.data(), c)) continue;
+        if (c.seq != s || !((uint8_t)c.op & UdpTeleop::ACK_FLAG)) continue;
+        ackLat.add(out[ackPos].atUs - sentUs);
+        ackPos++;
+        return c.arg;
+      }
+      tick(opt);
+    }
+    return -1;
+  }
+
+  void waitIdle(const Options& opt) {
+    for (int i = 0; i < 10 * 1000 * 1000 && !bridge::robotIdle(); ++i) tick(opt);
+  }
+
+  void tickFor(uint32_t ms, const Options& opt) {
+    const uint64_t t0 = sim::nowUs();
+    while (sim::nowUs() - t0 < (uint64_t)ms * 1000) tick(opt);
+  }
+
+  // 모터 명령을 보내고 응답과 모터 시동까지의 지연을 잰다.
+  // 가감속 구동이면 첫 PWM 은 0 이라 시동(0 아닌 듀티)이 응답보다 몇 ms 늦을 수 있다.
+  int drive(UdpTeleop::Op op, uint16_t arg, const Options& opt) {
+    const uint32_t starts0 = sim::motorStarts();
+    const uint16_t s = send(op, arg, opt);
+    const uint64_t t = lastSentUs;
+    const int ack = waitAck(s, t, opt);
+    if (ack != (int)UdpTeleop::Ack::Ok) return ack;
+    for (int i = 0; i < 100 && sim::motorStarts() == starts0; ++i) tick(opt);
+    if (sim::motorStarts() > starts0) motorLat.add(sim::lastMotorStartUs() - t);
+    return ack;
+  }
+};
+
+// 스크립트: (0,4) RIGHT 에서 한 칸씩 조종, 잘못된 패킷 주입, heartbeat 끊김, Stop.
+bool runTeleopDemo(const Options& opt) {
+  using Op = UdpTeleop::Op;
+  const int OK = (int)UdpTeleop::Ack::Ok, REFUSED = (int)UdpTeleop::Ack::Refused;
+  TeleopClient c;
+  bool ok = true;
+  auto expect = [&](bool cond, const char* what) {
+    if (!cond) { printf("FAIL: %s\n", what); ok = false; }
+    else if (!opt.quiet) printf("ok  : %s\n", what);
+  };
+  auto at = [](int ex, int ey) { int x, y; bridge::position(x, y); return x == ex && y == ey; };
+  // 멈춘 뒤 ms 동안 모터가 다시 켜지지 않고 실제 자세도 그대로인지 (바퀴가 멈출 시간은 먼저 준다)
+  auto staysStopped = [&](uint32_t ms) {
+    c.tickFor(100, opt);
+    const uint32_t starts = sim::motorStarts();
+    const sim::Pose p0 = sim::pose();
+    c.tickFor(ms, opt);
+    const sim::Pose p1 = sim::pose();
+    return sim::motorStarts() == starts && std::hypot(p1.x - p0.x, p1.y - p0.y) < 0.001 &&
+           std::fabs(p1.theta - p0.theta) < 0.001;
+  };
+
+  c.heartbeats = true;
+  expect(c.drive(Op::Step, 0, opt) == OK, "step forward accepted");
+  c.waitIdle(opt);
+  expect(at(1, 4), "at (1,4)");
+  expect(c.drive(Op::Rotate, 0, opt) == OK, "rotate CW accepted");
+  c.waitIdle(opt);
+  expect(c.drive(Op::Step, 0, opt) == OK, "step forward (down) accepted");
+  const std::string last = c.packet(Op::Step, c.seq, 0);
+  const std::string old  = c.packet(Op::Rotate, (uint16_t)(c.seq - 2), 0);
+  std::string bad = c.packet(Op::Step, (uint16_t)(c.seq + 1), 0);
+  bad[7] ^= 0x55;
+  c.sendRaw(last, opt); // 중복
+  c.sendRaw(old, opt);  // 지난 패킷
+  c.sendRaw(bad, opt);  // 체크섬 오류
+  c.waitIdle(opt);
+  expect(at(1, 3), "at (1,3), dropped packets ignored");
+
+  expect(c.drive(Op::Step, 1, opt) == OK, "step backward accepted");
+  c.waitIdle(opt);
+  expect(c.drive(Op::Rotate, 1, opt) == OK, "rotate CCW accepted");
+  c.waitIdle(opt);
+  expect(c.drive(Op::Step, 0, opt) == OK, "step forward accepted");
+  c.waitIdle(opt);
+  expect(at(2, 4), "at (2,4)");
+  const uint16_t liftSeq = c.send(Op::LiftUp, 500, opt);
+  expect(c.waitAck(liftSeq, c.lastSentUs, opt) == OK, "lift up accepted");
+  c.waitIdle(opt);
+  expect(c.drive(Op::Step, 0, opt) == REFUSED, "step into blocked (3,4) refused");
+
+  // heartbeat 끊김: 주행 중에 조종기가 사라지면 HEARTBEAT_TIMEOUT_MS 뒤 정지
+  expect(c.drive(Op::Rotate, 0, opt) == OK, "rotate CW accepted");
+  c.waitIdle(opt);
+  expect(c.drive(Op::Step, 0, opt) == OK, "step forward accepted");
+  c.heartbeats = false;
+  const uint64_t lostUs = c.lastSentUs;
+  while (sim::nowUs() - lostUs < 2000 * 1000 && sim::lastMotorStopUs() < lostUs) c.tick(opt);
+  const double stopAfterMs = (sim::lastMotorStopUs() - lostUs) / 1000.0;
+  expect(sim::lastMotorStopUs() > lostUs && stopAfterMs < UdpTeleop::HEARTBEAT_TIMEOUT_MS + 5,
+         "heartbeat loss stops motors");
+  expect(staysStopped(500), "motors stay off and pose holds after heartbeat loss");
+  c.waitIdle(opt);
+  expect(at(2, 4), "aborted step leaves position at (2,4)");
+
+  // 새 세션 (seq 처음부터) 에서 주행 중 Stop
+  c.seq = 0;
+  c.heartbeats = true;
+  expect(c.drive(Op::Step, 0, opt) == OK, "new session step accepted");
+  const uint64_t driveUs = sim::nowUs();
+  while (sim::nowUs() - driveUs < 1000 * 1000) c.tick(opt);
+  const uint16_t s = c.send(Op::Stop, 0, opt);
+  const uint64_t stopSent = c.lastSentUs;
+  expect(c.waitAck(s, stopSent, opt) == OK && sim::lastMotorStopUs() >= stopSent, "stop accepted");
+  c.motorLat.add(sim::lastMotorStopUs() - stopSent);
+  c.heartbeats = false;
+  expect(staysStopped(UdpTeleop::HEARTBEAT_TIMEOUT_MS + 100), // 멈춘 뒤 조종기가 사라진 세션도 끝난다
+         "motors stay off and pose holds after stop");
+  c.waitIdle(opt);
+  expect(at(2, 4), "stopped step leaves position at (2,4)");
+
+  unsigned dup, stale, malformed, timeouts;
+  bridge::teleopStats(dup, stale, malformed, timeouts);
+  expect(dup == 1 && stale == 1 && malformed == 1, "duplicate/stale/malformed dropped once each");
+  expect(timeouts == 2, "two sessions timed out");
+
+  printf("\nteleop         : %s\n", ok ? "ok" : "FAIL");
+  printf("dropped        : duplicate %u, stale %u, malformed %u; timeouts %u\n", dup, stale, malformed, timeouts);
+  printf("packet -> ack  : p50 %llu us, max %llu us (%llu)\n",
+         (unsigned long long)c.ackLat.percentile(0.50), (unsigned long long)c.ackLat.max(),
+         (unsigned long long)c.ackLat.count());
+  printf("packet -> motor: p50 %llu us, max %llu us (%llu)\n",
+         (unsigned long long)c.motorLat.percentile(0.50), (unsigned long long)c.motorLat.max(),
+         (unsigned long long)c.motorLat.count());
+  printf("heartbeat loss : motors stopped %.1f ms after last packet\n", stopAfterMs);
+  return ok;
+}
+
+// ---- 구동 벤치 ----
+// 가감속 프로파일별로 한 칸/여러 칸 직진, 90도 회전 시간과 자세 오차를 잰다.
+// 접지력이 유한해야 계단 구동의 헛돎/미끄러짐이 드러나므로 --traction 이 없으면 1.5 칸/s^2.
+// odo 행은 엔코더 틱으로 동작을 끝내고 방향을 잡는다 (--wheel-gain 으로 좌우 차이를 주고 비교).
+struct DriveProfileRow { const char* name; unsigned accel, decel, pct; bool odo; };
+
+// 동작 하나를 넣고 끝날 때까지 loop() 를 돌린다. 걸린 시간 [ms], 실패하면 음수.
+double benchStep(bool queued, const Options& opt) {
+  if (!queued) return -1.0;
+  const uint64_t t0 = sim::nowUs();
+  while (!bridge::moverIdle()) {
+    loop();
+    sim::advanceUs(opt.loopUs);
+    if (sim::nowUs() - t0 > 60ull * 1000 * 1000) return -1.0;
+  }
+  return (sim::nowUs() - t0) / 1000.0;
+}
+
+void printBenchHeader() {
+  printf("%-10s %5s %5s %4s %8s %9s %8s %11s %10s %12s\n", "profile", "accel", "decel", "pct",
+         "cell_ms", "4cell_ms", "rot90_ms", "square_err", "head_deg", "straight_err");
+}
+
+// 한 행: 정사각형 주행(한 칸 + 90도 × 4)과 네 칸 왕복 뒤의 자세 오차
+bool benchRow(const DriveProfileRow& r, const Options& opt) {
+  bridge::setOdometryEnabled(r.odo);
+  bridge::setDriveProfile(r.accel, r.decel, r.pct);
+  sim::setPose({0.0, 0.0, 0.0});
+  benchStep(bridge::benchRotateTo(1, 0), opt);
+  sim::setPose({0.0, 0.0, 0.0});
+
+  // 한 칸씩 정사각형을 돌아 제자리로: 칸 4번, 90도 회전 4번
+  static const int DX[4] = {1, 0, -1, 0}, DY[4] = {0, 1, 0, -1};
+  double cellMs = 0, rotMs = 0;
+  for (int k = 0; k < 4; ++k) {
+    cellMs += benchStep(bridge::benchDrive(DX[k], DY[k], 1, false), opt);
+    rotMs += benchStep(bridge::benchRotateTo(DX[(k + 1) & 3], DY[(k + 1) & 3]), opt);
+  }
+  const sim::Pose sq = sim::pose();
+  const double squareErr = std::hypot(sq.x, sq.y);
+  const double headDeg = std::remainder(sq.theta, 2 * 3.141592653589793) * 180.0 / 3.141592653589793;
+
+  // 네 칸 전진 후 네 칸 후진으로 돌아오기
+  sim::setPose({0.0, 0.0, 0.0});
+  const double fourMs = benchStep(bridge::benchDrive(1, 0, 4, false), opt);
+  benchStep(bridge::benchDrive(-1, 0, 4, true), opt);
+  const sim::Pose st = sim::pose();
+  const double straightErr = std::hypot(st.x, st.y);
+
+  printf("%-10s %5u %5u %4u %8.0f %9.0f %8.0f %11.3f %10.2f %12.3f\n", r.name, r.accel, r.decel, r.pct,
+         cellMs / 4, fourMs, rotMs / 4, squareErr, headDeg, straightErr);
+  return cellMs >= 0 && rotMs >= 0 && fourMs >= 0;
+}
+
+// 네 칸 직진 도중 abort: 멈춘 뒤 모터가 다시 켜지지 않고 자세가 그대로인지 (엔코더 종료 포함)
+bool benchAbortRow(bool odo, const Options& opt) {
+  bridge::setOdometryEnabled(odo);
+  sim::setPose({0.0, 0.0, 0.0});
+  const bool queued = bridge::benchDrive(1, 0, 4, false);
+  const uint64_t t0 = sim::nowUs();
+  auto run = [&opt](uint64_t us) {
+    const uint64_t s = sim::nowUs();
+    while (sim::nowUs() - s < us) { loop(); sim::advanceUs(opt.loopUs); }
+  };
+  run(1500 * 1000);
+  bridge::benchAbort();
+  const double stopAt = sim::pose().x;
+  run(300 * 1000); // 바퀴가 멈출 때까지
+  const sim::Pose settled = sim::pose();
+  const uint32_t starts = sim::motorStarts();
+  run(3000 * 1000);
+  const sim::Pose later = sim::pose();
+  const bool ok = queued && bridge::moverIdle() && sim::motorStarts() == starts &&
+                  std::hypot(later.x - settled.x, later.y - settled.y) < 0.001;
+  printf("abort%-5s  : stopped at %.2f cells after %.0f ms, %.3f cells in the next 3 s (%s)\n",
+         odo ? "+odo" : "", stopAt, (sim::nowUs() - t0) / 1000.0 - 3300,
+         std::hypot(later.x - settled.x, later.y - settled.y), ok ? "ok" : "FAIL");
+  return ok;
+}
+
+bool runDriveBench(const Options& opt) {
+  if (opt.traction < 0) sim::config().tractionCellsPerS2 = 1.5;
+  unsigned a0, d0, p0;
+  bridge::driveProfile(a0, d0, p0);
+  const bool encoders = sim::config().encoderTicksPerCell > 0;
+  const DriveProfileRow rows[] = {
+    {"step 100%", 0, 0, 100, false},
+    {"ramp 100%", 500, 500, 100, false},
+    {"step 140%", 0, 0, 140, false},
+    {"ramp 140%", 500, 500, 140, false},
+    {"ramp 180%", 500, 500, 180, false},
+    {"sketch", a0, d0, p0, false},
+    {"step+odo", 0, 0, 100, true},
+    {"sketch+odo", a0, d0, p0, true},
+  };
+
+  printf("traction %.2f cells/s^2, wheel gain %.3f/%.3f, loop %u us\n", sim::config().tractionCellsPerS2,
+         sim::config().leftWheelGain, sim::config().rightWheelGain, opt.loopUs);
+  printBenchHeader();
+  bool ok = true;
+  for (const DriveProfileRow& r : rows) {
+    if (r.odo && !encoders) continue;
+    ok = benchRow(r, opt) && ok;
+  }
+  bridge::setDriveProfile(a0, d0, p0);
+  ok = benchAbortRow(false, opt) && ok;
+  if (encoders) ok = benchAbortRow(true, opt) && ok;
+  bridge::setOdometryEnabled(encoders);
+  printf("odometry timeouts: %u\n", bridge::odometryTimeouts());
+  return ok;
+}
+
+// ---- 여러 대 시공간 계획 벤치 ----
+// 로봇 N 대가 한 시간 동안 (집기 칸으로 가서 집기 → 내려놓는 칸으로 가서 내려놓기) 를 되풀이한다.
+// 우선순위 계획: 출발할 차례가 된 로봇이 공용 예약표를 피해 planSpaceTime 으로 계획하고
+// reservePlan 으로 올린다. 도착 칸은 다음 계획까지 잡아 두고, 경로가 없으면 잠시 뒤 다시 한다.
+// 여러 번 연달아 실패하면 (내려놓는 칸 앞에 줄 선 로봇들이 서로 출구를 막는 경우 등)
+// 아무 빈 칸으로 비켜 준 뒤 다시 목표를 고른다.
+// 로봇은 계획한 시각대로 움직인다고 본다 (주행 모델 없음). 실제로 쓴 (칸, 시간) 을 따로 모아
+// 서로 겹치지 않는지 확인하고, 한 대일 때는 planTimed 와 도착 시간이 같은지 확인한다.
+// 동작 시간은 스케치의 gridMove/PathRunner 설정 그대로 (bridge::plannerCosts).
+constexpr uint32_t kFleetHourMs   = 3600u * 1000u;
+constexpr uint32_t kFleetPickMs   = 10500; // 기본 시나리오의 상자 집기 사이클 평균
+constexpr uint32_t kFleetDropMs   = 2000;  // lift_down (LIFT_JOB_MS)
+constexpr uint32_t kFleetRetryMs  = 1000;  // 경로가 없을 때 다시 해 보는 간격
+constexpr unsigned kFleetEvadeAfter = 3;   // 이만큼 연달아 실패하면 아무 빈 칸으로 비켜 준다
+constexpr uint32_t kFleetMarginMs = 500;   // 시간창 앞뒤 여유 (HOLD_MARGIN_MS)
+constexpr uint16_t kFleetStates   = 4096;
+
+// 실제로 쓴 (칸, 시간) 모음. reservePlan 이 예약표 대신 여기에 쓴다.
+struct FleetTimeline {
+  std::vector<Reservation> v;
+  bool reserve(uint8_t agent, uint16_t cell, uint32_t t0, uint32_t t1) {
+    if (t1 > t0) v.push_back(Reservation{t0, t1, cell, agent});
+    return true;
+  }
+  // 다른 로봇끼리 같은 칸 시간이 겹친 횟수
+  unsigned conflicts() {
+    std::sort(v.begin(), v.end(), [](const Reservation& a, const Reservation& b) {
+      return a.cell != b.cell ? a.cell < b.cell : a.t0 < b.t0;
+    });
+    unsigned n = 0;
+    for (size_t i = 0; i < v.size(); ++i) {
+      for (size_t j = i + 1; j < v.size() && v[j].cell == v[i].cell && v[j].t0 < v[i].t1; ++j) {
+        if (v[j].agent != v[i].agent) n++;
+      }
+    }
+    return n;
+  }
+};
+
+struct FleetRow {
+  unsigned plans = 0, retries = 0, evades = 0, waited = 0, picks = 0, conflicts = 0, mismatch = 0, tableFull = 0;
+  unsigned peakStates = 0, maxRetryRun = 0;
+  uint64_t expanded = 0;
+  double waitS = 0;
+  std::vector<double> planUs;
+};
+
+// rows: 위 줄이 y 최대. '#' 막힘, 'D' 내려놓는 칸, 'S' 출발 칸, 막힌 칸 옆의 빈 칸이 집기 칸.
+template <int W, int H>
+FleetRow runFleet(const char* const (&rows)[H], int robots, const MoveCosts& costs, uint32_t seed) {
+  using Cell = std::pair<int, int>;
+  OccupancyGrid<W, H> grid;
+  std::vector<Cell> picks, drops, starts, open;
+  auto at = [&rows](int x, int y) { return rows[H - 1 - y][x]; };
+  for (int y = 0; y < H; ++y)
+    for (int x = 0; x < W; ++x) grid.set(x, y, at(x, y) == '#');
+  for (int y = 0; y < H; ++y) {
+    for (int x = 0; x < W; ++x) {
+      const char c = at(x, y);
+      if (c == 'D') drops.push_back({x, y});
+      if (c == 'S') starts.push_back({x, y});
+      if (c != '#') open.push_back({x, y});
+      if (c != '.') continue;
+      bool shelf = false;
+      for (int k = 0; k < 4; ++k) {
+        const int nx = x + astar_timed_detail::HDX[k], ny = y + astar_timed_detail::HDY[k];
+        shelf = shelf || (grid.inBounds(nx, ny) && grid.blocked(nx, ny));
+      }
+      if (shelf) picks.push_back({x, y});
+    }
+  }
+
+  struct Bot { Cell at; uint8_t heading; uint32_t readyAt; bool loaded; Cell goal; unsigned retryRun; bool evading; };
+  std::vector<Bot> bots;
+  static ReservationTable<1024> table;
+  static SpaceTimeWorkspace<W, H, kFleetStates> ws;
+  table.clear();
+  FleetTimeline used;
+  for (int i = 0; i < robots && i < (int)starts.size(); ++i) {
+    bots.push_back(Bot{starts[i], 3, 0, false, {-1, -1}, 0, false});
+    table.reserve((uint8_t)i, (uint16_t)(starts[i].second * W + starts[i].first), 0, ST_FOREVER);
+  }
+
+  std::mt19937 rng(seed);
+  auto taken = [&bots](const Cell& c, size_t self) {
+    for (size_t k = 0; k < bots.size(); ++k) {
+      if (k != self && (bots[k].at == c || bots[k].goal == c)) return true;
+    }
+    return false;
+  };
+  auto choose = [&](const std::vector<Cell>& from, size_t self) {
+    std::vector<Cell> free;
+    for (const Cell& c : from) {
+      if (!taken(c, self) && c != bots[self].at) free.push_back(c);
+    }
+    const std::vector<Cell>& pool = free.empty() ? from : free;
+    return pool[rng() % pool.size()];
+  };
+
+  // 비켜 줄 칸: 다른 로봇이 있거나 가려는 칸, 내려놓는 칸을 빼고 가장 가까운 칸
+  auto nearest = [&](const std::vector<Cell>& from, size_t self) {
+    Cell best = from[0];
+    int bestD = 1 << 30;
+    for (const Cell& c : from) {
+      const int d = abs(c.first - bots[self].at.first) + abs(c.second - bots[self].at.second);
+      if (d == 0 || d >= bestD || taken(c, self)) continue;
+      if (std::find(drops.begin(), drops.end(), c) != drops.end()) continue;
+      best = c;
+      bestD = d;
+    }
+    return best;
+  };
+
+  FleetRow row;
+  PathRunner::Node nodes[PathRunner::MAX_POINTS];
+  while (true) {
+    size_t b = 0;
+    for (size_t k = 1; k < bots.size(); ++k) {
+      if (bots[k].readyAt < bots[b].readyAt) b = k;
+    }
+    Bot& bot = bots[b];
+    const uint32_t now = bot.readyAt;
+    if (now >= kFleetHourMs) break;
+    table.expire(now);
+    if (bot.goal.first < 0) {
+      bot.evading = bot.retryRun >= kFleetEvadeAfter;
+      bot.goal = bot.evading ? nearest(open, b) : choose(bot.loaded ? drops : picks, b);
+    }
+
+    const auto t0 = std::chrono::steady_clock::now();
+    const SpaceTimeResult st = planSpaceTime(grid, table, (uint8_t)b, bot.at.first, bot.at.second, bot.heading,
+                                             now, bot.goal.first, bot.goal.second, ST_FOREVER, costs,
+                                             nodes, PathRunner::MAX_POINTS, ws);
+    row.planUs.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count());
+    row.plans++;
+    row.expanded += st.expanded;
+    if (st.states > row.peakStates) row.peakStates = st.states;
+    const uint16_t here = (uint16_t)(bot.at.second * W + bot.at.first);
+
+    if (!st.ok) {
+      // 제자리에서 기다렸다가 다른 목표로 다시
+      row.retries++;
+      bot.retryRun++;
+      if (bot.retryRun > row.maxRetryRun) row.maxRetryRun = bot.retryRun;
+      used.reserve((uint8_t)b, here, now, now + kFleetRetryMs);
+      bot.readyAt = now + kFleetRetryMs;
+      bot.goal = {-1, -1};
+      continue;
+    }
+    if (robots == 1) {
+      PathRunner::Node alone[PathRunner::MAX_POINTS];
+      const TimedResult t = planTimed(grid, bot.at.first, bot.at.second, bot.heading, bot.goal.first,
+                                      bot.goal.second, costs, alone, PathRunner::MAX_POINTS);
+      if (!t.ok || t.costMs != st.arriveMs - now) row.mismatch++;
+    }
+
+    table.release((uint8_t)b);
+    if (!reservePlan<W>(table, (uint8_t)b, nodes, st.n, bot.heading, now, costs, ST_FOREVER, kFleetMarginMs)) {
+      row.tableFull++;
+    }
+    const uint32_t taskMs = bot.evading ? 0 : bot.loaded ? kFleetDropMs : kFleetPickMs;
+    reservePlan<W>(used, (uint8_t)b, nodes, st.n, bot.heading, now, costs, st.arriveMs + taskMs, 0);
+    uint32_t wait = 0;
+    for (uint16_t i = 1; i < st.n; ++i) wait += nodes[i].waitMs;
+    if (wait > 0) row.waited++;
+    row.waitS += wait / 1000.0;
+
+    bot.at = bot.goal;
+    bot.goal = {-1, -1};
+    bot.heading = st.endHeading;
+    bot.readyAt = st.arriveMs + taskMs;
+    bot.retryRun = 0;
+    if (bot.evading) {
+      row.evades++;
+      continue;
+    }
+    if (bot.loaded && bot.readyAt <= kFleetHourMs) row.picks++;
+    bot.loaded = !bot.loaded;
+  }
+  row.conflicts = used.conflicts();
+  return row;
+}
+
+void printFleetRow(const char* map, int robots, FleetRow& r) {
+  std::sort(r.planUs.begin(), r.planUs.end());
+  double sum = 0;
+  for (double us : r.planUs) sum += us;
+  const size_t n = r.planUs.size();
+  printf("%-9s %6d %6u %8.1f %7.1f %7.1f %8.0f %6u %6u %7.0f %7u %6u %9u %7u %9u\n", map, robots, r.plans,
+         n ? sum / n : 0.0, n ? r.planUs[(n * 99 + 99) / 100 - 1] : 0.0, n ? r.planUs[n - 1] : 0.0,
+         r.plans ? (double)r.expanded / r.plans : 0.0, r.peakStates, r.waited, r.waitS, r.retries,
+         r.evades, r.maxRetryRun, r.picks, r.conflicts);
+}
+
+bool runFleetBench(const Options& opt) {
+  MoveCosts costs{};
+  unsigned fwd, bwd, rot, dwell;
+  bridge::plannerCosts(fwd, bwd, rot, dwell, costs.allowReverse);
+  costs.forwardMs = fwd;
+  costs.backwardMs = bwd;
+  costs.rotateMs = rot;
+  costs.dwellMs = dwell;
+
+  // 스케치 grid 와 같은 5x5 배치 + 넓은 창고 (선반 2x1 묶음 여섯 개)
+  static const char* const kRobotMap[5] = {
+    "SSS#S",
+    "#..#.",
+    ".....",
+    ".##..",
+    "D....",
+  };
+  static const char* const kWarehouse[8] = {
+    "SSSSSSSS..",
+    "..........",
+    ".##.##.##.",
+    "..........",
+    "..........",
+    ".##.##.##.",
+    "..........",
+    "D........D",
+  };
+  for (int y = 0; y < 5; ++y) {
+    for (int x = 0; x < 5; ++x) {
+      if ((kRobotMap[4 - y][x] == '#') != bridge::cellBlocked(x, y)) {
+        fprintf(stderr, "fleet bench: 5x5 map differs from the sketch grid at (%d, %d)\n", x, y);
+        return false;
+      }
+    }
+  }
+
+  printf("cell %u ms (+%u ms dwell), back %u ms, 90deg %u ms, reverse %s; pick %u ms, drop %u ms, margin %u ms\n",
+         fwd, dwell, bwd, rot, costs.allowReverse ? "on" : "off", kFleetPickMs, kFleetDropMs, kFleetMarginMs);
+  printf("%-9s %6s %6s %8s %7s %7s %8s %6s %6s %7s %7s %6s %9s %7s %9s\n", "map", "robots", "plans", "plan_us",
+         "p99_us", "max_us", "expanded", "states", "waited", "wait_s", "retries", "evades", "max_retry", "picks/h",
+         "conflicts");
+  bool ok = true;
+  auto row = [&](const char* name, int robots, FleetRow r) {
+    printFleetRow(name, robots, r);
+    ok = ok && r.conflicts == 0 && r.mismatch == 0 && r.tableFull == 0 && r.picks > 0;
+    if (r.mismatch) printf("  %u plans differ from planTimed\n", r.mismatch);
+    if (r.tableFull) printf("  reservation table full %u times\n", r.tableFull);
+  };
+  for (int n : {1, 2, 3, 4}) row("5x5", n, runFleet<5, 5>(kRobotMap, n, costs, opt.seed));
+  for (int n : {1, 2, 4, 6, 8}) row("10x8", n, runFleet<10, 8>(kWarehouse, n, costs, opt.seed));
+  printf("fleet          : %s\n", ok ? "ok" : "FAIL");
+  return ok;
+}
+
+// ---- 칸 플래너 엔진 비교 ----
+// 스케치 지도와 시드 무작위 5x5 지도(장애물 30%) 에서 모든 (출발, 목표) 쌍을 A* 와 비트보드로 계획한다.
+// 비트보드는 스케치의 USE_CELL_PLANNER 처럼 OccupancyGrid 판 planPath5x5 로 부른다.
+// 두 경로 모두 validatePath5x5 와 끝점을 확인하고, 성공 여부와 길이(칸 수 최단)가 같아야 한다.
+// 이어서 스케치 지도의 모든 쌍을 되풀이해 계획 한 번의 시간을 잰다.
+constexpr int kCheckMaps = 200;
+constexpr int kTimingReps = 200;
+
+bool pathMatches(const bool grid[5][5], const PathRunner::Node* p, const AStarResult& r,
+                 int sx, int sy, int gx, int gy) {
+  return validatePath5x5(grid, p, r.n) && p[0].x == sx && p[0].y == sy &&
+         p[r.n - 1].x == gx && p[r.n - 1].y == gy;
+}
+
+// 한 지도의 모든 쌍. 어긋난 쌍 수를 돌려준다.
+unsigned checkEngines(const bool grid[5][5], unsigned& pairs, unsigned& paths) {
+  PathRunner::Node a[PathRunner::MAX_POINTS], b[PathRunner::MAX_POINTS];
+  OccupancyGrid<5, 5> occ;
+  for (int y = 0; y < 5; ++y)
+    for (int x = 0; x < 5; ++x) occ.set(x, y, grid[y][x]);
+  unsigned bad = 0;
+  for (int s = 0; s < 25; ++s) {
+    for (int g = 0; g < 25; ++g) {
+      const int sx = s % 5, sy = s / 5, gx = g % 5, gy = g / 5;
+      const AStarResult ra = planPath5x5(PlannerEngine::Astar, grid, sx, sy, gx, gy, a, PathRunner::MAX_POINTS);
+      const AStarResult rb = planPath5x5(PlannerEngine::Bitboard, occ, sx, sy, gx, gy, b, PathRunner::MAX_POINTS);
+      pairs++;
+      if (ra.ok != rb.ok || (ra.ok && ra.n != rb.n)) { bad++; continue; }
+      if (!ra.ok) continue;
+      paths++;
+      if (!pathMatches(grid, a, ra, sx, sy, gx, gy) || !pathMatches(grid, b, rb, sx, sy, gx, gy)) bad++;
+    }
+  }
+  return bad;
+}
+
+// 지도 변환은 빼고 (OccupancyGrid / 통로 비트보드는 지도가 바뀔 때만 만든다) 엔진만 잰다
+// (출발, 목표) 가 모두 통로인 쌍만 잰다.
+template <typename Plan>
+double nsPerPlan(const bool grid[5][5], Plan plan) {
+  PathRunner::Node out[PathRunner::MAX_POINTS];
+  unsigned calls = 0, found = 0;
+  const auto t0 = std::chrono::steady_clock::now();
+  for (int rep = 0; rep < kTimingReps; ++rep) {
+    for (int s = 0; s < 25; ++s) {
+      for (int g = 0; g < 25; ++g) {
+        if (grid[s / 5][s % 5] || grid[g / 5][g % 5]) continue;
+        found += plan(s % 5, s / 5, g % 5, g / 5, out).ok;
+        calls++;
+      }
+    }
+  }
+  const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+  return found ? ns / calls : 0.0;
+}
+
+bool runPlannerCheck(const Options& opt) {
+  bool sketch[5][5];
+  for (int y = 0; y < 5; ++y)
+    for (int x = 0; x < 5; ++x) sketch[y][x] = bridge::cellBlocked(x, y);
+
+  unsigned pairs = 0, paths = 0;
+  unsigned bad = checkEngines(sketch, pairs, paths);
+  std::mt19937 rng(opt.seed);
+  for (int m = 0; m < kCheckMaps; ++m) {
+    bool grid[5][5];
+    for (int y = 0; y < 5; ++y)
+      for (int x = 0; x < 5; ++x) grid[y][x] = rng() % 100 < 30;
+    bad += checkEngines(grid, pairs, paths);
+  }
+  printf("planner check  : %d maps, %u pairs, %u paths, %u mismatches (%s)\n", kCheckMaps + 1, pairs, paths,
+         bad, bad == 0 ? "ok" : "FAIL");
+
+  OccupancyGrid<5, 5> occ;
+  occ.load(sketch);
+  const uint64_t passable = bitboardFree(occ);
+  const double astarNs = nsPerPlan(sketch, [&occ](int sx, int sy, int gx, int gy, PathRunner::Node* out) {
+    return planAstar<5, 5>(occ, sx, sy, gx, gy, out, PathRunner::MAX_POINTS);
+  });
+  const double bitNs = nsPerPlan(sketch, [passable](int sx, int sy, int gx, int gy, PathRunner::Node* out) {
+    return planBitboard<5, 5>(passable, sx, sy, gx, gy, out, PathRunner::MAX_POINTS);
+  });
+  printf("astar          : %.0f ns/plan (sketch map, open pairs), workspace %zu B static\n", astarNs,
+         sizeof(AstarWorkspace<5, 5>));
+  printf("bitboard       : %.0f ns/plan (%.1fx faster), no workspace\n", bitNs, bitNs > 0 ? astarNs / bitNs : 0.0);
+  return bad == 0;
+}
+
+// ---- 구동 보정 ----
+// 바퀴 배율을 틀어 둔 채(기본 0.9/0.97) 시간 종료 주행 오차를 재고, calib 작업으로 보정한 뒤
+// EEPROM 기록을 확인하고 재부팅처럼 다시 불러와 같은 주행을 반복한다.
+void printMotionParams(const char* label, const bridge::MotionParams& p) {
+  printf("%-8s fwd %5u ms %4d/%-4d bwd %5u ms %4d/%-4d rot %5u ms %4d/%-4d ticks %u/%u\n", label,
+         p.fwdMs, p.fwdL, p.fwdR, p.bwdMs, p.bwdL, p.bwdR, p.rotMs, p.rotL, p.rotR, p.ticksPerCell, p.ticksPer90);
+}
+
+bool sameParams(const bridge::MotionParams& a, const bridge::MotionParams& b) {
+  return a.fwdMs == b.fwdMs && a.bwdMs == b.bwdMs && a.rotMs == b.rotMs && a.fwdL == b.fwdL &&
+         a.fwdR == b.fwdR && a.bwdL == b.bwdL && a.bwdR == b.bwdR && a.rotL == b.rotL && a.rotR == b.rotR &&
+         a.ticksPerCell == b.ticksPerCell && a.ticksPer90 == b.ticksPer90;
+}
+
+bool runCalibration(const Options& opt) {
+  sim::Config& c = sim::config();
+  if (c.leftWheelGain == 1.0 && c.rightWheelGain == 1.0) { c.leftWheelGain = 0.9; c.rightWheelGain = 0.97; }
+  unsigned a0, d0, p0;
+  bridge::driveProfile(a0, d0, p0);
+  const DriveProfileRow timed{"time", a0, d0, p0, false};
+  const DriveProfileRow odo{"odo", a0, d0, p0, true};
+
+  printf("wheel gain %.3f/%.3f, traction %.2f cells/s^2\n", c.leftWheelGain, c.rightWheelGain,
+         c.tractionCellsPerS2);
+  bridge::MotionParams before, after, stored, reloaded;
+  bridge::motionParams(before);
+  printMotionParams("default", before);
+  printf("\nbefore calibration\n");
+  printBenchHeader();
+  bool ok = benchRow(timed, opt);
+  ok = benchRow(odo, opt) && ok;
+  bridge::setOdometryEnabled(true);
+
+  sim::setPose({0.0, 4.0, 0.0});
+  benchStep(bridge::benchRotateTo(1, 0), opt);
+  sim::setPose({0.0, 4.0, 0.0});
+  const unsigned failed0 = bridge::jobsFailed();
+  LatencyHist hist;
+  const MissionResult r = runMission(Mission{"calib", -1, -1}, opt, hist);
+  const bool calibrated = r.ok && bridge::jobsFailed() == failed0;
+  const sim::Pose end = sim::pose();
+  printf("\ncalib job      : %s in %.1f s, ended %.3f cells / %.2f deg from start\n", calibrated ? "ok" : "FAIL",
+         r.virtMs / 1000.0, std::hypot(end.x, end.y - 4.0),
+         std::remainder(end.theta, 2 * 3.141592653589793) * 180.0 / 3.141592653589793);
+
+  bridge::motionParams(after);
+  const bool haveStored = bridge::storedMotionParams(stored);
+  const bool reloadedOk = bridge::reloadMotionParams();
+  bridge::motionParams(reloaded);
+  printMotionParams("fitted", after);
+  if (haveStored) printMotionParams("eeprom", stored);
+  printf("eeprom record  : %s, reload after reboot %s\n",
+         haveStored && sameParams(after, stored) ? "matches" : "MISMATCH",
+         reloadedOk && sameParams(after, reloaded) ? "ok" : "FAIL");
+
+  printf("\nafter calibration\n");
+  printBenchHeader();
+  ok = benchRow(timed, opt) && ok;
+  ok = benchRow(odo, opt) && ok;
+  bridge::setOdometryEnabled(true);
+  return ok && calibrated && haveStored && sameParams(after, stored) && reloadedOk && sameParams(after, reloaded);
+}
+
+// GET target 응답 본문 (헤더 제외). 응답이 없으면 "".
+std::string fetch(const char* target) {
+  auto conn = sim::openConnection(std::string("GET ") + target + " HTTP/1.1\r\nHost: scv\r\n\r\n", sim::nowUs());
+  for (int i = 0; i < 1000 && !conn->closed; ++i) {
+    loop();
+    sim::advanceUs(200);
+  }
+  const size_t end = conn->tx.find("\r\n\r\n");
+  if (!conn->closed || end == std::string::npos) return "";
+  return conn->tx.substr(end + 4);
+}
+
+// 작업별 마감/예산 초과 합, 구동/리프트 타이밍, /stats 응답 확인 (--stats 면 본문 출력)
+void printTimingSummary(const Options& opt) {
+  unsigned overruns = 0;
+  for (int k = 0; k < bridge::schedulerTaskCount(); ++k) {
+    bridge::TaskStats t;
+    if (bridge::schedulerTask(k, t)) overruns += t.overruns;
+  }
+  printf("scheduler      : %u ticks, %d tasks, %u overruns\n", bridge::schedulerTicks(),
+         bridge::schedulerTaskCount(), overruns);
+  bridge::TimingStats ts;
+  bridge::timingStats(ts);
+  printf("drive timing   : %u actions ended late, end lateness p99 %u ms, max %u ms\n", ts.lateActions,
+         ts.endLateP99Ms, ts.endLateMaxMs);
+  printf("lift timing    : step lateness p99 %u us, max %u us, %u echo timeouts\n", ts.stepLateP99Us,
+         ts.stepLateMaxUs, ts.echoTimeouts);
+  const std::string body = fetch("/stats");
+  const bool ok = body.size() > 2 && body.front() == '{' && body.compare(body.size() - 2, 2, "}}") == 0;
+  printf("stats endpoint : %zu bytes (%s)\n", body.size(), ok ? "ok" : "FAIL");
+  if (opt.stats) printf("%s\n", body.c_str());
+}
+
+// GET /log 를 받아 풀어 본다 (--log 면 기록을 한 줄씩 출력)
+void printTelemetrySummary(const Options& opt) {
+  const std::string body = fetch("/log");
+  const uint8_t* p = (const uint8_t*)body.data();
+  Telemetry::Header h;
+  const bool ok = Telemetry::unpackHeader(p, body.size(), h) &&
+                  body.size() == Telemetry::HEADER_BYTES + (size_t)h.count * Telemetry::RECORD_BYTES;
+  if (!ok) {
+    printf("telemetry      : /log %zu bytes (FAIL)\n", body.size());
+    return;
+  }
+  unsigned faults = 0;
+  char line[160];
+  for (unsigned i = 0; i < h.count; ++i) {
+    Telemetry::Record r;
+    Telemetry::unpack(p + Telemetry::HEADER_BYTES + i * Telemetry::RECORD_BYTES, r);
+    if (r.event == Telemetry::Event::NoDetour || r.event == Telemetry::Event::PathNotFound ||
+        r.event == Telemetry::Event::OdometryTimeout || r.event == Telemetry::Event::TaskOverrun) faults++;
+    if (opt.log) {
+      Telemetry::format(r, line, sizeof(line));
+      printf("%6u %s\n", h.firstSeq + i, line);
+    }
+  }
+  printf("telemetry      : /log %zu bytes, %u records from seq %u, %u faults in window (ok)\n", body.size(),
+         h.count, h.firstSeq, faults);
+}
+
+bool parseArgs(int argc, char** argv, Options& opt) {
+  for (int i = 1; i < argc; ++i) {
+    const char* a = argv[i];
+    auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+    if      (!strcmp(a, "--missions")) { const char* v = next(); if (!v) return false; opt.missions = atoi(v); }
+    else if (!strcmp(a, "--seed"))     { const char* v = next(); if (!v) return false; opt.seed = (uint32_t)strtoul(v, nullptr, 10); }
+    else if (!strcmp(a, "--loop-us"))  { const char* v = next(); if (!v) return false; opt.loopUs = (uint32_t)strtoul(v, nullptr, 10); }
+    else if (!strcmp(a, "--gap-ms"))   { const char* v = next(); if (!v) return false; opt.gapMs = (uint32_t)strtoul(v, nullptr, 10); }
+    else if (!strcmp(a, "--client-bpms")) { const char* v = next(); if (!v) return false; opt.clientBpms = (uint32_t)strtoul(v, nullptr, 10); }
+    else if (!strcmp(a, "--pipeline")) { opt.pipeline = true; }
+    else if (!strcmp(a, "--stream"))   { opt.stream = true; }
+    else if (!strcmp(a, "--teleop"))   { opt.teleop = true; }
+    else if (!strcmp(a, "--box-pipelined")) { opt.boxPipelined = true; }
+    else if (!strcmp(a, "--drive-bench")) { opt.driveBench = true; }
+    else if (!strcmp(a, "--fleet-bench")) { opt.fleetBench = true; }
+    else if (!strcmp(a, "--planner-check")) { opt.plannerCheck = true; }
+    else if (!strcmp(a, "--traction")) { const char* v = next(); if (!v) return false; opt.traction = atof(v); }
+    else if (!strcmp(a, "--wheel-gain")) {
+      const char* v = next();
+      if (!v || sscanf(v, "%lf,%lf", &sim::config().leftWheelGain, &sim::config().rightWheelGain) != 2) return false;
+    }
+    else if (!strcmp(a, "--no-encoders")) { opt.noEncoders = true; }
+    else if (!strcmp(a, "--calibrate")) { opt.calibrate = true; }
+    else if (!strcmp(a, "--stats"))    { opt.stats = true; }
+    else if (!strcmp(a, "--log"))      { opt.log = true; }
+    else if (!strcmp(a, "--no-echo"))  { sim::config().noEcho = true; }
+    else if (!strcmp(a, "--quiet"))    { opt.quiet = true; }
+    else if (!strcmp(a, "-v"))         { sim::config().echoSerial = true; }
+    else return false;
+  }
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  Options opt;
+  if (!parseArgs(argc, argv, opt)) {
+    fprintf(stderr, "usage: scvsim [--missions N] [--seed S] [--loop-us U] [--gap-ms G] [--pipeline]\n"
+                    "              [--stream] [--teleop] [--box-pipelined] [--drive-bench] [--fleet-bench] [--traction A]\n"
+                    "              [--wheel-gain L,R] [--no-encoders] [--calibrate] [--planner-check] [--stats] [--log]\n"
+                    "              [--client-bpms B] [--no-echo] [--quiet] [-v]\n");
+    return 2;
+  }
+
+  // 스케치 초기 상태: (0,4), RIGHT 방향
+  if (opt.noEncoders) sim::config().encoderTicksPerCell = 0;
+  sim::setPose({0.0, 4.0, 0.0});
+  setup();
+  // 스케치는 틱 수 없이 부팅한다: 작업자가 calticks_ 로 넣는 것처럼 모델 차체의 값을 저장해 켠다
+  if (!opt.noEncoders)
+    bridge::installOdometry((unsigned)std::lround(sim::config().encoderTicksPerCell), kSimTicksPer90);
+  if (sim::config().echoSerial) bridge::setTelemetryMirror(true);
+  if (opt.boxPipelined) bridge::setBoxPipelined(true);
+  if (opt.traction >= 0) sim::config().tractionCellsPerS2 = opt.traction;
+
+  if (opt.teleop) return runTeleopDemo(opt) ? 0 : 1;
+  if (opt.driveBench) return runDriveBench(opt) ? 0 : 1;
+  if (opt.fleetBench) return runFleetBench(opt) ? 0 : 1;
+  if (opt.plannerCheck) return runPlannerCheck(opt) ? 0 : 1;
+  if (opt.calibrate) return runCalibration(opt) ? 0 : 1;
+
+  if (opt.stream && opt.pipeline) {
+    fprintf(stderr, "--stream and --pipeline cannot be combined\n");
+    return 2;
+  }
+  if (opt.stream && !g_stream.open()) {
+    fprintf(stderr, "websocket handshake failed\n");
+    return 1;
+  }
+  if (opt.stream) {
+    // 따옴표/역슬래시/제어 문자가 든 (모르는) 명령: 응답 프레임의 cmd 는 JSON 이스케이프되어야 한다
+    const uint64_t replies0 = g_stream.replies;
+    g_stream.send("x\"\\\x01", sim::nowUs());
+    for (int i = 0; i < 1000 && g_stream.replies == replies0; ++i) {
+      loop();
+      sim::advanceUs(opt.loopUs);
+      g_stream.pump();
+    }
+    const char* expected = "{\"cmd\":\"x\\\"\\\\\\u0001\",\"r\":\"\"}";
+    if (g_stream.lastReply != expected) {
+      fprintf(stderr, "stream reply not escaped: %s\n", g_stream.lastReply.c_str());
+      return 1;
+    }
+  }
+
+  const std::vector<Mission> missions =
+      opt.missions > 0 ? randomScenario(opt.missions, opt.seed) : defaultScenario();
+
+  LatencyHist total;
+  int failed = 0;
+  double virtTotalMs = 0;
+  uint32_t rotTotal = 0;
+  uint32_t startTotal = 0;
+
+  const auto wall0 = std::chrono::steady_clock::now();
+  if (opt.pipeline) {
+    double virtMs = 0;
+    const bool ok = runPipeline(missions, opt, total, virtMs);
+    const double wallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall0).count();
+    printf("missions       : %zu pipelined (%s, jobs failed %u)\n",
+           missions.size(), ok ? "ok" : "FAIL", bridge::jobsFailed());
+    printf("virtual time   : %.1f s (avg %.1f ms/mission)\n",
+           virtMs / 1000.0, missions.empty() ? 0.0 : virtMs / missions.size());
+    printTimingSummary(opt);
+    printTelemetrySummary(opt);
+    printf("loop latency   : avg %.1f us, p50 %llu us, p99 %llu us, max %llu us\n",
+           total.mean(), (unsigned long long)total.percentile(0.50),
+           (unsigned long long)total.percentile(0.99), (unsigned long long)total.max());
+    printf("wall time      : %.3f s (%.0f missions/s)\n",
+           wallS, wallS > 0 ? missions.size() / wallS : 0.0);
+    return ok ? 0 : 1;
+  }
+  if (!opt.quiet) {
+    printf("%4s  %-16s %10s %5s %6s %8s %9s %9s %8s\n",
+           "#", "command", "virt_ms", "rot90", "starts", "loops", "loop_avg", "loop_max", "pose_err");
+  }
+  std::vector<std::pair<size_t, bridge::BoxTimes>> boxes; // box / pick_ 미션의 집기 단계별 시간
+  for (size_t i = 0; i < missions.size(); ++i) {
+    const MissionResult r = runMission(missions[i], opt, total);
+    if (!r.ok) failed++;
+    bridge::BoxTimes bt;
+    const std::string& cmd = missions[i].cmd;
+    if ((cmd == "box" || cmd.compare(0, 5, "pick_") == 0) && r.ok && bridge::lastBoxTimes(bt)) {
+      boxes.push_back({i, bt});
+    }
+    virtTotalMs += r.virtMs;
+    rotTotal += r.rot90;
+    startTotal += r.starts;
+    if (!opt.quiet) {
+      printf("%4zu  %-16s %10.1f %5u %6u %8llu %9.1f %9llu %8.3f%s\n",
+             i, missions[i].cmd.c_str(), r.virtMs, r.rot90, r.starts,
+             (unsigned long long)r.loops, r.loopMeanUs,
+             (unsigned long long)r.loopMaxUs, r.poseErr, r.ok ? "" : "  FAIL");
+    }
+  }
+  const double wallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall0).count();
+
+  if (!opt.quiet && bridge::missionLegCount() > 0) {
+    printf("\n%4s  %-6s %10s %10s %8s\n", "leg", "cell", "plan_ms", "actual_ms", "err");
+    for (int k = 0; k < bridge::missionLegCount(); ++k) {
+      int x, y;
+      unsigned plannedMs, actualMs;
+      const bool ok = bridge::missionLeg(k, x, y, plannedMs, actualMs);
+      printf("%4d  (%d,%d)  %10u %10u %+7.1f%%%s\n", k + 1, x, y, plannedMs, actualMs,
+             plannedMs ? 100.0 * ((double)actualMs - plannedMs) / plannedMs : 0.0, ok ? "" : "  FAIL");
+    }
+  }
+
+  double boxCycle = 0, boxPhases = 0;
+  if (!opt.quiet && !boxes.empty()) {
+    printf("\n%4s  %8s %8s %8s %8s %8s %9s %9s\n",
+           "#", "orient", "forward", "raise", "backward", "lower", "phase_sum", "cycle_ms");
+  }
+  for (const auto& b : boxes) {
+    const bridge::BoxTimes& t = b.second;
+    const unsigned sum = t.orientMs + t.forwardMs + t.raiseMs + t.backwardMs + t.lowerMs;
+    boxCycle += t.cycleMs;
+    boxPhases += sum;
+    if (!opt.quiet) {
+      printf("%4zu  %8u %8u %8u %8u %8u %9u %9u\n", b.first, t.orientMs, t.forwardMs, t.raiseMs,
+             t.backwardMs, t.lowerMs, sum, t.cycleMs);
+    }
+  }
+
+  if (!opt.quiet) {
+    printf("\ntask         runs  overrun  skipped deferred  maxLate(us)  run p50/p99/max (us)\n");
+    for (int k = 0; k < bridge::schedulerTaskCount(); ++k) {
+      bridge::TaskStats t;
+      if (!bridge::schedulerTask(k, t)) continue;
+      printf("%-8s %9u %8u %8u %8u %12u  %6u/%u/%u\n", t.name, t.runs, t.overruns, t.skipped, t.deferred,
+             t.maxLateUs, t.runP50Us, t.runP99Us, t.runMaxUs);
+    }
+  }
+
+  printf("\nmissions       : %zu (failed %d)\n", missions.size(), failed);
+  printf("virtual time   : %.1f s (avg %.1f ms/mission)\n",
+         virtTotalMs / 1000.0, missions.empty() ? 0.0 : virtTotalMs / missions.size());
+  printf("rotations (90) : %u\n", rotTotal);
+  if (!boxes.empty()) {
+    printf("box cycles     : %zu %s, avg %.0f ms (phases sum %.0f ms, %.1f%% overlapped)\n",
+           boxes.size(), opt.boxPipelined ? "pipelined" : "sequential", boxCycle / boxes.size(),
+           boxPhases / boxes.size(), boxPhases > 0 ? 100.0 * (boxPhases - boxCycle) / boxPhases : 0.0);
+  }
+  printf("motor starts   : %u\n", startTotal);
+  printf("odometry       : %s, %u timeouts\n", opt.noEncoders ? "time (no encoders)" : "encoders",
+         bridge::odometryTimeouts());
+  printTimingSummary(opt);
+  printTelemetrySummary(opt);
+  printf("loop latency   : avg %.1f us, p50 %llu us, p99 %llu us, max %llu us\n",
+         total.mean(), (unsigned long long)total.percentile(0.50),
+         (unsigned long long)total.percentile(0.99), (unsigned long long)total.max());
+  if (opt.stream) {
+    printf("stream         : %llu status frames, %llu replies\n",
+           (unsigned long long)g_stream.statusFrames, (unsigned long long)g_stream.replies);
+    printf("cmd -> reply   : p50 %llu us, max %llu us\n",
+           (unsigned long long)g_stream.replyLat.percentile(0.50), (unsigned long long)g_stream.replyLat.max());
+    printf("cmd -> status  : p50 %llu us, max %llu us\n",
+           (unsigned long long)g_stream.feedbackLat.percentile(0.50), (unsigned long long)g_stream.feedbackLat.max());
+  }
+  printf("wall time      : %.3f s (%.0f missions/s)\n",
+         wallS, wallS > 0 ? missions.size() / wallS : 0.0);
+  return failed ? 1 : 0;
+}
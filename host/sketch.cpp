@@ -0,0 +1,206 @@
+// host/sketch.cpp
+// SCVRobot.ino 를 호스트에서 일반 C++ 번역 단위로 컴파일한다.
+// Arduino IDE 가 자동 생성하는 함수 원형을 여기서 대신 선언한다.
+#include <Arduino.h>
+#include "../PathRunner.h"
+#include "../JobQueue.h"
+#include "../HttpParser.h"
+#include "../UdpTeleop.h"
+#include "../astarTimed.h"
+
+// 스케치 안에서 정의하는 타입 (원형에 쓰기 위한 전방 선언)
+enum class StopAction : uint8_t;
+struct MissionLeg;
+
+void taskMover();
+void taskLift();
+void taskRunner();
+void taskBox();
+void taskCalib();
+void registerTasks();
+void reportOverruns();
+void trackPosition();
+void printStats(Print& out);
+void resetStats();
+void logCommand(uint8_t source, const char* cmd);
+void sendLog(Print& out);
+bool parseWebCell(const char*& p, int& gridX, int& gridY);
+bool parseWebTarget(const char* params, int& gridX, int& gridY);
+void serviceHttp();
+void serviceStatusStream();
+UdpTeleop::Ack runTeleop(const UdpTeleop::Command& cmd);
+void serviceTeleop();
+void stopAll();
+bool setCell(int x, int y, bool blocked);
+uint8_t headingAfter(const PathRunner::Node* nodes, uint16_t n, uint8_t startHeading);
+bool sharingFloor();
+uint16_t planMove(int fromX, int fromY, uint8_t heading, int targetX, int targetY,
+                  PathRunner::Node* out);
+void startPath(const PathRunner::Node* nodes, uint16_t n, int targetX, int targetY);
+bool moveToGridPosition(int targetX, int targetY);
+uint32_t approachMs(int x, int y, uint8_t heading, int bx, int by, uint8_t& side);
+bool startPick(const JobQueue::Job& job);
+bool startJob(const JobQueue::Job& job);
+bool jobFinished(const JobQueue::Job& job, bool& ok);
+void predictedEnd(const JobQueue::Job& job, int& x, int& y, uint8_t& heading);
+void reportCalibration();
+void reportBoxTimings();
+void preplanNext(const JobQueue::Job& current);
+void serviceJobs();
+MoveCosts moveCosts();
+uint32_t travelMs(int x, int y, uint8_t heading, int tx, int ty, uint8_t& endHeading);
+uint32_t stopActionMs(StopAction action);
+uint32_t legTravelMs(const MissionLeg& stop, int& x, int& y, uint8_t& heading);
+bool planMission(const MissionLeg* stops, uint8_t n);
+void reportMission();
+void serviceMission();
+
+#include "../SCVRobot.ino"
+
+#include "sketch_bridge.h"
+
+namespace bridge {
+
+bool robotIdle() {
+  return jobs.pending() == 0 && runner.isFinished() && mover.isIdle() && !boxGetter.isBusy() && !calib.isBusy() &&
+         robotLift.getState() == Lift::LiftState::IDLE;
+}
+
+bool cellBlocked(int x, int y) { return gridMap.blocked(x, y); }
+
+void plannerCosts(unsigned& fwdMs, unsigned& bwdMs, unsigned& rotMs, unsigned& dwellMs, bool& allowReverse) {
+  const MoveCosts c = ::moveCosts();
+  fwdMs = c.forwardMs;
+  bwdMs = c.backwardMs;
+  rotMs = c.rotateMs;
+  dwellMs = c.dwellMs;
+  allowReverse = c.allowReverse;
+}
+int  gridWidth()  { return 5; }
+int  gridHeight() { return 5; }
+
+bool jobQueueFull() { return jobs.full(); }
+unsigned jobsFailed() { return jobs.failedCount(); }
+
+void teleopStats(unsigned& duplicate, unsigned& stale, unsigned& malformed, unsigned& timeouts) {
+  const UdpTeleop::Stats& st = teleop.stats();
+  duplicate = st.duplicate;
+  stale = st.stale;
+  malformed = st.malformed;
+  timeouts = st.timeouts;
+}
+
+void setBoxPipelined(bool on) {
+  BoxGetter::Config c = boxGetter.config();
+  c.pipelined = on;
+  boxGetter.setConfig(c);
+}
+
+bool lastBoxTimes(BoxTimes& out) {
+  const BoxGetter::Timings& t = boxGetter.lastTimings();
+  out = BoxTimes{t.orientMs, t.forwardMs, t.raiseMs, t.backwardMs, t.lowerMs, t.cycleMs};
+  return t.cycleMs > 0;
+}
+
+void setDriveProfile(unsigned accelPerS, unsigned decelPerS, unsigned cruisePct) {
+  mover.setProfile(gridMove::Profile{(uint16_t)accelPerS, (uint16_t)decelPerS, (uint8_t)cruisePct});
+}
+
+void driveProfile(unsigned& accelPerS, unsigned& decelPerS, unsigned& cruisePct) {
+  const gridMove::Profile& p = mover.profile();
+  accelPerS = p.accelPerS;
+  decelPerS = p.decelPerS;
+  cruisePct = p.cruisePct;
+}
+
+bool benchDrive(int dx, int dy, int cells, bool reverse) {
+  if (!mover.queueDrive(dx, dy, (uint8_t)cells, reverse, 0)) return false;
+  mover.update();
+  return true;
+}
+
+bool benchRotateTo(int dx, int dy) {
+  const gridMove::Direction d = dx > 0 ? gridMove::Direction::RIGHT : dx < 0 ? gridMove::Direction::LEFT
+                              : dy > 0 ? gridMove::Direction::UP : gridMove::Direction::DOWN;
+  if (!mover.queueRotateTo(d)) return false;
+  mover.update();
+  return true;
+}
+
+void benchAbort() { mover.abort(); }
+
+bool moverIdle() { return mover.isIdle(); }
+
+static gridMove::Odometry g_installedOdometry = ODOMETRY;
+
+bool installOdometry(unsigned ticksPerCell, unsigned ticksPer90) {
+  if (!calib.setTicks((uint16_t)ticksPerCell, (uint16_t)ticksPer90)) return false;
+  g_installedOdometry = mover.odometry();
+  return true;
+}
+
+void setOdometryEnabled(bool on) {
+  mover.setOdometry(on ? g_installedOdometry : gridMove::Odometry{0, 0, 0, ODOMETRY.timeoutPct});
+}
+
+unsigned odometryTimeouts() { return mover.odometryTimeouts(); }
+
+unsigned schedulerTicks() { return sched.ticks(); }
+int schedulerTaskCount() { return sched.count(); }
+
+bool schedulerTask(int k, TaskStats& out) {
+  if (k < 0 || k >= sched.count()) return false;
+  const Scheduler::Task& t = sched.task((uint8_t)k);
+  out = TaskStats{t.name, t.runs, t.overruns, t.skipped, t.deferred, t.maxLateUs,
+                  t.runUs.percentile(50), t.runUs.percentile(99), t.runUs.max()};
+  return true;
+}
+
+void timingStats(TimingStats& out) {
+  const Histogram& end = mover.endLateMs();
+  const Histogram& step = robotLift.stepLateUs();
+  out = TimingStats{mover.lateActions(), end.percentile(99), end.max(),
+                    step.percentile(99), step.max(), robotLift.echoTimeouts()};
+}
+
+void setTelemetryMirror(bool on) { telemetry.setMirror(on ? &Serial : nullptr); }
+
+static MotionParams toBridge(const MotionCalib::Params& p) {
+  return MotionParams{p.forwardMs, p.backwardMs, p.rotateMs, p.forwardLeft, p.forwardRight,
+                      p.backwardLeft, p.backwardRight, p.rotateLeft, p.rotateRight,
+                      p.ticksPerCell, p.ticksPer90};
+}
+
+void motionParams(MotionParams& out) { out = toBridge(MotionCalib::capture(mover)); }
+
+bool storedMotionParams(MotionParams& out) {
+  MotionCalib::Params p;
+  if (!MotionCalib::readStored(p)) return false;
+  out = toBridge(p);
+  return true;
+}
+
+bool reloadMotionParams() {
+  MotionCalib::apply(mover, MotionCalib::capture(gridMove())); // 부팅 직후 기본값
+  mover.setOdometry(ODOMETRY);
+  return calib.load();
+}
+
+int missionLegCount() { return mission.n; }
+
+bool missionLeg(int k, int& x, int& y, unsigned& plannedMs, unsigned& actualMs) {
+  if (k < 0 || k >= mission.n) return false;
+  const MissionLeg& leg = missionLegs[k];
+  x = leg.x;
+  y = leg.y;
+  plannedMs = leg.plannedMs;
+  actualMs = leg.actualMs;
+  return leg.ok;
+}
+
+void position(int& x, int& y) {
+  x = currentX;
+  y = currentY;
+}
+
+} // namespace bridge
@@ -0,0 +1,71 @@
+// host/sketch_bridge.h
+// 시뮬레이터가 스케치 전역 상태를 조회하기 위한 얇은 연결부.
+// (스케치 전역은 sketch.cpp 번역 단위 안에서만 접근 가능)
+#ifndef HOST_SKETCH_BRIDGE_H
+#define HOST_SKETCH_BRIDGE_H
+
+void setup();
+void loop();
+
+namespace bridge {
+
+bool robotIdle();             // 작업 큐가 비었고 경로/박스/리프트 모두 정지 상태
+bool jobQueueFull();
+unsigned jobsFailed();        // 실패(취소 포함)한 작업 수
+bool cellBlocked(int x, int y);
+int  gridWidth();
+int  gridHeight();
+void position(int& x, int& y);
+// 마지막 mission_ 의 구간 (방문 순서). 구간이 성공했으면 true.
+int  missionLegCount();
+bool missionLeg(int k, int& x, int& y, unsigned& plannedMs, unsigned& actualMs);
+// 마지막으로 끝난 상자 집기의 단계별 시간 [ms] (아직 없으면 false)
+struct BoxTimes { unsigned orientMs, forwardMs, raiseMs, backwardMs, lowerMs, cycleMs; };
+bool lastBoxTimes(BoxTimes& out);
+void setBoxPipelined(bool on); // true: 단계를 겹쳐서 (비교용, 기본은 하나씩)
+// 구동 벤치: 가감속 프로파일을 바꾸고 gridMove 에 직접 동작을 넣는다 (경로/작업 큐 우회)
+void setDriveProfile(unsigned accelPerS, unsigned decelPerS, unsigned cruisePct);
+void driveProfile(unsigned& accelPerS, unsigned& decelPerS, unsigned& cruisePct);
+bool benchDrive(int dx, int dy, int cells, bool reverse);
+bool benchRotateTo(int dx, int dy);  // (dx, dy) 방향을 보도록 최소 회전
+void benchAbort();                   // 비상 정지처럼 진행 중인 동작을 버린다 (gridMove::abort)
+bool moverIdle();
+// calticks_ 명령처럼 잰 틱 수를 넣고 EEPROM 에 저장한다 (부팅 기본은 엔코더 종료 꺼짐)
+bool installOdometry(unsigned ticksPerCell, unsigned ticksPer90);
+// false: 엔코더를 무시하고 시간으로 동작을 끝낸다 (비교용). true 면 installOdometry 로 넣은 틱 수.
+void setOdometryEnabled(bool on);
+unsigned odometryTimeouts();  // 목표 틱에 못 닿고 시간 안전장치로 끝난 동작 수
+// gridMove 시간/PWM/엔코더 설정 (MotionCalib::Params 와 같은 값)
+struct MotionParams {
+  unsigned fwdMs, bwdMs, rotMs;
+  int fwdL, fwdR, bwdL, bwdR, rotL, rotR;
+  unsigned ticksPerCell, ticksPer90;
+};
+void motionParams(MotionParams& out);
+bool storedMotionParams(MotionParams& out); // EEPROM 기록 (없거나 깨졌으면 false)
+// 재부팅 흉내: 기본값으로 되돌린 뒤 setup() 처럼 EEPROM 에서 불러온다
+bool reloadMotionParams();
+// 작업 스케줄러: tick 수와 작업별 통계 (k 는 실행 순서)
+unsigned schedulerTicks();
+int  schedulerTaskCount();
+struct TaskStats {
+  const char* name;
+  unsigned runs, overruns, skipped, deferred, maxLateUs;
+  unsigned runP50Us, runP99Us, runMaxUs;
+};
+bool schedulerTask(int k, TaskStats& out);
+// gridMove 동작 종료 지연과 리프트 스텝/초음파 통계 (/stats 와 같은 값)
+struct TimingStats {
+  unsigned lateActions, endLateP99Ms, endLateMaxMs;
+  unsigned stepLateP99Us, stepLateMaxUs, echoTimeouts;
+};
+void timingStats(TimingStats& out);
+// 플래너가 쓰는 동작 시간 (gridMove 설정 + PathRunner dwell, SCVRobot.ino 의 moveCosts())
+void plannerCosts(unsigned& fwdMs, unsigned& bwdMs, unsigned& rotMs, unsigned& dwellMs, bool& allowReverse);
+void setTelemetryMirror(bool on); // 이벤트 기록을 Serial 에도 글로 (TELEMETRY_TO_SERIAL 와 같음)
+// UDP 원격 조종에서 버린 패킷 수와 heartbeat 끊김 횟수
+void teleopStats(unsigned& duplicate, unsigned& stale, unsigned& malformed, unsigned& timeouts);
+
+} // namespace bridge
+
+#endif // HOST_SKETCH_BRIDGE_H
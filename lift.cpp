@@ -10,14 +10,37 @@ static constexpr int PIN_TRIG  = 8;
 static constexpr int PIN_ECHO  = 9;
 
 // ----- 타이밍 파라미터 -----
-static constexpr unsigned STEP_HIGH_US      = 500;
-static constexpr unsigned STEP_LOW_US       = 500;
+static constexpr unsigned STEP_MIN_HIGH_US  = 2;   // 드라이버 최소 STEP 펄스 폭
 static constexpr unsigned DIR_SETUP_US      = 2;
 static constexpr unsigned ULTRASONIC_TOUT_US= 30000;
+static constexpr unsigned TRIG_PULSE_US     = 10;
+static constexpr unsigned SAMPLE_PERIOD_MS  = 25;  // 초음파 측정 주기
+
+// ----- 높이 한계 (정수 mm 로 비교) -----
+static constexpr int16_t LIFT_MIN_HEIGHT_MM = 10;
+static constexpr int16_t LIFT_MAX_HEIGHT_MM = 40;
 
 // ----- 전역 상수 정의 -----
-const float LIFT_MIN_HEIGHT_CM = 1.0f;
-const float LIFT_MAX_HEIGHT_CM = 4.0f;
+const float LIFT_MIN_HEIGHT_CM = LIFT_MIN_HEIGHT_MM / 10.0f;
+const float LIFT_MAX_HEIGHT_CM = LIFT_MAX_HEIGHT_MM / 10.0f;
+
+// ----- ECHO 에지 캡처 -----
+// 상승 에지에서 시각을 찍고 하강 에지에서 펄스 폭을 확정한다.
+// 보드에 리프트는 하나뿐이므로 파일 범위 상태로 둔다.
+static volatile uint32_t s_echoRiseUs  = 0;
+static volatile uint32_t s_echoWidthUs = 0;
+static volatile bool     s_echoDone    = false;
+static int               s_echoLevel   = LOW;  // 폴링 모드용 직전 레벨
+
+static void onEchoEdge() {
+    const uint32_t now = micros();
+    if (digitalRead(PIN_ECHO) == HIGH) {
+        s_echoRiseUs = now;
+    } else {
+        s_echoWidthUs = now - s_echoRiseUs;
+        s_echoDone = true;
+    }
+}
 
 // ----- 생성자 -----
 Lift::Lift() : height_cm(0.0f) {}
@@ -36,7 +59,13 @@ void Lift::begin() {
     digitalWrite(PIN_EN, HIGH);
     digitalWrite(PIN_RELAY, LOW);
 
-    updateHeight(); // 시작 시 높이 갱신
+    // ECHO 핀이 외부 인터럽트를 지원하지 않으면 update() 에서 폴링한다
+    const int irq = digitalPinToInterrupt(PIN_ECHO);
+    _echoIrq = (irq != NOT_AN_INTERRUPT);
+    if (_echoIrq) attachInterrupt(irq, onEchoEdge, CHANGE);
+    s_echoLevel = digitalRead(PIN_ECHO);
+
+    _nextSampleMs = millis(); // 첫 측정은 바로 시작
 }
 
 // ----- 릴레이/EN 제어 -----
@@ -52,72 +81,181 @@ void Lift::setPower(bool on) {
     _powerOn = on;
 }
 
-// ----- 초음파 센서 읽기 -----
-long Lift::readUltrasonicCM() {
-    digitalWrite(PIN_TRIG, LOW);
-    delayMicroseconds(2);
+// ----- 초음파 샘플러 -----
+// SAMPLE_PERIOD_MS 마다 TRIG 펄스를 내고, ECHO 폭은 ISR 이 잰다.
+// update() 는 완료된 측정만 거둬 가므로 에코가 없어도 블로킹되지 않는다.
+void Lift::serviceUltrasonic() {
+    const uint32_t nowUs = micros();
+
+    // TRIG 펄스 하강 → 측정 시작
+    if (_trigHigh) {
+        if (nowUs - _trigUs < TRIG_PULSE_US) return;
+        digitalWrite(PIN_TRIG, LOW);
+        _trigHigh = false;
+        _trigUs = nowUs;
+        return;
+    }
+
+    if (!_echoIrq) {
+        const int level = digitalRead(PIN_ECHO);
+        if (level != s_echoLevel) {
+            s_echoLevel = level;
+            onEchoEdge();
+        }
+    }
+
+    if (_samplePending) {
+        noInterrupts();
+        const bool done = s_echoDone;
+        const uint32_t width = s_echoWidthUs;
+        s_echoDone = false;
+        interrupts();
+
+        if (done) {
+            _samplePending = false;
+            pushSample(width);
+        } else if (nowUs - _trigUs > ULTRASONIC_TOUT_US) {
+            _samplePending = false; // 에코 없음: 이번 샘플은 버린다
+            _echoTimeouts++;
+        } else {
+            return;
+        }
+    }
+
+    const unsigned long nowMs = millis();
+    if ((long)(nowMs - _nextSampleMs) < 0) return;
+    _nextSampleMs += SAMPLE_PERIOD_MS;
+    if ((long)(nowMs - _nextSampleMs) >= 0) _nextSampleMs = nowMs + SAMPLE_PERIOD_MS;
+
+    s_echoDone = false;
     digitalWrite(PIN_TRIG, HIGH);
-    delayMicroseconds(10);
-    digitalWrite(PIN_TRIG, LOW);
-    unsigned long duration = pulseIn(PIN_ECHO, HIGH, ULTRASONIC_TOUT_US);
-    return static_cast<long>(duration * 0.034f / 2.0f);
+    _trigHigh = true;
+    _trigUs = nowUs;
+    _samplePending = true;
 }
 
-// ----- private 멤버 함수 -----
-void Lift::updateHeight() {
-    height_cm = static_cast<float>(readUltrasonicCM());
+// 왕복 시간[us] → 거리[mm] = us * 0.17 (음속 0.34 mm/us 의 절반)
+void Lift::pushSample(uint32_t echoUs) {
+    const uint32_t mm = (echoUs * 17UL) / 100UL;
+    _window[_windowPos] = (uint16_t)(mm > 0xFFFF ? 0xFFFF : mm);
+    _windowPos = (uint8_t)((_windowPos + 1) % HEIGHT_WINDOW);
+    if (_windowLen < HEIGHT_WINDOW) _windowLen++;
+
+    // 메디안: 창이 작으므로 삽입 정렬
+    uint16_t sorted[HEIGHT_WINDOW];
+    for (uint8_t i = 0; i < _windowLen; ++i) {
+        uint16_t v = _window[i];
+        uint8_t j = i;
+        while (j > 0 && sorted[j - 1] > v) { sorted[j] = sorted[j - 1]; --j; }
+        sorted[j] = v;
+    }
+    _heightMm = (int16_t)sorted[_windowLen / 2];
+    height_cm = _heightMm / 10.0f;
 }
 
-// ----- 한 스텝 펄스 -----
-void Lift::stepPulse(bool dir) {
-    digitalWrite(PIN_DIR, dir ? HIGH : LOW);
-    delayMicroseconds(DIR_SETUP_US);
+int16_t Lift::heightMm() const { return _heightMm; }
+bool Lift::heightValid() const { return _windowLen > 0; }
+
+const Histogram& Lift::stepLateUs() const { return _stepLateUs; }
+uint16_t Lift::echoTimeouts() const { return _echoTimeouts; }
+
+void Lift::resetTiming() {
+    _stepLateUs.reset();
+    _echoTimeouts = 0;
+}
+
+// ----- 스텝 발생기 -----
+// update() 에서 호출된다. STEP 상승/하강을 micros() 시각으로 예약하므로
+// 대기(delayMicroseconds) 없이 동작하고, 속도는 loop 주기와 무관하게
+// 설정된 steps/s 를 따른다 (loop 가 스텝 주기보다 느리면 그 주기로 제한).
+void Lift::serviceStepper() {
+    const uint32_t now = micros();
+
+    // 펄스 하강: 최소 폭이 지났으면 내린다
+    if (_stepHigh) {
+        if (now - _stepHighUs < STEP_MIN_HIGH_US) return;
+        digitalWrite(PIN_STEP, LOW);
+        _stepHigh = false;
+    }
+
+    if ((int32_t)(now - _nextStepUs) < 0) return;
+    _stepLateUs.record(now - _nextStepUs);
+
     digitalWrite(PIN_STEP, HIGH);
-    delayMicroseconds(STEP_HIGH_US);
-    digitalWrite(PIN_STEP, LOW);
-    delayMicroseconds(STEP_LOW_US);
+    _stepHigh = true;
+    _stepHighUs = now;
+
+    // 가감속: 남은 시간 안에 출발 속도까지 줄일 수 있도록 감속 구간을 잡는다
+    const uint32_t interval = 1000000UL / _rateSps;
+    if (_accelSps2 == 0) {
+        _rateSps = _maxSps;
+    } else {
+        const uint32_t dv = ((uint32_t)_accelSps2 * interval) / 1000000UL + 1;
+        const int32_t remainMs = (int32_t)(_actionEndMs - millis());
+        const uint32_t decelMs = (_rateSps > _startSps) ? ((_rateSps - _startSps) * 1000UL) / _accelSps2 : 0;
+        if (remainMs <= (int32_t)decelMs) {
+            _rateSps = (_rateSps > _startSps + dv) ? _rateSps - dv : _startSps;
+        } else {
+            _rateSps = (_rateSps + dv < _maxSps) ? _rateSps + dv : _maxSps;
+        }
+    }
+
+    // 한 주기 이상 밀렸으면 밀린 스텝을 몰아서 내지 않고 현재 시각 기준으로 재예약
+    _nextStepUs += interval;
+    if ((int32_t)(now - _nextStepUs) >= 0) _nextStepUs = now + interval;
 }
 
-// ----- 비블로킹 시간 제어 함수 -----
-void Lift::upFor(unsigned long ms) {
+void Lift::startMotion(bool dir, unsigned long ms) {
     setPower(true);
-    _state = LiftState::MOVING_UP;
+    digitalWrite(PIN_DIR, dir ? HIGH : LOW);
+    _state = dir ? LiftState::MOVING_UP : LiftState::MOVING_DOWN;
     _actionEndMs = millis() + ms;
+    _rateSps = (_accelSps2 == 0) ? _maxSps : _startSps;
+    _nextStepUs = micros() + DIR_SETUP_US;
+}
+
+void Lift::setStepRate(uint16_t maxSps)     { _maxSps = maxSps ? maxSps : 1; if (_startSps > _maxSps) _startSps = _maxSps; }
+void Lift::setStartRate(uint16_t startSps)  { _startSps = startSps ? startSps : 1; if (_startSps > _maxSps) _startSps = _maxSps; }
+void Lift::setAcceleration(uint16_t sps2)   { _accelSps2 = sps2; }
+
+// ----- 비블로킹 시간 제어 함수 -----
+void Lift::upFor(unsigned long ms) {
+    startMotion(true, ms);
 }
 
 void Lift::downFor(unsigned long ms) {
-    setPower(true);
-    _state = LiftState::MOVING_DOWN;
-    _actionEndMs = millis() + ms;
+    startMotion(false, ms);
 }
 
 // ----- 정지 함수 -----
 void Lift::stop() {
+    if (_stepHigh) {
+        digitalWrite(PIN_STEP, LOW);
+        _stepHigh = false;
+    }
     setPower(false);
     _state = LiftState::IDLE;
 }
 
 // ----- 비블로킹 update 함수 -----
 void Lift::update() {
+    serviceUltrasonic(); // 정지 중에도 높이는 계속 갱신
+
     if (_state == LiftState::IDLE) {
         return;
     }
 
-    updateHeight(); // 내부에서 private 함수 호출
     bool timeIsUp = (millis() >= _actionEndMs);
-    bool limitReached = (_state == LiftState::MOVING_UP   && height_cm >= LIFT_MAX_HEIGHT_CM) ||
-                        (_state == LiftState::MOVING_DOWN && height_cm <= LIFT_MIN_HEIGHT_CM);
+    bool limitReached = heightValid() &&
+                        ((_state == LiftState::MOVING_UP   && _heightMm >= LIFT_MAX_HEIGHT_MM) ||
+                         (_state == LiftState::MOVING_DOWN && _heightMm <= LIFT_MIN_HEIGHT_MM));
 
     if (timeIsUp || limitReached) {
         stop();
         return;
     }
 
-    if (_state == LiftState::MOVING_UP) {
-        stepPulse(true);
-    } else if (_state == LiftState::MOVING_DOWN) {
-        stepPulse(false);
-    }
+    serviceStepper();
 }
 
 Lift::LiftState Lift::getState() const {
@@ -3,6 +3,7 @@
 #define LIFT_H
 
 #include <Arduino.h>
+#include "Histogram.h"
 
 // 전역 상수 선언
 extern const float LIFT_MIN_HEIGHT_CM;
@@ -22,16 +23,56 @@ public:
     void downFor(unsigned long ms);
     LiftState getState() const;
 
+    // 스텝 발생기 설정 (단위: steps/s, steps/s^2)
+    void setStepRate(uint16_t maxSps);      // 순항 속도
+    void setStartRate(uint16_t startSps);   // 출발/정지 속도
+    void setAcceleration(uint16_t sps2);    // 가감속 (0 이면 램프 없이 바로 순항 속도)
+
+    // 초음파 높이: 고정 주기로 측정한 값의 메디안 (측정 전이면 heightValid()=false)
+    int16_t heightMm() const;
+    bool heightValid() const;
+
+    // 타이밍 통계: STEP 상승이 예약 시각보다 늦은 정도 [us] (loop 가 늦으면 스텝 간격이 흔들린다)와
+    // 에코 없이 버린 초음파 샘플 수
+    const Histogram& stepLateUs() const;
+    uint16_t echoTimeouts() const;
+    void resetTiming();
+
 private:
     // 클래스 내부에서만 사용할 상태 변수와 함수들
     LiftState _state = LiftState::IDLE;
     unsigned long _actionEndMs = 0;
     bool _powerOn = false;
 
+    // micros() 기반 스텝 발생기 상태
+    uint16_t _maxSps = 1000;
+    uint16_t _startSps = 250;
+    uint16_t _accelSps2 = 5000;
+    uint32_t _rateSps = 0;        // 현재 스텝 속도
+    uint32_t _nextStepUs = 0;     // 다음 STEP 상승 시각
+    uint32_t _stepHighUs = 0;     // STEP 을 HIGH 로 올린 시각
+    bool _stepHigh = false;
+
+    // 초음파 샘플러 상태 (ECHO 에지 시각은 ISR 이 기록)
+    static constexpr uint8_t HEIGHT_WINDOW = 5;
+    uint16_t _window[HEIGHT_WINDOW] = {};
+    uint8_t _windowLen = 0;
+    uint8_t _windowPos = 0;
+    int16_t _heightMm = 0;
+    unsigned long _nextSampleMs = 0;
+    uint32_t _trigUs = 0;
+    bool _trigHigh = false;
+    bool _samplePending = false;
+    bool _echoIrq = false;       // false 면 ECHO 를 update() 에서 폴링
+
+    Histogram _stepLateUs;
+    uint16_t _echoTimeouts = 0;
+
     void setPower(bool on);
-    long readUltrasonicCM();
-    void stepPulse(bool dir);
-    void updateHeight(); // 높이 측정 함수 선언 추가
+    void startMotion(bool dir, unsigned long ms);
+    void serviceStepper();
+    void serviceUltrasonic();
+    void pushSample(uint32_t echoUs);
 };
 
 #endif // LIFT_H
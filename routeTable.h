@@ -0,0 +1,98 @@
+#pragma once
+#include "astarGrid.h"
+
+// 전 쌍(all-pairs) 다음 칸(next-hop) 테이블
+// 지도가 바뀔 때만 build() 로 다시 만들고, 그 사이의 경로 질의는 탐색 없이
+// 경로 길이에 비례하는 시간으로 답한다.
+// - 저장: (목표, 출발) 쌍마다 4비트 → N*N/2 바이트 (5x5: 313바이트, 16x16: 32KB)
+// - 각 목표 칸에서 BFS 한 번씩 (한 칸 비용=1 이므로 최단 칸 수 경로)
+template <int W, int H>
+class RouteTable {
+public:
+  static constexpr uint32_t N = (uint32_t)W * H;
+  static_assert(N < 0xFFFF, "grid too large for 16-bit node indices");
+
+  RouteTable() { invalidate(); }
+
+  void invalidate() { valid_ = false; }
+  bool valid() const { return valid_; }
+
+  void build(const OccupancyGrid<W, H>& grid) {
+    using namespace astar_detail;
+    for (auto& b : hop_) b = 0xFF; // 전부 UNREACHABLE
+
+    for (uint16_t dst = 0; dst < N; ++dst) {
+      const int dx0 = dst % W, dy0 = dst / W;
+      if (grid.blocked(dx0, dy0)) continue;
+
+      // dst 에서 BFS: 처음 도달한 이웃 u 쪽이 v 에서 dst 로 가는 다음 칸
+      uint16_t head = 0, tail = 0;
+      queue_[tail++] = dst;
+      setHop(dst, dst, SELF);
+      while (head < tail) {
+        const uint16_t u = queue_[head++];
+        const int ux = u % W, uy = u / W;
+        for (uint8_t d = 0; d < 4; ++d) {
+          const int vx = ux + DX[d], vy = uy + DY[d];
+          if (!grid.inBounds(vx, vy) || grid.blocked(vx, vy)) continue;
+          const uint16_t v = (uint16_t)(vy * W + vx);
+          if (hop(dst, v) != UNREACHABLE) continue;
+          setHop(dst, v, (uint8_t)(d ^ 1)); // v → u 는 u → v 의 반대 방향
+          queue_[tail++] = v;
+        }
+      }
+    }
+    valid_ = true;
+  }
+
+  bool reachable(int sx, int sy, int gx, int gy) const {
+    if (!valid_ || !OccupancyGrid<W, H>::inBounds(sx, sy) || !OccupancyGrid<W, H>::inBounds(gx, gy)) return false;
+    return hop((uint16_t)(gy * W + gx), (uint16_t)(sy * W + sx)) != UNREACHABLE;
+  }
+
+  // planAstar 와 같은 출력 규약: out[0]=(sx,sy) ... out[n-1]=(gx,gy)
+  template <typename NodeT>
+  AStarResult path(int sx, int sy, int gx, int gy, NodeT* out, uint16_t maxOut) const {
+    using namespace astar_detail;
+    AStarResult res{false, 0};
+    if (!reachable(sx, sy, gx, gy)) return res;
+
+    const uint16_t dst = (uint16_t)(gy * W + gx);
+    int x = sx, y = sy;
+    uint16_t n = 0;
+    while (true) {
+      if (n >= maxOut) return AStarResult{false, 0};
+      out[n] = NodeT{};
+      out[n].x = x;
+      out[n].y = y;
+      n++;
+      const uint8_t d = hop(dst, (uint16_t)(y * W + x));
+      if (d == SELF) break;
+      x += DX[d];
+      y += DY[d];
+    }
+    res.ok = true;
+    res.n = n;
+    return res;
+  }
+
+private:
+  // 방향 0..3 은 astar_detail::DX/DY 순서 (RIGHT, LEFT, UP, DOWN)
+  static constexpr uint8_t SELF        = 0xE;
+  static constexpr uint8_t UNREACHABLE = 0xF;
+
+  uint8_t hop(uint16_t dst, uint16_t src) const {
+    const uint32_t i = (uint32_t)dst * N + src;
+    return (hop_[i >> 1] >> ((i & 1) * 4)) & 0xF;
+  }
+
+  void setHop(uint16_t dst, uint16_t src, uint8_t v) {
+    const uint32_t i = (uint32_t)dst * N + src;
+    const uint8_t sh = (uint8_t)((i & 1) * 4);
+    hop_[i >> 1] = (uint8_t)((hop_[i >> 1] & ~(0xF << sh)) | (v << sh));
+  }
+
+  uint8_t  hop_[(N * N + 1) / 2];
+  uint16_t queue_[N];
+  bool     valid_;
+};
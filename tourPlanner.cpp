@@ -0,0 +1,139 @@
+// tourPlanner.cpp
+#include "tourPlanner.h"
+
+static uint32_t addCost(uint32_t a, uint32_t b) {
+  return (a == TOUR_INF || b == TOUR_INF) ? TOUR_INF : a + b;
+}
+
+uint32_t tourCost(const uint32_t* cost, uint8_t n, const uint16_t* before, const uint8_t* order) {
+  const uint8_t w = (uint8_t)(n + 1);
+  uint16_t seen = 0;
+  uint8_t  prev = 0;
+  uint32_t total = 0;
+  for (uint8_t k = 0; k < n; ++k) {
+    const uint8_t s = order[k];
+    if (before[s - 1] & ~seen) return TOUR_INF;
+    total = addCost(total, cost[prev * w + s]);
+    if (total == TOUR_INF) return TOUR_INF;
+    seen |= (uint16_t)(1u << (s - 1));
+    prev = s;
+  }
+  return total;
+}
+
+// Held-Karp: dp[mask][j] = 정류장 집합 mask 를 모두 들르고 정류장 j+1 에서 끝나는 최소 시간
+static TourResult exactTour(const uint32_t* cost, uint8_t n, const uint16_t* before, uint8_t* order) {
+  static uint32_t dp[1u << TOUR_EXACT_MAX][TOUR_EXACT_MAX];
+  static uint8_t  parent[1u << TOUR_EXACT_MAX][TOUR_EXACT_MAX];
+  const uint8_t  w = (uint8_t)(n + 1);
+  const uint16_t full = (uint16_t)((1u << n) - 1);
+
+  for (uint16_t m = 0; m <= full; ++m)
+    for (uint8_t j = 0; j < n; ++j) dp[m][j] = TOUR_INF;
+  for (uint8_t j = 0; j < n; ++j) {
+    if (before[j] == 0) dp[1u << j][j] = cost[j + 1];
+  }
+
+  for (uint16_t m = 1; m <= full; ++m) {
+    for (uint8_t j = 0; j < n; ++j) {
+      if (!(m & (1u << j)) || dp[m][j] == TOUR_INF) continue;
+      for (uint8_t k = 0; k < n; ++k) {
+        if ((m & (1u << k)) || (before[k] & ~m)) continue;
+        const uint32_t c = addCost(dp[m][j], cost[(j + 1) * w + k + 1]);
+        const uint16_t m2 = (uint16_t)(m | (1u << k));
+        if (c < dp[m2][k]) {
+          dp[m2][k] = c;
+          parent[m2][k] = j;
+        }
+      }
+    }
+  }
+
+  TourResult res{false, true, TOUR_INF};
+  uint8_t last = 0;
+  for (uint8_t j = 0; j < n; ++j) {
+    if (dp[full][j] < res.costMs) { res.costMs = dp[full][j]; last = j; }
+  }
+  if (res.costMs == TOUR_INF) return res;
+
+  uint16_t m = full;
+  for (uint8_t k = n; k-- > 0; ) {
+    order[k] = (uint8_t)(last + 1);
+    const uint8_t p = parent[m][last];
+    m = (uint16_t)(m & ~(1u << last));
+    last = p;
+  }
+  res.ok = true;
+  return res;
+}
+
+// 후보 순서가 더 짧으면 채택
+static bool tryOrder(const uint32_t* cost, uint8_t n, const uint16_t* before,
+                     const uint8_t* cand, uint8_t* order, uint32_t& best) {
+  const uint32_t c = tourCost(cost, n, before, cand);
+  if (c >= best) return false;
+  for (uint8_t k = 0; k < n; ++k) order[k] = cand[k];
+  best = c;
+  return true;
+}
+
+// 최근접 이웃으로 초기해를 만들고, 구간 뒤집기(2-opt)와 정류장 하나 옮기기(or-opt)로
+// 더 줄지 않을 때까지 고친다. 비대칭 비용이라 뒤집은 구간의 간선 방향도 바뀌므로
+// 매번 전체 합을 다시 잰다 (n ≤ 10).
+static TourResult heuristicTour(const uint32_t* cost, uint8_t n, const uint16_t* before, uint8_t* order) {
+  const uint8_t w = (uint8_t)(n + 1);
+  TourResult res{false, false, TOUR_INF};
+
+  uint16_t seen = 0;
+  uint8_t  prev = 0;
+  for (uint8_t k = 0; k < n; ++k) {
+    uint8_t  best = 0;
+    uint32_t bestCost = TOUR_INF;
+    for (uint8_t s = 1; s <= n; ++s) {
+      const uint16_t bit = (uint16_t)(1u << (s - 1));
+      if ((seen & bit) || (before[s - 1] & ~seen)) continue;
+      if (cost[prev * w + s] < bestCost) { bestCost = cost[prev * w + s]; best = s; }
+    }
+    if (best == 0) return res;
+    order[k] = best;
+    seen |= (uint16_t)(1u << (best - 1));
+    prev = best;
+  }
+
+  res.costMs = tourCost(cost, n, before, order);
+  bool improved = true;
+  for (uint8_t pass = 0; improved && pass < 2 * TOUR_MAX_STOPS; ++pass) {
+    improved = false;
+    for (uint8_t i = 0; i + 1 < n; ++i) {
+      for (uint8_t j = (uint8_t)(i + 1); j < n; ++j) {
+        uint8_t cand[TOUR_MAX_STOPS];
+        for (uint8_t k = 0; k < n; ++k) cand[k] = order[k];
+        for (uint8_t a = i, b = j; a < b; ++a, --b) {
+          const uint8_t t = cand[a]; cand[a] = cand[b]; cand[b] = t;
+        }
+        if (tryOrder(cost, n, before, cand, order, res.costMs)) improved = true;
+      }
+    }
+    for (uint8_t i = 0; i < n; ++i) {
+      for (uint8_t j = 0; j < n; ++j) {
+        if (i == j) continue;
+        // order[i] 를 빼서 j 자리에 끼운다
+        uint8_t cand[TOUR_MAX_STOPS];
+        uint8_t m = 0;
+        for (uint8_t k = 0; k < n; ++k) if (k != i) cand[m++] = order[k];
+        for (uint8_t k = (uint8_t)(n - 1); k > j; --k) cand[k] = cand[k - 1];
+        cand[j] = order[i];
+        if (tryOrder(cost, n, before, cand, order, res.costMs)) improved = true;
+      }
+    }
+  }
+  res.ok = res.costMs != TOUR_INF;
+  return res;
+}
+
+TourResult planTour(const uint32_t* cost, uint8_t n, const uint16_t* before, uint8_t* order) {
+  if (n == 0) return TourResult{true, true, 0};
+  if (n > TOUR_MAX_STOPS) return TourResult{false, false, TOUR_INF};
+  if (n <= TOUR_EXACT_MAX) return exactTour(cost, n, before, order);
+  return heuristicTour(cost, n, before, order);
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+
+// 여러 정류장 방문 순서 최적화 (출발점에서 시작해 돌아오지 않는 열린 경로)
+// - cost[i * (n + 1) + j] : 노드 i → j 이동 시간 [ms]. 노드 0 = 출발점, 1..n = 정류장.
+//   갈 수 없으면 TOUR_INF. 비대칭이어도 된다 (회전/후진 시간 때문에 보통 비대칭).
+// - before[k] : 정류장 k+1 보다 먼저 들러야 하는 정류장 비트마스크 (bit j = 정류장 j+1).
+//   예) 내려놓기(drop) 는 앞서 적은 집기(pick) 뒤에 와야 한다.
+// - n ≤ TOUR_EXACT_MAX 이면 Held-Karp DP 로 최적해, 그보다 크면 최근접 이웃 + 2-opt.
+// 성공 시 order[0..n-1] 에 방문할 정류장 번호(1..n).
+
+static constexpr uint8_t  TOUR_MAX_STOPS = 10;
+static constexpr uint8_t  TOUR_EXACT_MAX = 6; // DP 표: 2^6 x 6 x 4바이트 = 1.5KB
+static constexpr uint32_t TOUR_INF = 0xFFFFFFFFu;
+
+struct TourResult {
+  bool     ok;
+  bool     exact;  // DP 로 구한 최적해인지
+  uint32_t costMs; // 이동 시간 합
+};
+
+TourResult planTour(const uint32_t* cost, uint8_t n, const uint16_t* before, uint8_t* order);
+
+// 주어진 순서의 이동 시간 합. 갈 수 없거나 선후 조건을 어기면 TOUR_INF.
+uint32_t tourCost(const uint32_t* cost, uint8_t n, const uint16_t* before, const uint8_t* order);